@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Measures the encoding throughput of typed arrays.
+//
+// Usage: bintoken_array_benchmark [megabytes]
+//
+// Each element type is encoded with bintoken::writer::array() using a new
+// writer per message, using a reused writer, and with bintoken::oarchive from
+// std::vector. Both small vectors of the size used in the serialization tests,
+// and larger vectors are measured.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/bintoken/serialization/oarchive.hpp>
+#include <trial/protocol/bintoken/serialization/std/vector.hpp>
+
+namespace bintoken = trial::protocol::bintoken;
+
+using output_type = std::vector<std::uint8_t>;
+using clock_type = std::chrono::steady_clock;
+
+const std::size_t lengths[] = { 4, 256, 65536 };
+
+template <typename T>
+std::vector<T> make_data(std::size_t length)
+{
+    std::vector<T> result(length);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        result[i] = static_cast<T>(i * 7 + 1);
+    }
+    return result;
+}
+
+template <typename Function>
+double measure(std::size_t bytes, std::size_t iterations, Function function)
+{
+    const auto start = clock_type::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+    const std::chrono::duration<double> elapsed = clock_type::now() - start;
+    return (bytes * iterations) / elapsed.count() / (1024.0 * 1024.0);
+}
+
+template <typename T>
+void run(const std::string& name, std::size_t total)
+{
+    for (auto length : lengths)
+    {
+        const auto data = make_data<T>(length);
+        const std::size_t bytes = length * sizeof(T);
+        const std::size_t iterations = std::max<std::size_t>(1, total / bytes);
+
+        output_type output;
+        output.reserve(bytes + 16);
+
+        const double array_rate = measure(bytes, iterations, [&] {
+                output.clear();
+                bintoken::writer writer(output);
+                writer.array(data.data(), data.size());
+            });
+
+        bintoken::writer reusable(output);
+        const double reset_rate = measure(bytes, iterations, [&] {
+                output.clear();
+                reusable.reset(output);
+                reusable.array(data.data(), data.size());
+            });
+
+        const double archive_rate = measure(bytes, iterations, [&] {
+                output.clear();
+                bintoken::oarchive archive(output);
+                archive << data;
+            });
+
+        std::cout << std::left << std::setw(10) << name
+                  << std::right << std::setw(8) << length
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << array_rate
+                  << std::setw(14) << reset_rate
+                  << std::setw(14) << archive_rate
+                  << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::size_t megabytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const std::size_t total = megabytes * 1024 * 1024;
+
+    std::cout << std::left << std::setw(10) << "type"
+              << std::right << std::setw(8) << "length"
+              << std::setw(14) << "array MB/s"
+              << std::setw(14) << "reset MB/s"
+              << std::setw(14) << "oarchive MB/s"
+              << std::endl;
+
+    run<std::int8_t>("int8", total);
+    run<std::int16_t>("int16", total);
+    run<std::int32_t>("int32", total);
+    run<std::int64_t>("int64", total);
+    run<bintoken::token::float32::type>("float32", total);
+    run<bintoken::token::float64::type>("float64", total);
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Measures the decoding throughput of validating and trusted readers.
+//
+// Usage: bintoken_decode_benchmark [megabytes]
+//
+// A message with an array of records holding integers, reals, strings, and
+// small typed arrays is decoded token by token with bintoken::reader, and
+// loaded into a std::vector of structs with bintoken::iarchive. Both are
+// measured with a validating and with a trusted reader.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+#include <trial/protocol/bintoken/serialization/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/std/string.hpp>
+#include <trial/protocol/bintoken/serialization/std/vector.hpp>
+
+namespace bintoken = trial::protocol::bintoken;
+
+using output_type = std::vector<std::uint8_t>;
+using clock_type = std::chrono::steady_clock;
+
+const std::size_t lengths[] = { 16, 1024, 65536 };
+
+struct sample
+{
+    std::int32_t id;
+    std::int64_t timestamp;
+    double value;
+    bool valid;
+    std::string name;
+    std::vector<std::int16_t> readings;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & id & timestamp & value & valid & name & readings;
+    }
+};
+
+std::vector<sample> make_data(std::size_t length)
+{
+    std::vector<sample> result(length);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        auto& current = result[i];
+        current.id = static_cast<std::int32_t>(i);
+        current.timestamp = 1500000000000 + static_cast<std::int64_t>(i) * 1000;
+        current.value = i * 0.25;
+        current.valid = (i % 3 != 0);
+        current.name = "sensor-" + std::to_string(i % 100);
+        current.readings.assign(4, static_cast<std::int16_t>(i * 7));
+    }
+    return result;
+}
+
+template <typename Function>
+double measure(std::size_t bytes, std::size_t iterations, Function function)
+{
+    const auto start = clock_type::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+    const std::chrono::duration<double> elapsed = clock_type::now() - start;
+    return (bytes * iterations) / elapsed.count() / (1024.0 * 1024.0);
+}
+
+template <typename... Args>
+std::size_t walk(const output_type& input, Args... args)
+{
+    std::size_t tokens = 0;
+    bintoken::reader reader(input, args...);
+    do
+    {
+        ++tokens;
+    } while (reader.next());
+    return tokens;
+}
+
+template <typename... Args>
+std::size_t load(const output_type& input, Args... args)
+{
+    std::vector<sample> result;
+    bintoken::iarchive archive(input, args...);
+    archive >> result;
+    return result.size();
+}
+
+int main(int argc, char *argv[])
+{
+    const std::size_t megabytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const std::size_t total = megabytes * 1024 * 1024;
+
+    std::cout << std::right << std::setw(8) << "length"
+              << std::setw(16) << "reader MB/s"
+              << std::setw(16) << "trusted MB/s"
+              << std::setw(16) << "iarchive MB/s"
+              << std::setw(16) << "trusted MB/s"
+              << std::endl;
+
+    volatile std::size_t sink = 0;
+    for (auto length : lengths)
+    {
+        const auto data = make_data(length);
+        output_type input;
+        {
+            bintoken::oarchive archive(input);
+            archive << data;
+        }
+        const std::size_t bytes = input.size();
+        const std::size_t iterations = std::max<std::size_t>(1, total / bytes);
+
+        const double reader_rate = measure(bytes, iterations, [&] {
+                sink = sink + walk(input);
+            });
+
+        const double trusted_reader_rate = measure(bytes, iterations, [&] {
+                sink = sink + walk(input, bintoken::trusted);
+            });
+
+        const double archive_rate = measure(bytes, iterations, [&] {
+                sink = sink + load(input);
+            });
+
+        const double trusted_archive_rate = measure(bytes, iterations, [&] {
+                sink = sink + load(input, bintoken::trusted);
+            });
+
+        std::cout << std::right << std::setw(8) << length
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(16) << reader_rate
+                  << std::setw(16) << trusted_reader_rate
+                  << std::setw(16) << archive_rate
+                  << std::setw(16) << trusted_archive_rate
+                  << std::endl;
+    }
+
+    return 0;
+}
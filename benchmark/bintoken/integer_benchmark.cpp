@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Compares the encodings of integer arrays.
+//
+// Usage: bintoken_integer_benchmark [megabytes]
+//
+// Each data set is encoded as a typed array with fixed-size elements,
+// variable-length integers, narrowed elements, and the bit-packing policies.
+// The encoded size and the encoding and decoding throughput, measured in MB/s
+// of the original data, are reported.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+
+namespace bintoken = trial::protocol::bintoken;
+
+using output_type = std::vector<std::uint8_t>;
+using clock_type = std::chrono::steady_clock;
+
+const std::size_t length = 4096;
+
+template <typename Function>
+double measure(std::size_t bytes, std::size_t iterations, Function function)
+{
+    const auto start = clock_type::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        function();
+    }
+    const std::chrono::duration<double> elapsed = clock_type::now() - start;
+    return (bytes * iterations) / elapsed.count() / (1024.0 * 1024.0);
+}
+
+struct mode
+{
+    const char *name;
+    bool varint;
+    bool narrow;
+    bintoken::packing::value packing;
+};
+
+const mode modes[] = {
+    { "fixed", false, false, bintoken::packing::none },
+    { "varint", true, false, bintoken::packing::none },
+    { "narrow", false, true, bintoken::packing::none },
+    { "frame", false, false, bintoken::packing::frame_of_reference },
+    { "delta", false, false, bintoken::packing::delta }
+};
+
+template <typename T>
+void run(const std::string& name, const std::vector<T>& data, std::size_t total)
+{
+    const std::size_t bytes = data.size() * sizeof(T);
+    const std::size_t iterations = std::max<std::size_t>(1, total / bytes);
+
+    for (const auto& mode : modes)
+    {
+        output_type output;
+        bintoken::writer writer(output);
+        writer.varint(mode.varint);
+        writer.narrow(mode.narrow);
+        writer.packing(mode.packing);
+        const double encode_rate = measure(bytes, iterations, [&] {
+                output.clear();
+                writer.reset(output);
+                writer.array(data.data(), data.size());
+            });
+
+        std::vector<T> result(data.size());
+        const double decode_rate = measure(bytes, iterations, [&] {
+                bintoken::reader reader(output);
+                reader.array(result.data(), result.size());
+            });
+        if (result != data)
+        {
+            std::cerr << "Mismatch for " << name << std::endl;
+            std::exit(1);
+        }
+
+        std::cout << std::left << std::setw(12) << name
+                  << std::setw(8) << mode.name
+                  << std::right << std::setw(10) << output.size()
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << encode_rate
+                  << std::setw(14) << decode_rate
+                  << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::size_t megabytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const std::size_t total = megabytes * 1024 * 1024;
+
+    std::mt19937_64 generator(42);
+
+    // Counters and lengths are mostly small
+    std::vector<std::int32_t> counters(length);
+    std::geometric_distribution<std::int32_t> counter_distribution(0.01);
+    for (auto& value : counters)
+        value = counter_distribution(generator);
+
+    // Signed differences between consecutive samples
+    std::vector<std::int32_t> deltas(length);
+    std::normal_distribution<double> delta_distribution(0.0, 50.0);
+    for (auto& value : deltas)
+        value = static_cast<std::int32_t>(delta_distribution(generator));
+
+    // Millisecond timestamps
+    std::vector<std::int64_t> timestamps(length);
+    std::int64_t now = 1500000000000;
+    std::uniform_int_distribution<std::int64_t> step_distribution(0, 1000);
+    for (auto& value : timestamps)
+        value = (now += step_distribution(generator));
+
+    // Monotonic offsets into a file
+    std::vector<std::int64_t> offsets(length);
+    std::int64_t offset = 0;
+    std::uniform_int_distribution<std::int64_t> size_distribution(100, 4000);
+    for (auto& value : offsets)
+        value = (offset += size_distribution(generator));
+
+    // Random identifiers use the full range
+    std::vector<std::int64_t> identifiers(length);
+    for (auto& value : identifiers)
+        value = static_cast<std::int64_t>(generator());
+
+    std::cout << std::left << std::setw(12) << "data"
+              << std::setw(8) << "mode"
+              << std::right << std::setw(10) << "bytes"
+              << std::setw(14) << "encode MB/s"
+              << std::setw(14) << "decode MB/s"
+              << std::endl;
+
+    run("counters", counters, total);
+    run("deltas", deltas, total);
+    run("timestamps", timestamps, total);
+    run("offsets", offsets, total);
+    run("identifiers", identifiers, total);
+
+    return 0;
+}
@@ -12,7 +12,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ostream>
-#include <trial/protocol/buffer/ostream.hpp>
+#include <trial/protocol/buffer/buffered_ostream.hpp>
 #include <trial/protocol/json/serialization.hpp>
 #include <trial/dynamic/variable.hpp>
 
@@ -23,8 +23,12 @@ namespace dynamic
 
 inline std::ostream& operator<< (std::ostream& stream, const variable& value)
 {
-    protocol::json::oarchive archive(stream);
-    archive << value;
+    protocol::buffer::buffered_ostream output(stream);
+    {
+        protocol::json::oarchive archive(output);
+        archive << value;
+    }
+    output.flush();
     return stream;
 }
 
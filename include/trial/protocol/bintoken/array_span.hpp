@@ -0,0 +1,115 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_ARRAY_SPAN_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_ARRAY_SPAN_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <vector>
+#include <boost/config.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+class reader;
+
+//! @brief Read-only view of a typed array.
+//!
+//! The span either aliases the input buffer of the reader, or owns a
+//! converted copy of the elements if the input cannot be aliased.
+//!
+//! An aliased span is only valid as long as the input buffer is alive.
+
+template <typename T>
+class array_span
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_pointer = const value_type *;
+    using const_reference = const value_type&;
+    using const_iterator = const_pointer;
+
+    array_span() BOOST_NOEXCEPT
+        : pointer(nullptr),
+          length(0)
+    {
+    }
+
+    //! @brief Returns true if the elements alias the input buffer.
+    bool aliased() const BOOST_NOEXCEPT
+    {
+        return pointer != nullptr;
+    }
+
+    const_pointer data() const BOOST_NOEXCEPT
+    {
+        return aliased() ? pointer : storage.data();
+    }
+
+    size_type size() const BOOST_NOEXCEPT
+    {
+        return aliased() ? length : storage.size();
+    }
+
+    bool empty() const BOOST_NOEXCEPT
+    {
+        return size() == 0;
+    }
+
+    const_reference operator[](size_type position) const BOOST_NOEXCEPT
+    {
+        assert(position < size());
+        return data()[position];
+    }
+
+    const_iterator begin() const BOOST_NOEXCEPT
+    {
+        return data();
+    }
+
+    const_iterator end() const BOOST_NOEXCEPT
+    {
+        return data() + size();
+    }
+
+private:
+    friend class reader;
+
+    array_span(const_pointer pointer, size_type length) BOOST_NOEXCEPT
+        : pointer(pointer),
+          length(length)
+    {
+        assert(pointer != nullptr);
+    }
+
+    array_span(std::vector<value_type>&& storage) BOOST_NOEXCEPT
+        : pointer(nullptr),
+          length(0),
+          storage(std::move(storage))
+    {
+    }
+
+private:
+    const_pointer pointer;
+    size_type length;
+    std::vector<value_type> storage;
+};
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_ARRAY_SPAN_HPP
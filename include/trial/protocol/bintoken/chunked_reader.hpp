@@ -0,0 +1,172 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_CHUNKED_READER_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_CHUNKED_READER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <deque>
+#include <vector>
+#include <trial/protocol/core/detail/small_stack.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+//! @brief Incremental reader for input that arrives in chunks.
+//!
+//! Input is fed one chunk at a time, and tokens are read from the chunks
+//! without copying. Only a token that straddles two chunks is copied into
+//! an internal buffer.
+//!
+//! Strings and arrays whose payload exceeds the capacity are delivered in
+//! pieces, each of which holds a whole number of elements, so memory use is
+//! bounded by the capacity regardless of the size of the input. Packed arrays
+//! cannot be split and must fit within the capacity.
+
+class chunked_reader
+{
+public:
+    using size_type = std::size_t;
+    using value_type = reader::value_type;
+    using view_type = reader::view_type;
+
+    struct status
+    {
+        enum value
+        {
+            //! A token, or a piece of a token, is available.
+            ready,
+            //! More input must be fed before the next token is available.
+            incomplete,
+            //! All input has been read after finish() was called.
+            end,
+            //! The input is malformed.
+            failed
+        };
+    };
+
+    static const size_type default_capacity = 4096;
+    static const size_type minimum_capacity = 256;
+
+    explicit chunked_reader(size_type capacity = default_capacity);
+
+    chunked_reader(const chunked_reader&) = delete;
+    chunked_reader& operator= (const chunked_reader&) = delete;
+
+    //! @brief Provide the next chunk of input.
+    //!
+    //! The chunk must remain valid until next() returns status::incomplete.
+    void feed(const view_type&) BOOST_NOEXCEPT;
+    template <typename T> void feed(const T&) BOOST_NOEXCEPT;
+
+    //! @brief Signal that no more input will be fed.
+    //!
+    //! A token that is still incomplete is reported as a truncation error.
+    void finish() BOOST_NOEXCEPT;
+
+    //! @brief Advance to the next token, or to the next piece of the current token.
+    status::value next();
+
+    //! @brief Returns true if more pieces of the current token follow.
+    bool partial() const BOOST_NOEXCEPT;
+
+    //! @brief Returns the current token.
+    token::code::value code() const BOOST_NOEXCEPT;
+
+    //! @brief Returns the symbol of the current token.
+    token::symbol::value symbol() const BOOST_NOEXCEPT;
+
+    //! @brief Returns the category of the current token.
+    token::category::value category() const BOOST_NOEXCEPT;
+
+    //! @brief Returns the last error code.
+    std::error_code error() const BOOST_NOEXCEPT;
+
+    //! @brief Returns the length of the current token or piece.
+    //!
+    //! @throws system_error if current token is a group.
+    size_type length() const;
+
+    //! @brief Returns the current nesting level.
+    size_type level() const BOOST_NOEXCEPT;
+
+    //! @brief Return the current value.
+    //!
+    //! @throws system_error if requested type is incompatible with the current token.
+    template <typename ReturnType>
+    typename token::type_cast<ReturnType>::type value() const;
+
+    //! @brief Put the current array or piece into output buffer.
+    //!
+    //! @throws system_error if requested type is incompatible with the current token.
+    template <typename T>
+    size_type array(T* output, size_type output_length) const;
+
+    //! @brief Return a view of the current array or piece.
+    template <typename T>
+    array_span<typename std::remove_const<T>::type> array_view() const;
+
+    //! @brief Return a view of the current value or piece before it is converted into its type.
+    const view_type& literal() const BOOST_NOEXCEPT;
+
+private:
+    struct frame_type
+    {
+        token::code::value code;
+        size_type header;
+        size_type payload;
+        // Size of the elements that a large payload can be split into, or zero
+        size_type element;
+    };
+
+    token::code::value frame(frame_type&) const BOOST_NOEXCEPT;
+    status::value next_piece();
+    status::value stash() BOOST_NOEXCEPT;
+    status::value fail(token::code::value) BOOST_NOEXCEPT;
+    bool structure() BOOST_NOEXCEPT;
+
+    size_type available() const BOOST_NOEXCEPT;
+    value_type peek(size_type) const BOOST_NOEXCEPT;
+    std::uint64_t peek_length(size_type) const BOOST_NOEXCEPT;
+    const value_type *acquire(size_type);
+    void present(token::code::value, const view_type&) BOOST_NOEXCEPT;
+
+private:
+    reader current;
+    view_type input;
+    // Bytes of a token that straddles two chunks
+    std::vector<value_type> carry;
+    bool spent;
+    // Strings defined by string_define tokens
+    std::deque<std::vector<value_type>> dictionary;
+    struct
+    {
+        token::code::value code;
+        size_type remaining;
+        size_type element;
+    } pending;
+    token::code::value previous;
+    core::detail::small_stack<token::code::value, 16> stack;
+    const size_type capacity;
+    bool finished;
+};
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#include <trial/protocol/bintoken/detail/chunked_reader.ipp>
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_CHUNKED_READER_HPP
@@ -0,0 +1,205 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_CONTAINER_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_CONTAINER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <trial/protocol/core/detail/string_view.hpp>
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+
+// A container is a sequence of independently encoded records followed by a
+// footer that indexes them. All integers in the footer are little-endian.
+//
+//   record 0 ... record N-1
+//   key bytes                        (only with keys)
+//   key offsets: (N + 1) x uint64    (only with keys)
+//   record offsets: (N + 1) x uint64
+//   trailer: magic "TPBX", flags uint32, N uint64,
+//            record offsets position uint64, key offsets position uint64
+//
+// Record offsets are relative to the start of the container, and key offsets
+// are relative to the first key byte. The last offset of each table marks
+// the end of the last entry.
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+namespace container
+{
+
+const std::uint8_t magic[] = { 'T', 'P', 'B', 'X' };
+const std::size_t magic_size = sizeof(magic);
+const std::size_t trailer_size = 32;
+const std::size_t offset_size = sizeof(std::uint64_t);
+const std::uint32_t key_flag = 0x01;
+
+} // namespace container
+} // namespace detail
+
+//! @brief Writes records into a seekable container.
+//!
+//! Each record is a complete bintoken encoding, for example the output of a
+//! writer, and must not depend on preceding records. Records are written to
+//! an output buffer of type T, which can be any type with buffer traits,
+//! while their offsets are retained until the footer is written by close()
+//! or when the writer is destroyed.
+//!
+//! Records can be appended with a key. Keys must be appended in ascending
+//! order to support look-up with container_reader::lower_bound(). Records
+//! appended without a key are given an empty key if any other record has
+//! a key.
+//!
+//! @sa container_reader
+template <typename T>
+class container_writer
+{
+    using buffer_type = typename buffer::traits<T>::buffer_type;
+
+public:
+    using size_type = std::size_t;
+    using view_type = reader::view_type;
+    using key_type = core::detail::string_view;
+
+    explicit container_writer(T& output);
+
+    container_writer(const container_writer&) = delete;
+    container_writer& operator= (const container_writer&) = delete;
+
+    ~container_writer();
+
+    //! @brief Appends an encoded record.
+    void append(const view_type& record);
+    template <typename U> void append(const U& record);
+
+    //! @brief Appends an encoded record with a key.
+    void append(const view_type& record, const key_type& key);
+    template <typename U> void append(const U& record, const key_type& key);
+
+    //! @brief Writes the footer.
+    //!
+    //! No records can be appended after the footer has been written.
+    //!
+    //! @returns False if the output buffer could not hold the container.
+    bool close();
+
+    //! @brief Returns false if the output buffer has rejected any output.
+    bool good() const;
+
+    //! @brief Returns the number of appended records.
+    size_type size() const;
+
+private:
+    void put(const std::uint8_t *, size_type);
+    void put_offsets(const std::vector<std::uint64_t>&);
+
+private:
+    buffer_type sink;
+    std::uint64_t position;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> key_offsets;
+    std::vector<std::uint8_t> keys;
+    bool has_keys;
+    bool is_closed;
+    bool success;
+};
+
+//! @brief Random access to the records of a container.
+//!
+//! The reader operates directly on the container bytes, which are typically
+//! a memory-mapped file, and only touches the footer and the requested
+//! records. The container must outlive the reader.
+//!
+//! Records can be accessed by position in constant time, looked up by key
+//! with a binary search, and divided into ranges that can be scanned in
+//! parallel by independent readers.
+//!
+//! @sa container_writer
+class container_reader
+{
+public:
+    using size_type = std::size_t;
+    using value_type = reader::value_type;
+    using view_type = reader::view_type;
+    using key_type = core::detail::string_view;
+
+    //! @brief Validates the footer of a container.
+    //!
+    //! Use good() to check if the container is well-formed.
+    explicit container_reader(const view_type& input);
+    template <typename T> explicit container_reader(const T& input);
+
+    bool good() const;
+
+    //! @brief Returns the number of records.
+    size_type size() const;
+
+    //! @brief Returns true if the records have keys.
+    bool has_keys() const;
+
+    //! @brief Returns the encoded record at index.
+    view_type at(size_type index) const;
+
+    //! @brief Returns a reader positioned at the first token of the record at index.
+    reader record(size_type index) const;
+
+    //! @brief Returns the encoded records [first, last) as a contiguous view.
+    //!
+    //! The view can be scanned with a single reader.
+    view_type range(size_type first, size_type last) const;
+
+    //! @brief Returns the first record of a partition.
+    //!
+    //! The records are divided into the given number of partitions of roughly
+    //! equal encoded size. Partition part covers the records
+    //! [partition(part, parts), partition(part + 1, parts)).
+    size_type partition(size_type part, size_type parts) const;
+
+    //! @brief Returns the key of the record at index.
+    key_type key(size_type index) const;
+
+    //! @brief Returns the first record whose key is not less than key.
+    //!
+    //! Returns size() if there is no such record.
+    size_type lower_bound(const key_type& key) const;
+
+    //! @brief Returns the first record whose key is equal to key.
+    //!
+    //! Returns size() if there is no such record.
+    size_type find(const key_type& key) const;
+
+private:
+    std::uint64_t offset(size_type) const;
+    std::uint64_t key_offset(size_type) const;
+
+private:
+    const value_type *data;
+    const std::uint8_t *offsets;
+    const std::uint8_t *key_offsets;
+    const char *keys;
+    size_type count;
+    bool success;
+};
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#include <trial/protocol/bintoken/detail/container.ipp>
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_CONTAINER_HPP
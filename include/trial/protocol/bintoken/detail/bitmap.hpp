@@ -0,0 +1,123 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_BITMAP_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_BITMAP_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+namespace bitmap
+{
+
+// The payload of a boolean array starts with a header
+//
+//   unused : uint8, number of unused bits in the last byte (0 - 7)
+//
+// followed by the booleans with eight per byte, least significant bit first.
+// Unused bits are zero.
+
+const std::size_t header_size = 1;
+
+//! @brief Returns the payload size of count booleans.
+inline std::size_t size(std::size_t count)
+{
+    return header_size + (count + 7) / 8;
+}
+
+//! @brief Returns the number of unused bits in the last byte.
+inline std::uint8_t unused(std::size_t count)
+{
+    return static_cast<std::uint8_t>((8 - count % 8) % 8);
+}
+
+//! @brief Reads the number of booleans in a payload.
+//!
+//! @returns false if the payload is malformed.
+inline bool read_header(const std::uint8_t *data, std::size_t size, std::uint64_t& count)
+{
+    if (size < header_size)
+        return false;
+    const unsigned int bits = data[0];
+    if ((bits > 7) || ((size == header_size) && (bits != 0)))
+        return false;
+    count = std::uint64_t(size - header_size) * 8 - bits;
+    return true;
+}
+
+//! @brief Packs booleans into bytes.
+//!
+//! Each byte is assembled from eight independent shifts, which the compiler
+//! can vectorize.
+//!
+//! @returns the number of bytes written.
+inline std::size_t pack(std::uint8_t *output, const bool *input, std::size_t count)
+{
+    const std::size_t whole = count / 8;
+    for (std::size_t i = 0; i < whole; ++i)
+    {
+        const bool *bits = input + 8 * i;
+        output[i] = static_cast<std::uint8_t>((unsigned(bits[0]) << 0) |
+                                              (unsigned(bits[1]) << 1) |
+                                              (unsigned(bits[2]) << 2) |
+                                              (unsigned(bits[3]) << 3) |
+                                              (unsigned(bits[4]) << 4) |
+                                              (unsigned(bits[5]) << 5) |
+                                              (unsigned(bits[6]) << 6) |
+                                              (unsigned(bits[7]) << 7));
+    }
+    const std::size_t remainder = count % 8;
+    if (remainder == 0)
+        return whole;
+    unsigned int last = 0;
+    for (std::size_t j = 0; j < remainder; ++j)
+    {
+        last |= unsigned(input[8 * whole + j]) << j;
+    }
+    output[whole] = static_cast<std::uint8_t>(last);
+    return whole + 1;
+}
+
+//! @brief Unpacks bytes into booleans.
+//!
+//! The input must hold at least (count + 7) / 8 bytes.
+inline void unpack(bool *output, const std::uint8_t *input, std::size_t count)
+{
+    const std::size_t whole = count / 8;
+    for (std::size_t i = 0; i < whole; ++i)
+    {
+        const unsigned int bits = input[i];
+        for (std::size_t j = 0; j < 8; ++j)
+        {
+            output[8 * i + j] = ((bits >> j) & 1) != 0;
+        }
+    }
+    const std::size_t remainder = count % 8;
+    for (std::size_t j = 0; j < remainder; ++j)
+    {
+        output[8 * whole + j] = ((input[whole] >> j) & 1) != 0;
+    }
+}
+
+} // namespace bitmap
+} // namespace detail
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_BITMAP_HPP
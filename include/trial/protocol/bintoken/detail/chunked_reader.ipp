@@ -0,0 +1,626 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_CHUNKED_READER_IPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_CHUNKED_READER_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <trial/protocol/bintoken/detail/varint.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+inline chunked_reader::chunked_reader(size_type capacity)
+    : current(view_type()),
+      spent(false),
+      previous(token::code::end),
+      capacity(std::max(capacity, size_type(minimum_capacity))),
+      finished(false)
+{
+    pending.code = token::code::end;
+    pending.remaining = 0;
+    pending.element = 0;
+    stack.push(token::code::end);
+}
+
+inline void chunked_reader::feed(const view_type& chunk) BOOST_NOEXCEPT
+{
+    assert(input.empty());
+    input = chunk;
+}
+
+template <typename T>
+void chunked_reader::feed(const T& chunk) BOOST_NOEXCEPT
+{
+    feed(buffer::traits<T>::view_cast(chunk));
+}
+
+inline void chunked_reader::finish() BOOST_NOEXCEPT
+{
+    finished = true;
+}
+
+inline bool chunked_reader::partial() const BOOST_NOEXCEPT
+{
+    return pending.remaining > 0;
+}
+
+inline token::code::value chunked_reader::code() const BOOST_NOEXCEPT
+{
+    return current.code();
+}
+
+inline token::symbol::value chunked_reader::symbol() const BOOST_NOEXCEPT
+{
+    return current.symbol();
+}
+
+inline token::category::value chunked_reader::category() const BOOST_NOEXCEPT
+{
+    return current.category();
+}
+
+inline std::error_code chunked_reader::error() const BOOST_NOEXCEPT
+{
+    return current.error();
+}
+
+inline auto chunked_reader::length() const -> size_type
+{
+    return current.length();
+}
+
+inline auto chunked_reader::level() const BOOST_NOEXCEPT -> size_type
+{
+    assert(stack.size() > 0);
+    return stack.size() - 1;
+}
+
+template <typename ReturnType>
+typename token::type_cast<ReturnType>::type chunked_reader::value() const
+{
+    return current.value<ReturnType>();
+}
+
+template <typename T>
+auto chunked_reader::array(T* output,
+                           size_type output_length) const -> size_type
+{
+    return current.array(output, output_length);
+}
+
+template <typename T>
+auto chunked_reader::array_view() const -> array_span<typename std::remove_const<T>::type>
+{
+    return current.array_view<T>();
+}
+
+inline auto chunked_reader::literal() const BOOST_NOEXCEPT -> const view_type&
+{
+    return current.literal();
+}
+
+//-----------------------------------------------------------------------------
+
+inline auto chunked_reader::next() -> status::value
+{
+    if (symbol() == token::symbol::error)
+        return status::failed;
+
+    if (spent)
+    {
+        carry.clear();
+        spent = false;
+    }
+
+    if (!structure())
+        return status::failed;
+
+    if (pending.remaining > 0)
+        return next_piece();
+
+    for (;;)
+    {
+        frame_type result;
+        const auto code = frame(result);
+        if (code == token::code::end)
+            return stash();
+        if (token::symbol::convert(code) == token::symbol::error)
+        {
+            switch (code)
+            {
+            case token::code::padding:
+            case token::code::string_define:
+            case token::code::string_reference8:
+            case token::code::string_reference16:
+            case token::code::tensor:
+                break;
+
+            default:
+                return fail(code);
+            }
+        }
+
+        if ((result.element > 0) && (result.payload > capacity))
+        {
+            // Only the header of a large token is consumed now. The payload
+            // is delivered in pieces.
+            acquire(result.header);
+            if (spent)
+            {
+                carry.clear();
+                spent = false;
+            }
+            pending.code = code;
+            pending.remaining = result.payload;
+            pending.element = result.element;
+            return next_piece();
+        }
+        if (result.payload > capacity)
+            return fail(token::code::error_overflow);
+
+        const size_type total = result.header + result.payload;
+        if (available() < total)
+            return stash();
+        const value_type *data = acquire(total);
+
+        switch (code)
+        {
+        case token::code::padding:
+        case token::code::tensor:
+            // Arrays are presented without their shape
+            break;
+
+        case token::code::string_define:
+            if (dictionary.size() > std::numeric_limits<std::uint16_t>::max())
+                return fail(token::code::error_invalid_value);
+            dictionary.emplace_back(data + result.header, data + total);
+            break;
+
+        case token::code::string_reference8:
+        case token::code::string_reference16:
+            {
+                const size_type position = (result.payload == sizeof(std::uint8_t))
+                    ? data[1]
+                    : detail::endian::read<std::uint16_t>(data + 1);
+                if (position >= dictionary.size())
+                    return fail(token::code::error_invalid_value);
+                const auto& entry = dictionary[position];
+                present(token::code::string8, view_type(entry.data(), entry.size()));
+                return status::ready;
+            }
+
+        case token::code::begin_record32:
+            present(token::code::begin_record, view_type());
+            return status::ready;
+
+        case token::code::begin_array32:
+            present(token::code::begin_array, view_type());
+            return status::ready;
+
+        case token::code::begin_assoc_array32:
+            present(token::code::begin_assoc_array, view_type());
+            return status::ready;
+
+        default:
+            present(code, view_type(data + result.header, result.payload));
+            return status::ready;
+        }
+
+        // Padding and definitions are consumed without being presented
+        if (spent)
+        {
+            carry.clear();
+            spent = false;
+        }
+    }
+}
+
+inline auto chunked_reader::next_piece() -> status::value
+{
+    const bool is_varint = detail::basic_array_code<token::code::array8_varint>::same(pending.code);
+
+    view_type piece;
+    if (!carry.empty())
+    {
+        // Complete an element that straddles two chunks
+        if (is_varint)
+        {
+            while (carry.back() & 0x80)
+            {
+                if (carry.size() >= std::min(detail::varint::max_size, pending.remaining))
+                    return fail(token::code::error_invalid_value);
+                if (input.empty())
+                    return stash();
+                carry.push_back(input.front());
+                input.remove_prefix(1);
+            }
+        }
+        else
+        {
+            const size_type count = std::min(pending.element - carry.size(), input.size());
+            carry.insert(carry.end(), input.data(), input.data() + count);
+            input.remove_prefix(count);
+            if (carry.size() < pending.element)
+                return stash();
+        }
+        piece = view_type(carry.data(), carry.size());
+        spent = true;
+    }
+    else
+    {
+        const size_type size = std::min(pending.remaining, input.size());
+        size_type take = size - size % pending.element;
+        if (is_varint)
+        {
+            // Split after the last complete value
+            while ((take > 0) && (input[take - 1] & 0x80))
+            {
+                --take;
+            }
+            if ((take < size) &&
+                ((size == pending.remaining) || (size - take >= detail::varint::max_size)))
+                return fail(token::code::error_invalid_value);
+        }
+        if (take == 0)
+            return stash();
+        piece = input.substr(0, take);
+        input.remove_prefix(take);
+    }
+
+    pending.remaining -= piece.size();
+    present(pending.code, piece);
+    return status::ready;
+}
+
+inline auto chunked_reader::stash() BOOST_NOEXCEPT -> status::value
+{
+    if (finished)
+    {
+        if ((available() == 0) && (pending.remaining == 0))
+        {
+            present(token::code::end, view_type());
+            return status::end;
+        }
+        return fail(token::code::error_truncated);
+    }
+
+    // Keep the incomplete token until more input arrives
+    carry.insert(carry.end(), input.begin(), input.end());
+    input = view_type();
+    present(token::code::end, view_type());
+    return status::incomplete;
+}
+
+inline auto chunked_reader::fail(token::code::value code) BOOST_NOEXCEPT -> status::value
+{
+    present(code, view_type());
+    return status::failed;
+}
+
+inline bool chunked_reader::structure() BOOST_NOEXCEPT
+{
+    // Nesting is updated when advancing past a structural token, as in reader
+    const token::code::value code = previous;
+    previous = token::code::end;
+    switch (code)
+    {
+    case token::code::begin_record:
+        stack.push(token::code::end_record);
+        break;
+
+    case token::code::begin_array:
+        stack.push(token::code::end_array);
+        break;
+
+    case token::code::begin_assoc_array:
+        stack.push(token::code::end_assoc_array);
+        break;
+
+    case token::code::end_record:
+        if (stack.top() != token::code::end_record)
+        {
+            present(token::code::error_expected_end_record, view_type());
+            return false;
+        }
+        stack.pop();
+        break;
+
+    case token::code::end_array:
+        if (stack.top() != token::code::end_array)
+        {
+            present(token::code::error_expected_end_array, view_type());
+            return false;
+        }
+        stack.pop();
+        break;
+
+    case token::code::end_assoc_array:
+        if (stack.top() != token::code::end_assoc_array)
+        {
+            present(token::code::error_expected_end_assoc_array, view_type());
+            return false;
+        }
+        stack.pop();
+        break;
+
+    default:
+        break;
+    }
+    return true;
+}
+
+inline auto chunked_reader::frame(frame_type& result) const BOOST_NOEXCEPT -> token::code::value
+{
+    const size_type size = available();
+    if (size == 0)
+        return token::code::end;
+
+    const value_type element = peek(0);
+    result.header = sizeof(value_type);
+    result.payload = 0;
+    result.element = 0;
+
+    if (((element & 0x80) == 0x00) || ((element & 0xE0) == 0xE0))
+    {
+        // Small integer
+        result.header = 0;
+        result.payload = token::int8::size;
+        return token::code::int8;
+    }
+
+    const auto code = static_cast<token::code::value>(element);
+    size_type alignment = 1;
+    switch (code)
+    {
+    case token::code::null:
+    case token::code::false_value:
+    case token::code::true_value:
+    case token::code::padding:
+    case token::code::begin_record:
+    case token::code::end_record:
+    case token::code::begin_array:
+    case token::code::end_array:
+    case token::code::begin_assoc_array:
+    case token::code::end_assoc_array:
+        return code;
+
+    case token::code::begin_record32:
+    case token::code::begin_array32:
+    case token::code::begin_assoc_array32:
+        // The content is read token by token, so only the length is skipped
+        result.header += sizeof(std::uint32_t);
+        if (size < result.header)
+            return token::code::end;
+        if (peek_length(sizeof(std::uint32_t)) == 0)
+            return token::code::error_invalid_length;
+        return code;
+
+    case token::code::int8:
+        result.payload = token::int8::size;
+        return code;
+
+    case token::code::int16:
+        result.payload = token::int16::size;
+        return code;
+
+    case token::code::int32:
+        result.payload = token::int32::size;
+        return code;
+
+    case token::code::int64:
+        result.payload = token::int64::size;
+        return code;
+
+    case token::code::float32:
+        result.payload = token::float32::size;
+        return code;
+
+    case token::code::float64:
+        result.payload = token::float64::size;
+        return code;
+
+    case token::code::varint:
+    case token::code::field:
+        for (size_type i = 1; i < size; ++i)
+        {
+            if (i > detail::varint::max_size)
+                return token::code::error_invalid_value;
+            if ((peek(i) & 0x80) == 0)
+            {
+                result.payload = i;
+                return code;
+            }
+        }
+        return (size > detail::varint::max_size)
+            ? token::code::error_invalid_value
+            : token::code::end;
+
+    case token::code::string_define:
+        // Definitions hold strings with an 8-bit length
+        result.header += sizeof(std::uint8_t);
+        if (size < result.header)
+            return token::code::end;
+        result.payload = peek(1);
+        return code;
+
+    case token::code::tensor:
+        result.header += sizeof(std::uint8_t);
+        if (size < result.header)
+            return token::code::end;
+        if (peek(1) == 0)
+            return token::code::error_invalid_value;
+        result.payload = peek(1) * sizeof(std::uint32_t);
+        return code;
+
+    case token::code::string_reference8:
+        result.payload = sizeof(std::uint8_t);
+        return code;
+
+    case token::code::string_reference16:
+        result.payload = sizeof(std::uint16_t);
+        return code;
+
+    case token::code::array8_int8:
+    case token::code::array16_int8:
+    case token::code::array32_int8:
+    case token::code::array64_int8:
+    case token::code::array8_varint:
+    case token::code::array16_varint:
+    case token::code::array32_varint:
+    case token::code::array64_varint:
+    case token::code::string8:
+    case token::code::string16:
+    case token::code::string32:
+    case token::code::string64:
+        result.element = token::int8::size;
+        break;
+
+    case token::code::array8_int16:
+    case token::code::array16_int16:
+    case token::code::array32_int16:
+    case token::code::array64_int16:
+        result.element = alignment = token::int16::size;
+        break;
+
+    case token::code::array8_int32:
+    case token::code::array16_int32:
+    case token::code::array32_int32:
+    case token::code::array64_int32:
+        result.element = alignment = token::int32::size;
+        break;
+
+    case token::code::array8_int64:
+    case token::code::array16_int64:
+    case token::code::array32_int64:
+    case token::code::array64_int64:
+        result.element = alignment = token::int64::size;
+        break;
+
+    case token::code::array8_float32:
+    case token::code::array16_float32:
+    case token::code::array32_float32:
+    case token::code::array64_float32:
+        result.element = alignment = token::float32::size;
+        break;
+
+    case token::code::array8_float64:
+    case token::code::array16_float64:
+    case token::code::array32_float64:
+    case token::code::array64_float64:
+        result.element = alignment = token::float64::size;
+        break;
+
+    case token::code::array8_float16:
+    case token::code::array16_float16:
+    case token::code::array32_float16:
+    case token::code::array8_bfloat16:
+    case token::code::array16_bfloat16:
+    case token::code::array32_bfloat16:
+        result.element = alignment = sizeof(std::uint16_t);
+        break;
+
+    case token::code::array8_packed:
+    case token::code::array16_packed:
+    case token::code::array32_packed:
+    case token::code::array64_packed:
+    case token::code::array8_bool:
+    case token::code::array16_bool:
+    case token::code::array32_bool:
+    case token::code::array64_bool:
+        // Packed arrays cannot be split
+        break;
+
+    default:
+        return token::code::error_unknown_token;
+    }
+
+    // Variable-length token whose upper nibble determines the size of the
+    // length field
+    const size_type length_size = size_type(1) << ((element - detail::pattern::len8) >> 4);
+    result.header += length_size;
+    if (size < result.header)
+        return token::code::end;
+    const std::uint64_t length = peek_length(length_size);
+    if ((length_size == sizeof(std::uint64_t)) && (std::int64_t(length) < 0))
+        return token::code::error_negative_length;
+    if (length > std::numeric_limits<size_type>::max() - result.header)
+        return token::code::error_overflow;
+    if (length % alignment != 0)
+        return token::code::error_invalid_length;
+    result.payload = size_type(length);
+    return code;
+}
+
+inline auto chunked_reader::available() const BOOST_NOEXCEPT -> size_type
+{
+    return carry.size() + input.size();
+}
+
+inline auto chunked_reader::peek(size_type position) const BOOST_NOEXCEPT -> value_type
+{
+    assert(position < available());
+    return (position < carry.size())
+        ? carry[position]
+        : input[position - carry.size()];
+}
+
+inline std::uint64_t chunked_reader::peek_length(size_type size) const BOOST_NOEXCEPT
+{
+    // Little-endian length field following the token code
+    std::uint64_t result = 0;
+    for (size_type i = size; i > 0; --i)
+    {
+        result = (result << 8) | peek(i);
+    }
+    return result;
+}
+
+inline auto chunked_reader::acquire(size_type size) -> const value_type *
+{
+    // Tokens within a chunk are used in place
+    if (carry.empty() && (input.size() >= size))
+    {
+        const value_type *result = input.data();
+        input.remove_prefix(size);
+        return result;
+    }
+
+    // Complete a token that straddles two chunks
+    assert(carry.size() <= size);
+    assert(available() >= size);
+    const size_type count = size - carry.size();
+    carry.insert(carry.end(), input.data(), input.data() + count);
+    input.remove_prefix(count);
+    spent = true;
+    return carry.data();
+}
+
+inline void chunked_reader::present(token::code::value code, const view_type& view) BOOST_NOEXCEPT
+{
+    current.decoder.assign(code, view);
+    if (category() == token::category::structural)
+    {
+        previous = code;
+    }
+}
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_CHUNKED_READER_IPP
@@ -0,0 +1,331 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_CONTAINER_IPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_CONTAINER_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+//-----------------------------------------------------------------------------
+// container_writer
+//-----------------------------------------------------------------------------
+
+template <typename T>
+container_writer<T>::container_writer(T& output)
+    : sink(output),
+      position(0),
+      has_keys(false),
+      is_closed(false),
+      success(true)
+{
+    static_assert(sizeof(typename buffer_type::value_type) == 1, "Character type must be a single byte");
+
+    offsets.push_back(0);
+    key_offsets.push_back(0);
+}
+
+template <typename T>
+container_writer<T>::~container_writer()
+{
+    close();
+}
+
+template <typename T>
+void container_writer<T>::append(const view_type& record)
+{
+    append(record, key_type());
+}
+
+template <typename T>
+template <typename U>
+void container_writer<T>::append(const U& record)
+{
+    append(view_type(reinterpret_cast<const std::uint8_t *>(record.data()), record.size()));
+}
+
+template <typename T>
+void container_writer<T>::append(const view_type& record,
+                                 const key_type& key)
+{
+    assert(!is_closed);
+
+    put(record.data(), record.size());
+    offsets.push_back(position);
+    if (!key.empty())
+    {
+        has_keys = true;
+        keys.insert(keys.end(), key.begin(), key.end());
+    }
+    key_offsets.push_back(keys.size());
+}
+
+template <typename T>
+template <typename U>
+void container_writer<T>::append(const U& record,
+                                 const key_type& key)
+{
+    append(view_type(reinterpret_cast<const std::uint8_t *>(record.data()), record.size()), key);
+}
+
+template <typename T>
+bool container_writer<T>::close()
+{
+    if (is_closed)
+        return success;
+    is_closed = true;
+
+    std::uint64_t key_position = 0;
+    std::uint32_t flags = 0;
+    if (has_keys)
+    {
+        flags |= detail::container::key_flag;
+        put(keys.data(), keys.size());
+        key_position = position;
+        put_offsets(key_offsets);
+    }
+    const std::uint64_t index_position = position;
+    put_offsets(offsets);
+
+    std::uint8_t trailer[detail::container::trailer_size];
+    std::memcpy(trailer, detail::container::magic, detail::container::magic_size);
+    detail::endian::write<std::uint32_t>(trailer + 4, flags);
+    detail::endian::write<std::uint64_t>(trailer + 8, std::uint64_t(size()));
+    detail::endian::write<std::uint64_t>(trailer + 16, index_position);
+    detail::endian::write<std::uint64_t>(trailer + 24, key_position);
+    put(trailer, sizeof(trailer));
+    return success;
+}
+
+template <typename T>
+bool container_writer<T>::good() const
+{
+    return success;
+}
+
+template <typename T>
+auto container_writer<T>::size() const -> size_type
+{
+    return offsets.size() - 1;
+}
+
+template <typename T>
+void container_writer<T>::put(const std::uint8_t *data, size_type size)
+{
+    using value_type = typename buffer_type::value_type;
+    buffer::base<value_type>& output = sink;
+    if (!output.grow(size))
+    {
+        success = false;
+        return;
+    }
+    output.write(typename buffer::base<value_type>::view_type(reinterpret_cast<const value_type *>(data), size));
+    position += size;
+}
+
+template <typename T>
+void container_writer<T>::put_offsets(const std::vector<std::uint64_t>& table)
+{
+    std::vector<std::uint8_t> scratch(table.size() * detail::container::offset_size);
+    detail::endian::write<std::uint64_t>(scratch.data(), table.data(), table.size());
+    put(scratch.data(), scratch.size());
+}
+
+//-----------------------------------------------------------------------------
+// container_reader
+//-----------------------------------------------------------------------------
+
+inline container_reader::container_reader(const view_type& input)
+    : data(input.data()),
+      offsets(nullptr),
+      key_offsets(nullptr),
+      keys(nullptr),
+      count(0),
+      success(false)
+{
+    using namespace detail::container;
+
+    const std::uint64_t total = input.size();
+    if (total < trailer_size)
+        return;
+    const std::uint8_t *trailer = data + total - trailer_size;
+    if (std::memcmp(trailer, magic, magic_size) != 0)
+        return;
+    const std::uint32_t flags = detail::endian::read<std::uint32_t>(trailer + 4);
+    const std::uint64_t entries = detail::endian::read<std::uint64_t>(trailer + 8);
+    const std::uint64_t index_position = detail::endian::read<std::uint64_t>(trailer + 16);
+    const std::uint64_t key_position = detail::endian::read<std::uint64_t>(trailer + 24);
+
+    // The tables must fill the space between the records and the trailer
+    const std::uint64_t footer = total - trailer_size;
+    if ((entries >= footer / offset_size) ||
+        (index_position != footer - (entries + 1) * offset_size))
+        return;
+    count = size_type(entries);
+    offsets = data + index_position;
+
+    // Record offsets must be ascending and end where the next table starts
+    std::uint64_t last = 0;
+    for (size_type index = 0; index <= count; ++index)
+    {
+        const std::uint64_t current = offset(index);
+        if ((current < last) || (index == 0 && current != 0))
+            return;
+        last = current;
+    }
+
+    if (flags & key_flag)
+    {
+        if ((index_position < (entries + 1) * offset_size) ||
+            (key_position != index_position - (entries + 1) * offset_size) ||
+            (key_position < last))
+            return;
+        key_offsets = data + key_position;
+        keys = reinterpret_cast<const char *>(data + last);
+
+        std::uint64_t key_last = 0;
+        for (size_type index = 0; index <= count; ++index)
+        {
+            const std::uint64_t current = key_offset(index);
+            if ((current < key_last) || (index == 0 && current != 0))
+                return;
+            key_last = current;
+        }
+        if (key_last != key_position - last)
+            return;
+    }
+    else if (last != index_position)
+    {
+        return;
+    }
+    success = true;
+}
+
+template <typename T>
+container_reader::container_reader(const T& input)
+    : container_reader(view_type(reinterpret_cast<const value_type *>(input.data()), input.size()))
+{
+}
+
+inline bool container_reader::good() const
+{
+    return success;
+}
+
+inline auto container_reader::size() const -> size_type
+{
+    return success ? count : 0;
+}
+
+inline bool container_reader::has_keys() const
+{
+    return success && (keys != nullptr);
+}
+
+inline auto container_reader::at(size_type index) const -> view_type
+{
+    return range(index, index + 1);
+}
+
+inline reader container_reader::record(size_type index) const
+{
+    return reader(at(index));
+}
+
+inline auto container_reader::range(size_type first,
+                                    size_type last) const -> view_type
+{
+    last = std::min(last, size());
+    if (first >= last)
+        return view_type();
+    const std::uint64_t start = offset(first);
+    return view_type(data + start, size_type(offset(last) - start));
+}
+
+inline auto container_reader::partition(size_type part,
+                                        size_type parts) const -> size_type
+{
+    assert(parts > 0);
+
+    if (part == 0)
+        return 0;
+    if (part >= parts)
+        return size();
+
+    // Binary search for the first record that starts at or after the
+    // proportional byte position
+    const std::uint64_t total = offset(size());
+    const std::uint64_t target = (total / parts) * part + ((total % parts) * part) / parts;
+    size_type low = 0;
+    size_type high = size();
+    while (low < high)
+    {
+        const size_type middle = low + (high - low) / 2;
+        if (offset(middle) < target)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+inline auto container_reader::key(size_type index) const -> key_type
+{
+    if (!keys || (index >= size()))
+        return key_type();
+    const std::uint64_t start = key_offset(index);
+    return key_type(keys + start, size_type(key_offset(index + 1) - start));
+}
+
+inline auto container_reader::lower_bound(const key_type& wanted) const -> size_type
+{
+    size_type low = 0;
+    size_type high = keys ? size() : 0;
+    while (low < high)
+    {
+        const size_type middle = low + (high - low) / 2;
+        if (key(middle) < wanted)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return keys ? low : size();
+}
+
+inline auto container_reader::find(const key_type& wanted) const -> size_type
+{
+    const size_type where = lower_bound(wanted);
+    return ((where < size()) && (key(where) == wanted)) ? where : size();
+}
+
+inline std::uint64_t container_reader::offset(size_type index) const
+{
+    return detail::endian::read<std::uint64_t>(offsets + index * detail::container::offset_size);
+}
+
+inline std::uint64_t container_reader::key_offset(size_type index) const
+{
+    return detail::endian::read<std::uint64_t>(key_offsets + index * detail::container::offset_size);
+}
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_CONTAINER_IPP
@@ -12,6 +12,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cstdint>
+#include <vector>
 #include <boost/config.hpp>
 #include <trial/protocol/core/detail/string_view.hpp>
 #include <trial/protocol/core/char_traits.hpp>
@@ -36,19 +37,29 @@ public:
 
     decoder(view_type);
     template <typename T> decoder(const T& input);
+    // Trusted decoders omit validation of the input
+    decoder(view_type, bool trusted);
+    template <typename T> decoder(const T& input, bool trusted);
 
     void next() BOOST_NOEXCEPT;
+    void skip() BOOST_NOEXCEPT;
 
     void code(token::code::value) BOOST_NOEXCEPT;
+    // Replace the current token with one framed elsewhere
+    void assign(token::code::value, const view_type&) BOOST_NOEXCEPT;
     token::code::value code() const BOOST_NOEXCEPT;
     token::symbol::value symbol() const BOOST_NOEXCEPT;
     token::category::value category() const BOOST_NOEXCEPT;
     std::error_code error() const BOOST_NOEXCEPT;
 
     const view_type& literal() const BOOST_NOEXCEPT;
+    // Extents of the current array as 32-bit integers, or empty if the array
+    // has no shape
+    const view_type& shape() const BOOST_NOEXCEPT;
     const view_type& tail() const BOOST_NOEXCEPT;
     template <typename Tag> typename Tag::type value() const;
 
+    size_type array(bool *output, size_type output_length);
     size_type array(token::int8::type *output, size_type output_length);
     size_type array(token::int16::type *output, size_type output_length);
     size_type array(token::int32::type *output, size_type output_length);
@@ -57,8 +68,16 @@ public:
     size_type array(token::float64::type *output, size_type output_length);
 
 private:
+    void next_checked() BOOST_NOEXCEPT;
+    void next_trusted() BOOST_NOEXCEPT;
     token::code::value next(value_type, std::int64_t) BOOST_NOEXCEPT;
     token::code::value next_length(value_type, size_type) BOOST_NOEXCEPT;
+    token::code::value next_container(token::code::value) BOOST_NOEXCEPT;
+    token::code::value next_varint() BOOST_NOEXCEPT;
+    token::code::value next_field() BOOST_NOEXCEPT;
+    token::code::value next_tensor() BOOST_NOEXCEPT;
+    token::code::value next_define() BOOST_NOEXCEPT;
+    token::code::value next_reference(size_type) BOOST_NOEXCEPT;
 
     template <typename Tag>
     token::code::value advance() BOOST_NOEXCEPT;
@@ -69,12 +88,34 @@ private:
 private:
     template <typename ReturnType> struct overloader;
 
+    // Dispatch table for trusted decoding indexed by the token code
+    struct dispatch
+    {
+        enum kind
+        {
+            immediate,
+            fixed,
+            length,
+            padding,
+            other
+        };
+
+        token::code::value code;
+        kind action;
+        size_type size;
+    };
+    static const dispatch *dispatch_table();
+
     view_type input;
+    const dispatch *table;
     struct
     {
         mutable token::code::value code;
         view_type view;
+        view_type shape;
     } current;
+    // Strings defined by string_define tokens
+    std::vector<view_type> dictionary;
 };
 
 } // namespace detail
@@ -13,8 +13,15 @@
 
 #include <cassert>
 #include <cstring> // std::memcpy
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+#include <trial/protocol/bintoken/detail/varint.hpp>
+#include <trial/protocol/bintoken/detail/packed.hpp>
+#include <trial/protocol/bintoken/detail/bitmap.hpp>
+#include <trial/protocol/bintoken/detail/half.hpp>
 
 namespace trial
 {
@@ -28,14 +35,170 @@ namespace detail
 namespace pattern
 {
 
-const decoder::value_type mask = 0xF8;
-const decoder::value_type len8 = 0xA8;
-const decoder::value_type len16 = 0xB8;
-const decoder::value_type len32 = 0xC8;
-const decoder::value_type len64 = 0xD8;
+// The upper nibble of variable-length tokens determines the size of the
+// length field.
+const decoder::value_type mask = 0xF0;
+const decoder::value_type len8 = 0xA0;
+const decoder::value_type len16 = 0xB0;
+const decoder::value_type len32 = 0xC0;
+const decoder::value_type len64 = 0xD0;
 
 } // namespace pattern
 
+// Number of elements in an array token
+inline std::uint64_t array_count(token::code::value code,
+                                 const decoder::view_type& view)
+{
+    switch (code & 0x0F)
+    {
+    case token::code::array8_int8 & 0x0F:
+        return view.size();
+    case token::code::array8_int16 & 0x0F:
+        return view.size() / token::int16::size;
+    case token::code::array8_int32 & 0x0F:
+        return view.size() / token::int32::size;
+    case token::code::array8_int64 & 0x0F:
+        return view.size() / token::int64::size;
+    case token::code::array8_float32 & 0x0F:
+        return view.size() / token::float32::size;
+    case token::code::array8_float64 & 0x0F:
+        return view.size() / token::float64::size;
+    case token::code::array8_float16 & 0x0F:
+    case token::code::array8_bfloat16 & 0x0F:
+        return view.size() / sizeof(std::uint16_t);
+    case token::code::array8_bool & 0x0F:
+        {
+            std::uint64_t count = 0;
+            if (!bitmap::read_header(view.data(), view.size(), count))
+                return 0;
+            return count;
+        }
+    case token::code::array8_varint & 0x0F:
+        return varint::count(view.data(), view.data() + view.size());
+    case token::code::array8_packed & 0x0F:
+        {
+            packed::header header;
+            if (!packed::read_header(view.data(), view.size(), header))
+                return 0;
+            return header.count;
+        }
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Variable-length integers
+//-----------------------------------------------------------------------------
+
+template <typename T>
+std::size_t decode_varint_array(const decoder::view_type& view,
+                                T *output,
+                                std::size_t output_length)
+{
+    auto first = view.data();
+    const auto last = first + view.size();
+    std::size_t size = 0;
+    for (; (first != last) && (size < output_length); ++size)
+    {
+        std::int64_t value;
+        first = varint::decode(first, last, value);
+        if (!first)
+            throw bintoken::error(invalid_value);
+        if ((value > std::numeric_limits<T>::max()) ||
+            (value < std::numeric_limits<T>::min()))
+            throw bintoken::error(overflow);
+        output[size] = static_cast<T>(value);
+    }
+    return size;
+}
+
+template <typename T>
+std::size_t decode_packed_array(const decoder::view_type& view,
+                                T *output,
+                                std::size_t output_length)
+{
+    packed::header header;
+    if (!packed::read_header(view.data(), view.size(), header))
+        throw bintoken::error(invalid_value);
+
+    const auto size = std::min<std::size_t>(header.count, output_length);
+    const std::size_t header_size = (header.mode == packed::mode::delta)
+        ? packed::delta_header_size
+        : packed::header_size;
+    const auto input = view.data() + header_size;
+    const auto input_size = view.size() - header_size;
+
+    std::uint64_t previous = header.first;
+    std::size_t index = 0;
+    if (header.mode == packed::mode::delta)
+    {
+        if (size == 0)
+            return 0;
+        const std::int64_t value = static_cast<std::int64_t>(previous);
+        if ((value > std::numeric_limits<T>::max()) ||
+            (value < std::numeric_limits<T>::min()))
+            throw bintoken::error(overflow);
+        output[index++] = static_cast<T>(value);
+    }
+
+    // Unpack a block at a time, and then add the reference to all of them
+    std::uint64_t buffer[packed::block_size];
+    std::size_t offset = 0;
+    while (index < size)
+    {
+        const std::size_t count = std::min(packed::block_size, size - index);
+        packed::unpack(input + offset, input_size - offset, buffer, count, header.width);
+        offset += packed::size(packed::block_size, header.width);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            buffer[i] += header.reference;
+        }
+        if (header.mode == packed::mode::delta)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                previous += buffer[i];
+                buffer[i] = previous;
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::int64_t value = static_cast<std::int64_t>(buffer[i]);
+            if ((value > std::numeric_limits<T>::max()) ||
+                (value < std::numeric_limits<T>::min()))
+                throw bintoken::error(overflow);
+            output[index + i] = static_cast<T>(value);
+        }
+        index += count;
+    }
+    return size;
+}
+
+template <typename Format, typename T>
+std::size_t decode_reduced_array(const decoder::view_type& view,
+                                 T *output,
+                                 std::size_t output_length)
+{
+    const auto size = std::min(view.size() / sizeof(std::uint16_t), output_length);
+    half::decode<Format>(output, view.data(), size);
+    return size;
+}
+
+template <typename Narrow, typename T>
+std::size_t widen_array(const decoder::view_type& view,
+                        T *output,
+                        std::size_t output_length)
+{
+    static_assert(sizeof(Narrow) < sizeof(T), "Array must be widened");
+    const auto size = std::min(view.size() / sizeof(Narrow), output_length);
+    const auto input = view.data();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        output[i] = detail::endian::read<Narrow>(input + i * sizeof(Narrow));
+    }
+    return size;
+}
+
 //-----------------------------------------------------------------------------
 // decoder::overloader
 //-----------------------------------------------------------------------------
@@ -64,6 +227,38 @@ struct decoder::overloader<token::boolean>
             throw bintoken::error(invalid_value);
         }
     }
+
+    static size_type decode(const detail::decoder& self,
+                            bool *output,
+                            size_type output_length)
+    {
+        switch (self.code())
+        {
+        case token::code::true_value:
+        case token::code::false_value:
+            if (output_length < 1)
+                return 0;
+            *output = decode(self);
+            return 1;
+
+        case token::code::array8_bool:
+        case token::code::array16_bool:
+        case token::code::array32_bool:
+        case token::code::array64_bool:
+            {
+                const auto& view = self.literal();
+                std::uint64_t count = 0;
+                if (!bitmap::read_header(view.data(), view.size(), count))
+                    throw bintoken::error(invalid_value);
+                const auto size = std::min<std::uint64_t>(count, output_length);
+                bitmap::unpack(output, view.data() + bitmap::header_size, size);
+                return size;
+            }
+
+        default:
+            throw bintoken::error(invalid_value);
+        }
+    }
 };
 
 template <>
@@ -100,6 +295,18 @@ struct decoder::overloader<token::int8>
                 return size;
             }
 
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+            return decode_varint_array(self.literal(), output, output_length);
+
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
+            return decode_packed_array(self.literal(), output, output_length);
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -136,13 +343,28 @@ struct decoder::overloader<token::int16>
             {
                 auto view = self.literal();
                 const auto size = std::min(view.size() / token::int16::size, output_length);
-                for (size_type i = 0; i < size; ++i)
-                {
-                    output[i] = endian(view_type(&view[i * token::int16::size], token::int16::size));
-                }
+                detail::endian::read(output, view.data(), size);
                 return size;
             }
 
+        case token::code::array8_int8:
+        case token::code::array16_int8:
+        case token::code::array32_int8:
+        case token::code::array64_int8:
+            return widen_array<token::int8::type>(self.literal(), output, output_length);
+
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+            return decode_varint_array(self.literal(), output, output_length);
+
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
+            return decode_packed_array(self.literal(), output, output_length);
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -151,11 +373,7 @@ struct decoder::overloader<token::int16>
     static return_type endian(const view_type& view)
     {
         assert(view.size() == sizeof(return_type));
-        const std::uint16_t endian = UINT16_C(0x0100);
-        return_type result = 0;
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[0]] = static_cast<std::uint8_t>(view[0]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[1]] = static_cast<std::uint8_t>(view[1]);
-        return result;
+        return detail::endian::read<return_type>(view.data());
     }
 };
 
@@ -189,13 +407,34 @@ struct decoder::overloader<token::int32>
             {
                 auto view = self.literal();
                 const auto size = std::min(view.size() / token::int32::size, output_length);
-                for (size_type i = 0; i < size; ++i)
-                {
-                    output[i] = endian(view_type(&view[i * token::int32::size], token::int32::size));
-                }
+                detail::endian::read(output, view.data(), size);
                 return size;
             }
 
+        case token::code::array8_int8:
+        case token::code::array16_int8:
+        case token::code::array32_int8:
+        case token::code::array64_int8:
+            return widen_array<token::int8::type>(self.literal(), output, output_length);
+
+        case token::code::array8_int16:
+        case token::code::array16_int16:
+        case token::code::array32_int16:
+        case token::code::array64_int16:
+            return widen_array<token::int16::type>(self.literal(), output, output_length);
+
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+            return decode_varint_array(self.literal(), output, output_length);
+
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
+            return decode_packed_array(self.literal(), output, output_length);
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -204,13 +443,7 @@ struct decoder::overloader<token::int32>
     static return_type endian(const view_type& view)
     {
         assert(view.size() == sizeof(return_type));
-        const std::uint32_t endian = UINT32_C(0x03020100);
-        return_type result = 0;
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[0]] = static_cast<std::uint8_t>(view[0]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[1]] = static_cast<std::uint8_t>(view[1]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[2]] = static_cast<std::uint8_t>(view[2]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[3]] = static_cast<std::uint8_t>(view[3]);
-        return result;
+        return detail::endian::read<return_type>(view.data());
     }
 };
 
@@ -244,13 +477,40 @@ struct decoder::overloader<token::int64>
             {
                 auto view = self.literal();
                 const auto size = std::min(view.size() / token::int64::size, output_length);
-                for (size_type i = 0; i < size; ++i)
-                {
-                    output[i] = endian(view_type(&view[i * token::int64::size], token::int64::size));
-                }
+                detail::endian::read(output, view.data(), size);
                 return size;
             }
 
+        case token::code::array8_int8:
+        case token::code::array16_int8:
+        case token::code::array32_int8:
+        case token::code::array64_int8:
+            return widen_array<token::int8::type>(self.literal(), output, output_length);
+
+        case token::code::array8_int16:
+        case token::code::array16_int16:
+        case token::code::array32_int16:
+        case token::code::array64_int16:
+            return widen_array<token::int16::type>(self.literal(), output, output_length);
+
+        case token::code::array8_int32:
+        case token::code::array16_int32:
+        case token::code::array32_int32:
+        case token::code::array64_int32:
+            return widen_array<token::int32::type>(self.literal(), output, output_length);
+
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+            return decode_varint_array(self.literal(), output, output_length);
+
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
+            return decode_packed_array(self.literal(), output, output_length);
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -259,17 +519,7 @@ struct decoder::overloader<token::int64>
     static return_type endian(const view_type& view)
     {
         assert(view.size() == sizeof(return_type));
-        const std::uint64_t endian = UINT64_C(0x0706050403020100);
-        return_type result = 0;
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[0]] = static_cast<std::uint8_t>(view[0]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[1]] = static_cast<std::uint8_t>(view[1]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[2]] = static_cast<std::uint8_t>(view[2]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[3]] = static_cast<std::uint8_t>(view[3]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[4]] = static_cast<std::uint8_t>(view[4]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[5]] = static_cast<std::uint8_t>(view[5]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[6]] = static_cast<std::uint8_t>(view[6]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[7]] = static_cast<std::uint8_t>(view[7]);
-        return result;
+        return detail::endian::read<return_type>(view.data());
     }
 };
 
@@ -304,13 +554,20 @@ struct decoder::overloader<token::float32>
             {
                 auto view = self.literal();
                 const auto size = std::min(view.size() / token::float32::size, output_length);
-                for (size_type i = 0; i < size; ++i)
-                {
-                    output[i] = endian(view_type(&view[i * token::float32::size], token::float32::size));
-                }
+                detail::endian::read(output, view.data(), size);
                 return size;
             }
 
+        case token::code::array8_float16:
+        case token::code::array16_float16:
+        case token::code::array32_float16:
+            return decode_reduced_array<half::float16>(self.literal(), output, output_length);
+
+        case token::code::array8_bfloat16:
+        case token::code::array16_bfloat16:
+        case token::code::array32_bfloat16:
+            return decode_reduced_array<half::bfloat16>(self.literal(), output, output_length);
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -319,13 +576,7 @@ struct decoder::overloader<token::float32>
     static return_type endian(const view_type& view)
     {
         assert(view.size() == sizeof(return_type));
-        const std::uint32_t endian = UINT32_C(0x03020100);
-        return_type result = 0;
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[0]] = static_cast<std::uint8_t>(view[0]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[1]] = static_cast<std::uint8_t>(view[1]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[2]] = static_cast<std::uint8_t>(view[2]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[3]] = static_cast<std::uint8_t>(view[3]);
-        return result;
+        return detail::endian::read<return_type>(view.data());
     }
 };
 
@@ -359,13 +610,20 @@ struct decoder::overloader<token::float64>
             {
                 auto view = self.literal();
                 const auto size = std::min(view.size() / token::float64::size, output_length);
-                for (size_type i = 0; i < size; ++i)
-                {
-                    output[i] = endian(view_type(&view[i * token::float64::size], token::float64::size));
-                }
+                detail::endian::read(output, view.data(), size);
                 return size;
             }
 
+        case token::code::array8_float16:
+        case token::code::array16_float16:
+        case token::code::array32_float16:
+            return decode_reduced_array<half::float16>(self.literal(), output, output_length);
+
+        case token::code::array8_bfloat16:
+        case token::code::array16_bfloat16:
+        case token::code::array32_bfloat16:
+            return decode_reduced_array<half::bfloat16>(self.literal(), output, output_length);
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -374,20 +632,42 @@ struct decoder::overloader<token::float64>
     static return_type endian(const view_type& view)
     {
         assert(view.size() == sizeof(return_type));
-        const std::uint64_t endian = UINT64_C(0x0706050403020100);
+        return detail::endian::read<return_type>(view.data());
+    }
+};
+
+template <>
+struct decoder::overloader<token::varint>
+{
+    using return_type = token::varint::type;
+
+    static return_type decode(const detail::decoder& self)
+    {
+        assert(self.code() == token::varint::code);
+        const auto& view = self.literal();
         return_type result = 0;
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[0]] = static_cast<std::uint8_t>(view[0]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[1]] = static_cast<std::uint8_t>(view[1]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[2]] = static_cast<std::uint8_t>(view[2]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[3]] = static_cast<std::uint8_t>(view[3]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[4]] = static_cast<std::uint8_t>(view[4]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[5]] = static_cast<std::uint8_t>(view[5]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[6]] = static_cast<std::uint8_t>(view[6]);
-        ((volatile std::uint8_t *)&result)[((std::uint8_t *)&endian)[7]] = static_cast<std::uint8_t>(view[7]);
+        const auto last = varint::decode(view.data(), view.data() + view.size(), result);
+        assert(last == view.data() + view.size());
+        (void)last;
         return result;
     }
 };
 
+template <>
+struct decoder::overloader<token::field>
+{
+    using return_type = token::field::type;
+
+    static return_type decode(const detail::decoder& self)
+    {
+        assert(self.code() == token::field::code);
+        const auto& view = self.literal();
+        std::int64_t result = 0;
+        varint::decode(view.data(), view.data() + view.size(), result);
+        return static_cast<return_type>(result);
+    }
+};
+
 template <>
 struct decoder::overloader<token::string>
 {
@@ -405,23 +685,120 @@ struct decoder::overloader<token::string>
 //-----------------------------------------------------------------------------
 
 inline decoder::decoder(view_type view)
-    : input(std::move(view))
+    : decoder(std::move(view), false)
+{
+}
+
+template <typename T>
+decoder::decoder(const T& input)
+    : decoder(buffer::traits<T>::view_cast(input), false)
+{
+}
+
+inline decoder::decoder(view_type view, bool trusted)
+    : input(std::move(view)),
+      table(trusted ? dispatch_table() : nullptr)
 {
     current.code = token::code::end;
     next();
 }
 
 template <typename T>
-decoder::decoder(const T& input)
-    : decoder(buffer::traits<T>::view_cast(input))
+decoder::decoder(const T& input, bool trusted)
+    : decoder(buffer::traits<T>::view_cast(input), trusted)
 {
 }
 
+inline auto decoder::dispatch_table() -> const dispatch *
+{
+    struct table_type
+    {
+        table_type()
+        {
+            for (std::size_t element = 0; element < 256; ++element)
+            {
+                const auto code = static_cast<token::code::value>(element);
+                auto& entry = data[element];
+                entry.code = code;
+                entry.action = dispatch::other;
+                entry.size = 0;
+
+                if (((element & 0x80) == 0x00) || ((element & 0xE0) == 0xE0))
+                {
+                    // Small integer
+                    entry.code = token::code::int8;
+                    entry.action = dispatch::immediate;
+                    continue;
+                }
+
+                switch (code)
+                {
+                case token::code::padding:
+                    entry.action = dispatch::padding;
+                    break;
+
+                case token::code::null:
+                case token::code::false_value:
+                case token::code::true_value:
+                case token::code::begin_record:
+                case token::code::end_record:
+                case token::code::begin_array:
+                case token::code::end_array:
+                case token::code::begin_assoc_array:
+                case token::code::end_assoc_array:
+                    entry.action = dispatch::fixed;
+                    break;
+
+                case token::code::int8:
+                case token::code::int16:
+                case token::code::int32:
+                case token::code::int64:
+                    entry.action = dispatch::fixed;
+                    entry.size = size_type(1) << ((element - pattern::len8) >> 4);
+                    break;
+
+                case token::code::float32:
+                    entry.action = dispatch::fixed;
+                    entry.size = token::float32::size;
+                    break;
+
+                case token::code::float64:
+                    entry.action = dispatch::fixed;
+                    entry.size = token::float64::size;
+                    break;
+
+                default:
+                    if (token::symbol::convert(code) == token::symbol::array ||
+                        token::symbol::convert(code) == token::symbol::string)
+                    {
+                        // Size of the length field
+                        entry.action = dispatch::length;
+                        entry.size = size_type(1) << ((element - pattern::len8) >> 4);
+                    }
+                    break;
+                }
+            }
+        }
+
+        dispatch data[256];
+    };
+    static const table_type table;
+    return table.data;
+}
+
+
 inline void decoder::code(token::code::value v) BOOST_NOEXCEPT
 {
     current.code = v;
 }
 
+inline void decoder::assign(token::code::value v, const view_type& view) BOOST_NOEXCEPT
+{
+    current.code = v;
+    current.view = view;
+    current.shape = view_type();
+}
+
 inline token::code::value decoder::code() const BOOST_NOEXCEPT
 {
     return current.code;
@@ -447,6 +824,11 @@ inline const decoder::view_type& decoder::literal() const BOOST_NOEXCEPT
     return current.view;
 }
 
+inline auto decoder::shape() const BOOST_NOEXCEPT -> const view_type&
+{
+    return current.shape;
+}
+
 inline auto decoder::tail() const BOOST_NOEXCEPT -> const view_type&
 {
     return input;
@@ -458,6 +840,11 @@ typename Tag::type decoder::value() const
     return overloader<Tag>::decode(*this);
 }
 
+inline auto decoder::array(bool *buffer, size_type size) -> size_type
+{
+    return overloader<token::boolean>::decode(*this, buffer, size);
+}
+
 inline auto decoder::array(token::int8::type *buffer, size_type size) -> size_type
 {
     return overloader<token::int8>::decode(*this, buffer, size);
@@ -491,9 +878,108 @@ inline auto decoder::array(token::float64::type *buffer, size_type size) -> size
 //-----------------------------------------------------------------------------
 
 inline void decoder::next() BOOST_NOEXCEPT
+{
+    current.shape = view_type();
+    if (table)
+        next_trusted();
+    else
+        next_checked();
+}
+
+inline void decoder::next_trusted() BOOST_NOEXCEPT
+{
+    // Tokens are framed by the dispatch table and the length fields only.
+    // Uncommon tokens are delegated to the validating decoder.
+    while (!input.empty())
+    {
+        const value_type element = input.front();
+        const dispatch& entry = table[element];
+        switch (entry.action)
+        {
+        case dispatch::immediate:
+            current.code = entry.code;
+            current.view = input.substr(0, 1);
+            input.remove_prefix(1);
+            return;
+
+        case dispatch::fixed:
+            if (input.size() <= entry.size)
+                break;
+            current.code = entry.code;
+            current.view = input.substr(1, entry.size);
+            input.remove_prefix(1 + entry.size);
+            return;
+
+        case dispatch::length:
+            {
+                if (input.size() <= entry.size)
+                    break;
+                size_type size = 0;
+                switch (entry.size)
+                {
+                case sizeof(std::uint8_t):
+                    size = input[1];
+                    break;
+                case sizeof(std::uint16_t):
+                    size = endian::read<std::uint16_t>(input.data() + 1);
+                    break;
+                case sizeof(std::uint32_t):
+                    size = endian::read<std::uint32_t>(input.data() + 1);
+                    break;
+                default:
+                    size = size_type(endian::read<std::uint64_t>(input.data() + 1));
+                    break;
+                }
+                const size_type header = 1 + entry.size;
+                if (input.size() - header < size)
+                    break;
+                current.code = entry.code;
+                current.view = input.substr(header, size);
+                input.remove_prefix(header + size);
+                return;
+            }
+
+        case dispatch::padding:
+            input.remove_prefix(1);
+            continue;
+
+        case dispatch::other:
+            next_checked();
+            return;
+        }
+        // Truncated input
+        current.code = token::code::end;
+        return;
+    }
+    current.code = token::code::end;
+}
+
+inline void decoder::next_checked() BOOST_NOEXCEPT
 {
     // FIXME: return if error
 
+    // Skip alignment padding and record string definitions
+    while (!input.empty())
+    {
+        if (input.front() == token::code::padding)
+        {
+            input.remove_prefix(1);
+        }
+        else if (input.front() == token::code::string_define)
+        {
+            const auto code = next_define();
+            if (code != token::code::string_define)
+            {
+                current.code = code;
+                return;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
     if (input.empty())
     {
         current.code = token::code::end;
@@ -556,6 +1042,18 @@ inline void decoder::next() BOOST_NOEXCEPT
             current.code = advance<token::end_assoc_array>();
             break;
 
+        case token::code::begin_record32:
+            current.code = next_container(token::code::begin_record);
+            break;
+
+        case token::code::begin_array32:
+            current.code = next_container(token::code::begin_array);
+            break;
+
+        case token::code::begin_assoc_array32:
+            current.code = next_container(token::code::begin_assoc_array);
+            break;
+
         case token::code::int8:
             current.code = advance<token::int8>();
             break;
@@ -580,6 +1078,26 @@ inline void decoder::next() BOOST_NOEXCEPT
             current.code = advance<token::float64>();
             break;
 
+        case token::code::string_reference8:
+            current.code = next_reference(sizeof(std::uint8_t));
+            break;
+
+        case token::code::string_reference16:
+            current.code = next_reference(sizeof(std::uint16_t));
+            break;
+
+        case token::code::varint:
+            current.code = next_varint();
+            break;
+
+        case token::code::field:
+            current.code = next_field();
+            break;
+
+        case token::code::tensor:
+            current.code = next_tensor();
+            break;
+
         case token::code::array8_int8:
         case token::code::array16_int8:
         case token::code::array32_int8:
@@ -622,6 +1140,57 @@ inline void decoder::next() BOOST_NOEXCEPT
             current.code = next_length(element, token::float64::size);
             break;
 
+        case token::code::array8_float16:
+        case token::code::array16_float16:
+        case token::code::array32_float16:
+        case token::code::array8_bfloat16:
+        case token::code::array16_bfloat16:
+        case token::code::array32_bfloat16:
+            current.code = next_length(element, sizeof(std::uint16_t));
+            break;
+
+        case token::code::array8_bool:
+        case token::code::array16_bool:
+        case token::code::array32_bool:
+        case token::code::array64_bool:
+            current.code = next_length(element, token::int8::size);
+            if (current.code == element)
+            {
+                std::uint64_t count = 0;
+                if (!bitmap::read_header(current.view.data(), current.view.size(), count))
+                {
+                    current.code = token::code::error_invalid_value;
+                }
+            }
+            break;
+
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+            current.code = next_length(element, token::int8::size);
+            // The last value must be complete
+            if ((current.code == element) && !current.view.empty() && (current.view.back() & 0x80))
+            {
+                current.code = token::code::error_invalid_value;
+            }
+            break;
+
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
+            current.code = next_length(element, token::int8::size);
+            if (current.code == element)
+            {
+                packed::header header;
+                if (!packed::read_header(current.view.data(), current.view.size(), header))
+                {
+                    current.code = token::code::error_invalid_value;
+                }
+            }
+            break;
+
         case token::code::string8:
         case token::code::string16:
         case token::code::string32:
@@ -686,6 +1255,137 @@ inline token::code::value decoder::next_length(value_type element, size_type siz
     return token::code::error_unknown_token;
 }
 
+inline token::code::value decoder::next_varint() BOOST_NOEXCEPT
+{
+    const size_type limit = std::min(input.size(), varint::max_size);
+    for (size_type size = 0; size < limit; ++size)
+    {
+        if ((input[size] & 0x80) == 0)
+        {
+            current.view = input.substr(0, size + 1);
+            input.remove_prefix(size + 1);
+            return token::code::varint;
+        }
+    }
+    if (limit < varint::max_size)
+        return token::code::end;
+    return token::code::error_invalid_value;
+}
+
+inline token::code::value decoder::next_field() BOOST_NOEXCEPT
+{
+    const auto code = next_varint();
+    if (code != token::code::varint)
+        return code;
+
+    std::int64_t tag = 0;
+    varint::decode(current.view.data(), current.view.data() + current.view.size(), tag);
+    if ((tag < 0) || (tag > std::numeric_limits<token::field::type>::max()))
+        return token::code::error_invalid_value;
+    return token::code::field;
+}
+
+inline token::code::value decoder::next_tensor() BOOST_NOEXCEPT
+{
+    if (input.empty())
+        return token::code::end;
+    const size_type rank = input.front();
+    if (rank == 0)
+        return token::code::error_invalid_value;
+    const size_type header = sizeof(std::uint8_t) + rank * sizeof(std::uint32_t);
+    if (input.size() < header)
+        return token::code::end;
+    const view_type shape = input.substr(sizeof(std::uint8_t), header - sizeof(std::uint8_t));
+
+    // The shape must be followed by an array, possibly preceded by padding
+    size_type position = header;
+    while ((position < input.size()) && (input[position] == token::code::padding))
+    {
+        ++position;
+    }
+    if (position == input.size())
+        return token::code::end;
+    if (token::symbol::convert(static_cast<token::code::value>(input[position])) != token::symbol::array)
+        return token::code::error_unexpected_token;
+
+    input.remove_prefix(position);
+    next_checked();
+    if (symbol() != token::symbol::array)
+        return current.code;
+
+    // The extents must match the number of elements
+    std::uint64_t product = 1;
+    for (size_type offset = 0; offset < shape.size(); offset += sizeof(std::uint32_t))
+    {
+        const std::uint64_t extent = endian::read<std::uint32_t>(shape.data() + offset);
+        if ((extent != 0) && (product > std::numeric_limits<std::uint64_t>::max() / extent))
+            return token::code::error_invalid_value;
+        product *= extent;
+    }
+    if (product != array_count(current.code, current.view))
+        return token::code::error_invalid_value;
+
+    current.shape = shape;
+    return current.code;
+}
+
+inline token::code::value decoder::next_define() BOOST_NOEXCEPT
+{
+    // Definitions hold strings with an 8-bit length
+    if (input.size() < 2 * sizeof(value_type))
+        return token::code::end;
+    const size_type size = input[1];
+    if (input.size() < 2 * sizeof(value_type) + size)
+        return token::code::end;
+    if (dictionary.size() > std::numeric_limits<std::uint16_t>::max())
+        return token::code::error_invalid_value;
+
+    dictionary.push_back(input.substr(2 * sizeof(value_type), size));
+    input.remove_prefix(2 * sizeof(value_type) + size);
+    return token::code::string_define;
+}
+
+inline token::code::value decoder::next_reference(size_type size) BOOST_NOEXCEPT
+{
+    // References are presented as strings whose literal is the interned view
+    // of the definition, so repeated strings share the same data.
+    if (input.size() < size)
+        return token::code::end;
+    const size_type position = (size == sizeof(std::uint8_t))
+        ? input.front()
+        : endian::read<std::uint16_t>(input.data());
+    if (position >= dictionary.size())
+        return token::code::error_invalid_value;
+
+    current.view = dictionary[position];
+    input.remove_prefix(size);
+    return token::code::string8;
+}
+
+inline token::code::value decoder::next_container(token::code::value code) BOOST_NOEXCEPT
+{
+    // The container content remains in the input, but is also made available
+    // as the literal so that it can be skipped.
+    if (input.size() < sizeof(std::uint32_t))
+        return token::code::end;
+
+    const size_type size = endian::read<std::uint32_t>(input.data());
+    if (size == 0)
+        return token::code::error_invalid_length;
+    if (input.size() - sizeof(std::uint32_t) < size)
+        return token::code::end;
+
+    input.remove_prefix(sizeof(std::uint32_t));
+    current.view = input.substr(0, size);
+    return code;
+}
+
+inline void decoder::skip() BOOST_NOEXCEPT
+{
+    input.remove_prefix(current.view.size());
+    next();
+}
+
 inline token::code::value decoder::next(value_type element, std::int64_t size) BOOST_NOEXCEPT
 {
     if (size < 0)
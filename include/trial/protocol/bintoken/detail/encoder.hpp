@@ -12,12 +12,21 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cstddef> // std::size_t
+#include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <string>
-#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <trial/protocol/buffer/base.hpp>
 #include <trial/protocol/core/detail/string_view.hpp>
+#include <trial/protocol/core/detail/small_stack.hpp>
 #include <trial/protocol/core/char_traits.hpp>
 #include <trial/protocol/bintoken/token.hpp>
+#include <trial/protocol/bintoken/packing.hpp>
+#include <trial/protocol/bintoken/precision.hpp>
+#include <trial/protocol/bintoken/detail/packed.hpp>
 
 namespace trial
 {
@@ -38,6 +47,20 @@ public:
 
     template <typename T>
     encoder(T&);
+    encoder(const encoder&) = delete;
+    encoder& operator=(const encoder&) = delete;
+    ~encoder();
+
+    template <typename T>
+    void reset(T&);
+
+    void align(size_type);
+    void length_prefix(bool);
+    void varint(bool);
+    void narrow(bool);
+    void packing(packing::value);
+    void precision(bintoken::precision::value);
+    void dictionary(bool);
 
     template <typename T> size_type value();
     size_type value(bool);
@@ -50,7 +73,10 @@ public:
     size_type value(const string_view_type&);
     size_type value(const char *);
     size_type value(const char *, size_type);
+    size_type field(token::field::type);
+    size_type tensor(const std::uint32_t *, size_type);
 
+    size_type array(const bool *, size_type);
     size_type array(const token::int8::type *, size_type);
     size_type array(const token::int16::type *, size_type);
     size_type array(const token::int32::type *, size_type);
@@ -59,12 +85,49 @@ public:
     size_type array(const token::float64::type *, size_type);
 
 private:
+    using buffer_type = buffer::base<value_type>;
+
+    template <typename T>
+    buffer_type *create(T&);
+    void destroy();
+
+    size_type begin_container(token::code::value, token::code::value);
+    size_type end_container(token::code::value);
+
+    size_type write_padding(size_type);
+    size_type write_varint(std::int64_t);
+    size_type write_interned(const string_view_type&);
+    size_type write_array_header(token::code::value, size_type);
+    template <typename T>
+    bool pack_array(const T *, size_type, size_type&);
+    template <typename T>
+    size_type narrow_size(const T *, size_type);
+    template <typename Narrow, typename T>
+    size_type write_narrow_array(token::code::value, const T *, size_type);
+    template <typename T>
+    packed::header packed_frame(const T *, size_type);
+    template <typename T>
+    packed::header packed_delta(const T *, size_type);
+    template <typename T>
+    size_type write_packed_array(const packed::header&, const T *, size_type);
+    template <typename T>
+    size_type varint_size(const T *, size_type);
+    template <typename T>
+    size_type write_varint_array(const T *, size_type, size_type);
+    template <typename T>
+    bool reduce_array(const T *, size_type, size_type&);
+    template <typename Format, typename T>
+    size_type write_reduced_array(const T *, size_type);
     size_type write_length(std::uint8_t);
     size_type write_length(std::uint16_t);
     size_type write_length(std::uint32_t);
     size_type write_length(std::uint64_t);
     size_type write(value_type);
     size_type write(const view_type&);
+    size_type commit(size_type);
+
+    template <typename T>
+    void write_array(const T *, size_type);
 
     void endian_write(token::int16::type);
     void endian_write(token::int32::type);
@@ -77,8 +140,73 @@ private:
     void endian_write(std::uint64_t);
 
 private:
-    using buffer_type = buffer::base<value_type>;
-    std::unique_ptr<buffer_type> buffer;
+    // Most sinks only hold a reference to the output, so they are placed in
+    // the inline storage to avoid a heap allocation per encoder.
+    using storage_type = std::aligned_storage<4 * sizeof(void *)>::type;
+    storage_type storage;
+    buffer_type *sink;
+    bool is_inline;
+
+    // Containers with a length prefix are encoded into the scratch buffer
+    // until the outermost of them is closed, because the lengths must be
+    // back-patched.
+    class scratch_buffer : public buffer_type
+    {
+    public:
+        virtual bool grow(size_type delta)
+        {
+            const size_type size = data.size() + delta;
+            if (size > data.capacity())
+            {
+                data.reserve(std::max(size, 2 * data.capacity()));
+            }
+            return true;
+        }
+
+        virtual void write(value_type value)
+        {
+            data.push_back(value);
+        }
+
+        virtual void write(const view_type& view)
+        {
+            data.insert(data.end(), view.begin(), view.end());
+        }
+
+        std::vector<value_type> data;
+    };
+    scratch_buffer scratch;
+    // Offsets of the length fields of the open containers. Containers
+    // without a length prefix are marked with the maximum size_type.
+    core::detail::small_stack<size_type, 16> frames;
+
+    buffer_type *buffer;
+    size_type position;
+    size_type alignment;
+    bool prefix;
+    bool compact;
+    bool narrowing;
+    bintoken::packing::value policy;
+    bintoken::precision::value reduction;
+
+    // String dictionary. The keys are views of the owned strings, which
+    // have stable addresses in a deque.
+    struct string_hash
+    {
+        std::size_t operator()(const string_view_type& view) const
+        {
+            // FNV-1a
+            std::size_t result = 2166136261U;
+            for (auto character : view)
+            {
+                result = (result ^ static_cast<unsigned char>(character)) * 16777619U;
+            }
+            return result;
+        }
+    };
+    bool interning;
+    std::deque<std::string> string_storage;
+    std::unordered_map<string_view_type, size_type, string_hash> strings;
 };
 
 } // namespace detail
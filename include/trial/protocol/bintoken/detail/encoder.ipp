@@ -11,10 +11,19 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <cassert>
+#include <algorithm>
 #include <limits>
+#include <memory> // std::addressof
+#include <new>
 #include <trial/protocol/buffer/base.hpp>
 #include <trial/protocol/bintoken/token.hpp>
 #include <trial/protocol/bintoken/error.hpp>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+#include <trial/protocol/bintoken/detail/varint.hpp>
+#include <trial/protocol/bintoken/detail/packed.hpp>
+#include <trial/protocol/bintoken/detail/bitmap.hpp>
+#include <trial/protocol/bintoken/detail/half.hpp>
 
 namespace trial
 {
@@ -27,10 +36,98 @@ namespace detail
 
 template <typename T>
 encoder::encoder(T& output)
-    : buffer(new typename buffer::traits<T>::buffer_type(output))
+    : sink(create(output)),
+      buffer(sink),
+      position(0),
+      alignment(1),
+      prefix(false),
+      compact(false),
+      narrowing(false),
+      policy(packing::none),
+      reduction(bintoken::precision::full),
+      interning(false)
 {
 }
 
+inline encoder::~encoder()
+{
+    destroy();
+}
+
+template <typename T>
+void encoder::reset(T& output)
+{
+    destroy();
+    sink = create(output);
+    buffer = sink;
+    position = 0;
+    scratch.data.clear();
+    frames.clear();
+    strings.clear();
+    string_storage.clear();
+}
+
+template <typename T>
+auto encoder::create(T& output) -> buffer_type *
+{
+    using sink_type = typename buffer::traits<T>::buffer_type;
+
+    is_inline = (sizeof(sink_type) <= sizeof(storage_type)) &&
+        (alignof(sink_type) <= alignof(storage_type));
+    if (is_inline)
+    {
+        return ::new (std::addressof(storage)) sink_type(output);
+    }
+    return new sink_type(output);
+}
+
+inline void encoder::destroy()
+{
+    if (is_inline)
+    {
+        sink->~buffer_type();
+    }
+    else
+    {
+        delete sink;
+    }
+}
+
+inline void encoder::align(size_type size)
+{
+    alignment = (size == 0) ? 1 : size;
+}
+
+inline void encoder::length_prefix(bool enable)
+{
+    prefix = enable;
+}
+
+inline void encoder::varint(bool enable)
+{
+    compact = enable;
+}
+
+inline void encoder::narrow(bool enable)
+{
+    narrowing = enable;
+}
+
+inline void encoder::packing(packing::value value)
+{
+    policy = value;
+}
+
+inline void encoder::precision(bintoken::precision::value value)
+{
+    reduction = value;
+}
+
+inline void encoder::dictionary(bool enable)
+{
+    interning = enable;
+}
+
 template <typename T>
 encoder::size_type encoder::value()
 {
@@ -41,55 +138,55 @@ encoder::size_type encoder::value()
 template <>
 inline encoder::size_type encoder::value<token::null>()
 {
-    return write(token::null::code);
+    return commit(write(token::null::code));
 }
 
 template <>
 inline encoder::size_type encoder::value<token::begin_record>()
 {
-    return write(token::begin_record::code);
+    return begin_container(token::begin_record::code, token::code::begin_record32);
 }
 
 template <>
 inline encoder::size_type encoder::value<token::end_record>()
 {
-    return write(token::end_record::code);
+    return end_container(token::end_record::code);
 }
 
 template <>
 inline encoder::size_type encoder::value<token::begin_array>()
 {
-    return write(token::begin_array::code);
+    return begin_container(token::begin_array::code, token::code::begin_array32);
 }
 
 template <>
 inline encoder::size_type encoder::value<token::end_array>()
 {
-    return write(token::end_array::code);
+    return end_container(token::end_array::code);
 }
 
 template <>
 inline encoder::size_type encoder::value<token::begin_assoc_array>()
 {
-    return write(token::begin_assoc_array::code);
+    return begin_container(token::begin_assoc_array::code, token::code::begin_assoc_array32);
 }
 
 template <>
 inline encoder::size_type encoder::value<token::end_assoc_array>()
 {
-    return write(token::end_assoc_array::code);
+    return end_container(token::end_assoc_array::code);
 }
 
 inline encoder::size_type encoder::value(bool data)
 {
-    return write(data ? token::code::true_value : token::code::false_value);
+    return commit(write(data ? token::code::true_value : token::code::false_value));
 }
 
 inline encoder::size_type encoder::value(token::int8::type data)
 {
     if (data >= -32)
     {
-        return write(data);
+        return commit(write(data));
     }
     else
     {
@@ -99,7 +196,7 @@ inline encoder::size_type encoder::value(token::int8::type data)
         {
             buffer->write(token);
             buffer->write(data);
-            return size;
+            return commit(size);
         }
     }
     return 0;
@@ -109,11 +206,13 @@ inline encoder::size_type encoder::value(token::int16::type data)
 {
     const value_type token(token::int16::code);
     const size_type size = sizeof(token) + sizeof(std::int16_t);
+    if (compact && (sizeof(token) + varint::size(data) < size))
+        return write_varint(data);
     if (buffer->grow(size))
     {
         buffer->write(token);
         endian_write(data);
-        return size;
+        return commit(size);
     }
     return 0;
 }
@@ -122,11 +221,13 @@ inline encoder::size_type encoder::value(token::int32::type data)
 {
     const value_type token(token::int32::code);
     const size_type size = sizeof(token) + sizeof(std::int32_t);
+    if (compact && (sizeof(token) + varint::size(data) < size))
+        return write_varint(data);
     if (buffer->grow(size))
     {
         buffer->write(token);
         endian_write(data);
-        return size;
+        return commit(size);
     }
     return 0;
 }
@@ -135,11 +236,13 @@ inline encoder::size_type encoder::value(token::int64::type data)
 {
     const value_type token(token::int64::code);
     const size_type size = sizeof(token) + sizeof(std::int64_t);
+    if (compact && (sizeof(token) + varint::size(data) < size))
+        return write_varint(data);
     if (buffer->grow(size))
     {
         buffer->write(token);
         endian_write(data);
-        return size;
+        return commit(size);
     }
     return 0;
 }
@@ -153,7 +256,7 @@ inline encoder::size_type encoder::value(token::float32::type data)
     {
         buffer->write(token);
         endian_write(data);
-        return size;
+        return commit(size);
     }
     return 0;
 }
@@ -167,7 +270,7 @@ inline encoder::size_type encoder::value(token::float64::type data)
     {
         buffer->write(token);
         endian_write(data);
-        return size;
+        return commit(size);
     }
     return 0;
 }
@@ -177,6 +280,15 @@ inline encoder::size_type encoder::value(const string_view_type& data)
     const std::string::size_type length = data.size();
     size_type size = 0;
 
+    if (interning &&
+        (length > 0) &&
+        (length < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max())))
+    {
+        size = write_interned(data);
+        if (size > 0)
+            return size;
+    }
+
     if (length < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
         if (!buffer->grow(sizeof(value_type) + sizeof(std::uint8_t) + length))
@@ -208,7 +320,7 @@ inline encoder::size_type encoder::value(const string_view_type& data)
 
     buffer->write(view_type(reinterpret_cast<const value_type *>(data.data()),
                             data.size()));
-    return sizeof(value_type) + size + length;
+    return commit(sizeof(value_type) + size + length);
 }
 
 inline encoder::size_type encoder::value(const char *data,
@@ -222,10 +334,57 @@ inline encoder::size_type encoder::value(const char *data)
     return value(string_view_type(data));
 }
 
+inline encoder::size_type encoder::tensor(const std::uint32_t *extents,
+                                          size_type rank)
+{
+    assert(rank > 0 && rank <= std::numeric_limits<std::uint8_t>::max());
+
+    const size_type size = sizeof(value_type) + sizeof(std::uint8_t) + rank * sizeof(std::uint32_t);
+    if (!buffer->grow(size))
+        return 0;
+    buffer->write(token::code::tensor);
+    buffer->write(static_cast<value_type>(rank));
+    for (size_type i = 0; i < rank; ++i)
+    {
+        endian_write(extents[i]);
+    }
+    return commit(size);
+}
+
+inline encoder::size_type encoder::field(token::field::type tag)
+{
+    value_type output[sizeof(value_type) + varint::max_size];
+    output[0] = token::code::field;
+    const size_type size = sizeof(value_type) + varint::encode(&output[1], tag);
+    return commit(write(view_type(output, size)));
+}
+
+inline auto encoder::array(const bool *data,
+                           size_type length) -> size_type
+{
+    const size_type length_size = bitmap::size(length);
+    const size_type size = write_array_header(token::code::array8_bool, length_size);
+    if (size == 0)
+        return 0;
+
+    buffer->write(bitmap::unused(length));
+
+    // Pack in chunks to write fewer and larger spans
+    value_type output[256];
+    const size_type chunk = 8 * sizeof(output);
+    for (size_type i = 0; i < length; i += chunk)
+    {
+        const size_type count = std::min(chunk, length - i);
+        buffer->write(view_type(output, bitmap::pack(output, data + i, count)));
+    }
+    return commit(size + length_size);
+}
+
 inline auto encoder::array(const token::int8::type *data,
                            size_type length) -> size_type
 {
     size_type size = 0;
+    const size_type padding = write_padding(length);
 
     if (length < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
@@ -234,7 +393,7 @@ inline auto encoder::array(const token::int8::type *data,
         buffer->write(token::code::array8_int8);
         size = write_length(static_cast<std::uint8_t>(length));
         if (length == 0)
-            return sizeof(value_type) + size;
+            return commit(sizeof(value_type) + size);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
     {
@@ -259,14 +418,19 @@ inline auto encoder::array(const token::int8::type *data,
     }
 
     buffer->write(view_type(reinterpret_cast<const value_type *>(data), length));
-    return sizeof(value_type) + size + length;
+    return padding + commit(sizeof(value_type) + size + length);
 }
 
 inline auto encoder::array(const token::int16::type *data,
                            size_type length) -> size_type
 {
+    size_type result = 0;
+    if (pack_array(data, length, result))
+        return result;
+
     size_type size = 0;
     size_type length_size = length * sizeof(*data);
+    const size_type padding = write_padding(length_size);
 
     if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
@@ -275,7 +439,7 @@ inline auto encoder::array(const token::int16::type *data,
         buffer->write(token::code::array8_int16);
         size = write_length(static_cast<std::uint8_t>(length_size));
         if (length_size == 0)
-            return sizeof(value_type) + size;
+            return commit(sizeof(value_type) + size);
     }
     else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
     {
@@ -299,18 +463,20 @@ inline auto encoder::array(const token::int16::type *data,
         size = write_length(static_cast<std::uint64_t>(length_size));
     }
 
-    for (size_type i = 0; i < length; ++i)
-    {
-        endian_write(data[i]);
-    }
-    return sizeof(value_type) + size + length_size;
+    write_array(data, length);
+    return padding + commit(sizeof(value_type) + size + length_size);
 }
 
 inline auto encoder::array(const token::int32::type *data,
                            size_type length) -> size_type
 {
+    size_type result = 0;
+    if (pack_array(data, length, result))
+        return result;
+
     size_type size = 0;
     size_type length_size = length * sizeof(*data);
+    const size_type padding = write_padding(length_size);
 
     if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
@@ -319,7 +485,7 @@ inline auto encoder::array(const token::int32::type *data,
         buffer->write(token::code::array8_int32);
         size = write_length(static_cast<std::uint8_t>(length_size));
         if (length_size == 0)
-            return sizeof(value_type) + size;
+            return commit(sizeof(value_type) + size);
     }
     else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
     {
@@ -343,18 +509,20 @@ inline auto encoder::array(const token::int32::type *data,
         size = write_length(static_cast<std::uint64_t>(length_size));
     }
 
-    for (size_type i = 0; i < length; ++i)
-    {
-        endian_write(data[i]);
-    }
-    return sizeof(value_type) + size + length_size;
+    write_array(data, length);
+    return padding + commit(sizeof(value_type) + size + length_size);
 }
 
 inline auto encoder::array(const token::int64::type *data,
                            size_type length) -> size_type
 {
+    size_type result = 0;
+    if (pack_array(data, length, result))
+        return result;
+
     size_type size = 0;
     size_type length_size = length * sizeof(*data);
+    const size_type padding = write_padding(length_size);
 
     if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
@@ -363,7 +531,7 @@ inline auto encoder::array(const token::int64::type *data,
         buffer->write(token::code::array8_int64);
         size = write_length(static_cast<std::uint8_t>(length_size));
         if (length_size == 0)
-            return sizeof(value_type) + size;
+            return commit(sizeof(value_type) + size);
     }
     else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
     {
@@ -387,18 +555,20 @@ inline auto encoder::array(const token::int64::type *data,
         size = write_length(static_cast<std::uint64_t>(length_size));
     }
 
-    for (size_type i = 0; i < length; ++i)
-    {
-        endian_write(data[i]);
-    }
-    return sizeof(value_type) + size + length_size;
+    write_array(data, length);
+    return padding + commit(sizeof(value_type) + size + length_size);
 }
 
 inline auto encoder::array(const token::float32::type *data,
                            size_type length) -> size_type
 {
+    size_type result = 0;
+    if (reduce_array(data, length, result))
+        return result;
+
     size_type size = 0;
     size_type length_size = length * sizeof(*data);
+    const size_type padding = write_padding(length_size);
 
     if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
@@ -407,7 +577,7 @@ inline auto encoder::array(const token::float32::type *data,
         buffer->write(token::code::array8_float32);
         size = write_length(static_cast<std::uint8_t>(length_size));
         if (length_size == 0)
-            return sizeof(value_type) + size;
+            return commit(sizeof(value_type) + size);
     }
     else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
     {
@@ -431,18 +601,20 @@ inline auto encoder::array(const token::float32::type *data,
         size = write_length(static_cast<std::uint64_t>(length_size));
     }
 
-    for (size_type i = 0; i < length; ++i)
-    {
-        endian_write(data[i]);
-    }
-    return sizeof(value_type) + size + length_size;
+    write_array(data, length);
+    return padding + commit(sizeof(value_type) + size + length_size);
 }
 
 inline auto encoder::array(const token::float64::type *data,
                            size_type length) -> size_type
 {
+    size_type result = 0;
+    if (reduce_array(data, length, result))
+        return result;
+
     size_type size = 0;
     size_type length_size = length * sizeof(*data);
+    const size_type padding = write_padding(length_size);
 
     if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
     {
@@ -451,7 +623,7 @@ inline auto encoder::array(const token::float64::type *data,
         buffer->write(token::code::array8_float64);
         size = write_length(static_cast<std::uint8_t>(length_size));
         if (length_size == 0)
-            return sizeof(value_type) + size;
+            return commit(sizeof(value_type) + size);
     }
     else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
     {
@@ -475,11 +647,483 @@ inline auto encoder::array(const token::float64::type *data,
         size = write_length(static_cast<std::uint64_t>(length_size));
     }
 
+    write_array(data, length);
+    return padding + commit(sizeof(value_type) + size + length_size);
+}
+
+inline auto encoder::begin_container(token::code::value code,
+                                     token::code::value sized_code) -> size_type
+{
+    if (!prefix)
+    {
+        if (!frames.empty())
+        {
+            frames.push(std::numeric_limits<size_type>::max());
+        }
+        return commit(write(code));
+    }
+
+    if (frames.empty())
+    {
+        buffer = &scratch;
+    }
+    frames.push(scratch.data.size() + sizeof(value_type));
+    // The length is filled in by end_container()
+    const value_type header[] = { static_cast<value_type>(sized_code), 0x00, 0x00, 0x00, 0x00 };
+    return commit(write(view_type(header, sizeof(header))));
+}
+
+inline auto encoder::end_container(token::code::value code) -> size_type
+{
+    if (frames.empty())
+        return commit(write(code));
+
+    const size_type offset = frames.top();
+    frames.pop();
+    const size_type size = write(code);
+    if (offset != std::numeric_limits<size_type>::max())
+    {
+        const size_type length = scratch.data.size() - offset - sizeof(std::uint32_t);
+        if (length > std::numeric_limits<std::uint32_t>::max())
+            throw bintoken::error(overflow);
+        endian::write(&scratch.data[offset], static_cast<std::uint32_t>(length));
+    }
+
+    if (frames.empty())
+    {
+        // Outermost container closed so flush to output
+        buffer = sink;
+        const bool ok = buffer->grow(scratch.data.size());
+        if (ok)
+        {
+            buffer->write(view_type(scratch.data.data(), scratch.data.size()));
+        }
+        scratch.data.clear();
+        if (!ok)
+            return 0;
+    }
+    return commit(size);
+}
+
+inline encoder::size_type encoder::write_padding(size_type length_size)
+{
+    // Insert padding tokens so that the payload of the upcoming array token
+    // starts at a multiple of the alignment.
+    if ((alignment <= 1) || (length_size == 0))
+        return 0;
+
+    size_type header_size = sizeof(value_type);
+    if (length_size < static_cast<size_type>(std::numeric_limits<std::uint8_t>::max()))
+        header_size += sizeof(std::uint8_t);
+    else if (length_size < static_cast<size_type>(std::numeric_limits<std::uint16_t>::max()))
+        header_size += sizeof(std::uint16_t);
+    else if (length_size < static_cast<size_type>(std::numeric_limits<std::uint32_t>::max()))
+        header_size += sizeof(std::uint32_t);
+    else
+        header_size += sizeof(std::uint64_t);
+
+    const size_type remainder = (position + header_size) % alignment;
+    if (remainder == 0)
+        return 0;
+
+    const size_type size = alignment - remainder;
+    if (!buffer->grow(size))
+        return 0;
+    for (size_type i = 0; i < size; ++i)
+    {
+        buffer->write(token::code::padding);
+    }
+    return commit(size);
+}
+
+inline encoder::size_type encoder::write_varint(std::int64_t data)
+{
+    value_type output[sizeof(value_type) + varint::max_size];
+    output[0] = token::code::varint;
+    const size_type size = sizeof(value_type) + varint::encode(&output[1], data);
+    return commit(write(view_type(output, size)));
+}
+
+inline encoder::size_type encoder::write_interned(const string_view_type& data)
+{
+    // Returns zero if the string should be written without the dictionary
+    size_type result = 0;
+    auto where = strings.find(data);
+    if (where == strings.end())
+    {
+        if (strings.size() > std::numeric_limits<std::uint16_t>::max())
+            return 0;
+
+        // Definitions are written directly to the output, even inside
+        // length-prefixed containers, so that the reader sees them before
+        // any container that it may skip.
+        const value_type header[] = { static_cast<value_type>(token::code::string_define),
+                                      static_cast<value_type>(data.size()) };
+        if (!sink->grow(sizeof(header) + data.size()))
+            return 0;
+        sink->write(view_type(header, sizeof(header)));
+        sink->write(view_type(reinterpret_cast<const value_type *>(data.data()),
+                              data.size()));
+        result += commit(sizeof(header) + data.size());
+
+        string_storage.emplace_back(data.data(), data.size());
+        const auto& key = string_storage.back();
+        where = strings.emplace(string_view_type(key.data(), key.size()), strings.size()).first;
+    }
+
+    const size_type position = where->second;
+    if (position <= std::numeric_limits<std::uint8_t>::max())
+    {
+        const value_type output[] = { static_cast<value_type>(token::code::string_reference8),
+                                      static_cast<value_type>(position) };
+        return result + commit(write(view_type(output, sizeof(output))));
+    }
+    value_type output[sizeof(value_type) + sizeof(std::uint16_t)];
+    output[0] = token::code::string_reference16;
+    endian::write(&output[1], static_cast<std::uint16_t>(position));
+    return result + commit(write(view_type(output, sizeof(output))));
+}
+
+template <typename T>
+auto encoder::varint_size(const T *data, size_type length) -> size_type
+{
+    size_type result = 0;
+    for (size_type i = 0; i < length; ++i)
+    {
+        result += varint::size(data[i]);
+    }
+    return result;
+}
+
+template <typename T>
+bool encoder::pack_array(const T *data, size_type length, size_type& result)
+{
+    // Returns false if the array should be encoded with its own type
+    if (length == 0)
+        return false;
+
+    enum { use_fixed, use_narrow, use_varint, use_frame, use_delta } choice = use_fixed;
+    const size_type width = narrowing ? narrow_size(data, length) : sizeof(T);
+    size_type best = length * width;
+    if (width < sizeof(T))
+    {
+        choice = use_narrow;
+    }
+    if (compact)
+    {
+        const size_type encoded_size = varint_size(data, length);
+        if (encoded_size < best)
+        {
+            best = encoded_size;
+            choice = use_varint;
+        }
+    }
+    packed::header frame_header = {};
+    if ((policy == packing::frame_of_reference) || (policy == packing::automatic))
+    {
+        frame_header = packed_frame(data, length);
+        const size_type encoded_size = packed::header_size
+            + packed::size(length, frame_header.width);
+        if (encoded_size < best)
+        {
+            best = encoded_size;
+            choice = use_frame;
+        }
+    }
+    packed::header delta_header = {};
+    if ((policy == packing::delta) || (policy == packing::automatic))
+    {
+        delta_header = packed_delta(data, length);
+        const size_type encoded_size = packed::delta_header_size
+            + packed::size(length - 1, delta_header.width);
+        if (encoded_size < best)
+        {
+            best = encoded_size;
+            choice = use_delta;
+        }
+    }
+
+    switch (choice)
+    {
+    case use_narrow:
+        switch (width)
+        {
+        case token::int8::size:
+            result = write_narrow_array<token::int8::type>(token::code::array8_int8, data, length);
+            break;
+        case token::int16::size:
+            result = write_narrow_array<token::int16::type>(token::code::array8_int16, data, length);
+            break;
+        default:
+            result = write_narrow_array<token::int32::type>(token::code::array8_int32, data, length);
+            break;
+        }
+        return true;
+
+    case use_varint:
+        result = write_varint_array(data, length, best);
+        return true;
+
+    case use_frame:
+        result = write_packed_array(frame_header, data, best);
+        return true;
+
+    case use_delta:
+        result = write_packed_array(delta_header, data, best);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+template <typename T>
+auto encoder::packed_frame(const T *data, size_type length) -> packed::header
+{
+    std::int64_t low = data[0];
+    std::int64_t high = data[0];
+    for (size_type i = 1; i < length; ++i)
+    {
+        low = std::min<std::int64_t>(low, data[i]);
+        high = std::max<std::int64_t>(high, data[i]);
+    }
+    packed::header result;
+    result.mode = packed::mode::frame_of_reference;
+    result.count = length;
+    result.reference = static_cast<std::uint64_t>(low);
+    result.width = packed::width(static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low));
+    result.first = 0;
+    return result;
+}
+
+template <typename T>
+auto encoder::packed_delta(const T *data, size_type length) -> packed::header
+{
+    // Differences are calculated modulo 2^64 so that they cannot overflow
+    std::int64_t low = 0;
+    std::int64_t high = 0;
+    if (length > 1)
+    {
+        low = std::numeric_limits<std::int64_t>::max();
+        high = std::numeric_limits<std::int64_t>::min();
+    }
+    for (size_type i = 1; i < length; ++i)
+    {
+        const auto difference = static_cast<std::int64_t>(static_cast<std::uint64_t>(std::int64_t(data[i])) -
+                                                          static_cast<std::uint64_t>(std::int64_t(data[i - 1])));
+        low = std::min(low, difference);
+        high = std::max(high, difference);
+    }
+    packed::header result;
+    result.mode = packed::mode::delta;
+    result.count = length;
+    result.reference = static_cast<std::uint64_t>(low);
+    result.width = packed::width(static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low));
+    result.first = static_cast<std::uint64_t>(std::int64_t(data[0]));
+    return result;
+}
+
+template <typename T>
+auto encoder::write_packed_array(const packed::header& header,
+                                 const T *data,
+                                 size_type length_size) -> size_type
+{
+    const size_type size = write_array_header(token::code::array8_packed, length_size);
+    if (size == 0)
+        return 0;
+
+    value_type output[packed::block_size * sizeof(std::uint64_t)];
+    buffer->write(view_type(output, packed::write_header(output, header)));
+
+    // Values are packed a block at a time. The subtraction of the reference
+    // is an independent operation per element that the compiler can vectorize.
+    const size_type first = (header.mode == packed::mode::delta) ? 1 : 0;
+    std::uint64_t values[packed::block_size];
+    for (size_type i = first; i < header.count; i += packed::block_size)
+    {
+        const size_type count = std::min<size_type>(packed::block_size, header.count - i);
+        if (header.mode == packed::mode::delta)
+        {
+            for (size_type j = 0; j < count; ++j)
+            {
+                values[j] = static_cast<std::uint64_t>(std::int64_t(data[i + j])) -
+                    static_cast<std::uint64_t>(std::int64_t(data[i + j - 1])) -
+                    header.reference;
+            }
+        }
+        else
+        {
+            for (size_type j = 0; j < count; ++j)
+            {
+                values[j] = static_cast<std::uint64_t>(std::int64_t(data[i + j])) - header.reference;
+            }
+        }
+        buffer->write(view_type(output, packed::pack(output, values, count, header.width)));
+    }
+    return commit(size + length_size);
+}
+
+template <typename T>
+auto encoder::narrow_size(const T *data, size_type length) -> size_type
+{
+    // Branch-free scan so that the compiler can vectorize it
+    T low = 0;
+    T high = 0;
+    for (size_type i = 0; i < length; ++i)
+    {
+        low = std::min(low, data[i]);
+        high = std::max(high, data[i]);
+    }
+    if ((low >= std::numeric_limits<token::int8::type>::min()) &&
+        (high <= std::numeric_limits<token::int8::type>::max()))
+        return token::int8::size;
+    if ((low >= std::numeric_limits<token::int16::type>::min()) &&
+        (high <= std::numeric_limits<token::int16::type>::max()))
+        return token::int16::size;
+    if ((low >= std::numeric_limits<token::int32::type>::min()) &&
+        (high <= std::numeric_limits<token::int32::type>::max()))
+        return token::int32::size;
+    return token::int64::size;
+}
+
+template <typename Narrow, typename T>
+auto encoder::write_narrow_array(token::code::value code,
+                                 const T *data,
+                                 size_type length) -> size_type
+{
+    const size_type length_size = length * sizeof(Narrow);
+    const size_type padding = write_padding(length_size);
+    const size_type size = write_array_header(code, length_size);
+    if (size == 0)
+        return 0;
+
+    // Convert in chunks to write fewer and larger spans
+    Narrow output[256 / sizeof(Narrow)];
+    const size_type chunk = sizeof(output) / sizeof(Narrow);
+    for (size_type i = 0; i < length; i += chunk)
+    {
+        const size_type count = std::min(chunk, length - i);
+        for (size_type j = 0; j < count; ++j)
+        {
+            output[j] = static_cast<Narrow>(data[i + j]);
+        }
+        write_array(output, count);
+    }
+    return padding + commit(size + length_size);
+}
+
+template <typename T>
+auto encoder::write_varint_array(const T *data,
+                                 size_type length,
+                                 size_type length_size) -> size_type
+{
+    // The length is the number of bytes, so the number of elements must be
+    // found by scanning the payload.
+    const size_type size = write_array_header(token::code::array8_varint, length_size);
+    if (size == 0)
+        return 0;
+
+    // Encode in chunks to write fewer and larger spans
+    value_type output[256];
+    size_type used = 0;
     for (size_type i = 0; i < length; ++i)
     {
-        endian_write(data[i]);
+        if (used + varint::max_size > sizeof(output))
+        {
+            buffer->write(view_type(output, used));
+            used = 0;
+        }
+        used += varint::encode(&output[used], data[i]);
+    }
+    if (used > 0)
+    {
+        buffer->write(view_type(output, used));
     }
-    return sizeof(value_type) + size + length_size;
+    return commit(size + length_size);
+}
+
+template <typename T>
+bool encoder::reduce_array(const T *data, size_type length, size_type& result)
+{
+    // Returns false if the array should be encoded with its own type, which
+    // is also the case if the array is too long for the 16-bit formats.
+    if (length >= std::numeric_limits<std::uint32_t>::max() / sizeof(std::uint16_t))
+        return false;
+
+    switch (reduction)
+    {
+    case bintoken::precision::float16:
+        result = write_reduced_array<half::float16>(data, length);
+        return true;
+
+    case bintoken::precision::bfloat16:
+        result = write_reduced_array<half::bfloat16>(data, length);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+template <typename Format, typename T>
+auto encoder::write_reduced_array(const T *data,
+                                  size_type length) -> size_type
+{
+    const size_type length_size = length * sizeof(std::uint16_t);
+    const size_type padding = write_padding(length_size);
+    const size_type size = write_array_header(Format::code, length_size);
+    if (size == 0)
+        return 0;
+
+    // Convert in chunks to write fewer and larger spans
+    value_type output[256];
+    const size_type chunk = sizeof(output) / sizeof(std::uint16_t);
+    for (size_type i = 0; i < length; i += chunk)
+    {
+        const size_type count = std::min(chunk, length - i);
+        half::encode<Format>(output, data + i, count);
+        buffer->write(view_type(output, count * sizeof(std::uint16_t)));
+    }
+    return padding + commit(size + length_size);
+}
+
+inline auto encoder::write_array_header(token::code::value code,
+                                        size_type length_size) -> size_type
+{
+    // Writes the token and length of an array, and makes room for the
+    // payload. The length variants of an array token differ in the upper
+    // nibble, so code is the variant with an 8-bit length.
+    size_type size = 0;
+
+    if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint8_t>::max()))
+    {
+        if (!buffer->grow(sizeof(value_type) + sizeof(std::uint8_t) + length_size))
+            return 0;
+        buffer->write(code);
+        size = write_length(static_cast<std::uint8_t>(length_size));
+    }
+    else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint16_t>::max()))
+    {
+        if (!buffer->grow(sizeof(value_type) + sizeof(std::uint16_t) + length_size))
+            return 0;
+        buffer->write(static_cast<value_type>(code + 0x10));
+        size = write_length(static_cast<std::uint16_t>(length_size));
+    }
+    else if (length_size < static_cast<std::string::size_type>(std::numeric_limits<std::uint32_t>::max()))
+    {
+        if (!buffer->grow(sizeof(value_type) + sizeof(std::uint32_t) + length_size))
+            return 0;
+        buffer->write(static_cast<value_type>(code + 0x20));
+        size = write_length(static_cast<std::uint32_t>(length_size));
+    }
+    else
+    {
+        if (!buffer->grow(sizeof(value_type) + sizeof(std::uint64_t) + length_size))
+            return 0;
+        buffer->write(static_cast<value_type>(code + 0x30));
+        size = write_length(static_cast<std::uint64_t>(length_size));
+    }
+    return sizeof(value_type) + size;
 }
 
 inline encoder::size_type encoder::write_length(std::uint8_t data)
@@ -542,92 +1186,90 @@ inline encoder::size_type encoder::write(const view_type& data)
     return 0;
 }
 
+inline encoder::size_type encoder::commit(size_type size)
+{
+    position += size;
+    return size;
+}
+
+template <typename T>
+void encoder::write_array(const T *data, size_type length)
+{
+    if (endian::is_native)
+    {
+        buffer->write(view_type(reinterpret_cast<const value_type *>(data),
+                                length * sizeof(T)));
+    }
+    else
+    {
+        // Convert in chunks to write fewer and larger spans
+        value_type output[256];
+        const size_type chunk = sizeof(output) / sizeof(T);
+        while (length > 0)
+        {
+            const size_type count = std::min(length, chunk);
+            endian::write(output, data, count);
+            buffer->write(view_type(output, count * sizeof(T)));
+            data += count;
+            length -= count;
+        }
+    }
+}
+
 inline void encoder::endian_write(std::int16_t data)
 {
-    const std::uint16_t endian = UINT16_C(0x0100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(std::uint16_t data)
 {
-    const std::uint16_t endian = UINT16_C(0x0100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(std::int32_t data)
 {
-    const std::uint32_t endian = UINT32_C(0x03020100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[2]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[3]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(std::uint32_t data)
 {
-    const std::uint32_t endian = UINT32_C(0x03020100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[2]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[3]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(std::int64_t data)
 {
-    const std::uint64_t endian = UINT64_C(0x0706050403020100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[2]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[3]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[4]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[5]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[6]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[7]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(std::uint64_t data)
 {
-    const std::uint64_t endian = UINT64_C(0x0706050403020100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[2]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[3]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[4]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[5]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[6]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[7]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(token::float32::type data)
 {
-    const std::uint32_t endian = UINT32_C(0x03020100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[2]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[3]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 inline void encoder::endian_write(token::float64::type data)
 {
-    const std::uint64_t endian = UINT64_C(0x0706050403020100);
-    value_type *data_buffer = (value_type *)&data;
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[0]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[1]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[2]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[3]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[4]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[5]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[6]]));
-    buffer->write(static_cast<value_type>(data_buffer[((value_type *)&endian)[7]]));
+    value_type output[sizeof(data)];
+    endian::write(output, data);
+    buffer->write(view_type(output, sizeof(output)));
 }
 
 } // namespace detail
@@ -0,0 +1,161 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_ENDIAN_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_ENDIAN_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <boost/predef/other/endian.h>
+#if defined(_MSC_VER)
+# include <cstdlib>
+#endif
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+namespace endian
+{
+
+// The encoded format is little-endian. Conversion is a no-op on little-endian
+// hosts, and uses byte-swap intrinsics on big-endian hosts.
+
+#if BOOST_ENDIAN_LITTLE_BYTE
+const bool is_native = true;
+#else
+const bool is_native = false;
+#endif
+
+inline std::uint8_t byteswap(std::uint8_t value)
+{
+    return value;
+}
+
+inline std::uint16_t byteswap(std::uint16_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ushort(value);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap16(value);
+#else
+    return std::uint16_t((value << 8) | (value >> 8));
+#endif
+}
+
+inline std::uint32_t byteswap(std::uint32_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(value);
+#else
+    return ((value & UINT32_C(0x000000FF)) << 24)
+        | ((value & UINT32_C(0x0000FF00)) << 8)
+        | ((value & UINT32_C(0x00FF0000)) >> 8)
+        | ((value & UINT32_C(0xFF000000)) >> 24);
+#endif
+}
+
+inline std::uint64_t byteswap(std::uint64_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(value);
+#else
+    return (std::uint64_t(byteswap(std::uint32_t(value))) << 32)
+        | std::uint64_t(byteswap(std::uint32_t(value >> 32)));
+#endif
+}
+
+template <std::size_t N> struct unsigned_type;
+template <> struct unsigned_type<1> { using type = std::uint8_t; };
+template <> struct unsigned_type<2> { using type = std::uint16_t; };
+template <> struct unsigned_type<4> { using type = std::uint32_t; };
+template <> struct unsigned_type<8> { using type = std::uint64_t; };
+
+//! @brief Reads little-endian value from unaligned input.
+template <typename T>
+T read(const std::uint8_t *input)
+{
+    using bits_type = typename unsigned_type<sizeof(T)>::type;
+    bits_type bits;
+    std::memcpy(&bits, input, sizeof(bits));
+    if (!is_native)
+    {
+        bits = byteswap(bits);
+    }
+    T result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//! @brief Writes value as little-endian to unaligned output.
+template <typename T>
+void write(std::uint8_t *output, T value)
+{
+    using bits_type = typename unsigned_type<sizeof(T)>::type;
+    bits_type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (!is_native)
+    {
+        bits = byteswap(bits);
+    }
+    std::memcpy(output, &bits, sizeof(bits));
+}
+
+//! @brief Reads array of little-endian values from unaligned input.
+template <typename T>
+void read(T *output, const std::uint8_t *input, std::size_t count)
+{
+    if (is_native)
+    {
+        std::memcpy(output, input, count * sizeof(T));
+    }
+    else
+    {
+        // Simple loop that compilers can vectorize into byte shuffles
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            output[i] = read<T>(input + i * sizeof(T));
+        }
+    }
+}
+
+//! @brief Writes array of values as little-endian to unaligned output.
+template <typename T>
+void write(std::uint8_t *output, const T *input, std::size_t count)
+{
+    if (is_native)
+    {
+        std::memcpy(output, input, count * sizeof(T));
+    }
+    else
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            write<T>(output + i * sizeof(T), input[i]);
+        }
+    }
+}
+
+} // namespace endian
+} // namespace detail
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_ENDIAN_HPP
@@ -62,6 +62,9 @@ public:
 
         case expected_end_assoc_array:
             return "expected end assoc array bracket";
+
+        case truncated:
+            return "truncated input";
         }
         return "trial.protocol.bintoken error";
     }
@@ -0,0 +1,163 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_HALF_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_HALF_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <trial/protocol/bintoken/token.hpp>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+namespace half
+{
+
+// Conversion between float32 and 16-bit reals.
+//
+// The conversions select between precomputed alternatives instead of
+// branching, so the array loops below can be vectorized by the compiler.
+// Rounding is to nearest even. Wider reals are first rounded to float32.
+
+inline std::uint32_t bits(token::float32::type value)
+{
+    std::uint32_t result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+inline token::float32::type real(std::uint32_t value)
+{
+    token::float32::type result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+// IEEE 754 half precision: 1 sign bit, 5 exponent bits, 10 mantissa bits.
+struct float16
+{
+    static const token::code::value code = token::code::array8_float16;
+
+    static std::uint16_t encode(token::float32::type value)
+    {
+        const std::uint32_t infinity = 0x7F800000U;
+        // Smallest float32 that overflows to infinity
+        const std::uint32_t overflow = std::uint32_t(127 + 16) << 23;
+        // Smallest float32 that becomes a normal float16
+        const std::uint32_t normal = std::uint32_t(127 - 14) << 23;
+        // Adding 0.5 lets the floating-point unit round subnormals
+        const std::uint32_t magic = std::uint32_t(127 - 1) << 23;
+
+        std::uint32_t input = bits(value);
+        const std::uint32_t sign = input & 0x80000000U;
+        input ^= sign;
+
+        const std::uint32_t special = (input > infinity) ? 0x7E00U : 0x7C00U;
+        const std::uint32_t subnormal = bits(real(input) + real(magic)) - magic;
+        // Rebias the exponent and round the 13 discarded mantissa bits
+        const std::uint32_t rounded = (input
+                                       - (std::uint32_t(127 - 15) << 23)
+                                       + 0x0FFFU
+                                       + ((input >> 13) & 1)) >> 13;
+
+        const std::uint32_t result = (input >= overflow)
+            ? special
+            : ((input < normal) ? subnormal : rounded);
+        return static_cast<std::uint16_t>(result | (sign >> 16));
+    }
+
+    static token::float32::type decode(std::uint16_t value)
+    {
+        const std::uint32_t exponent_mask = std::uint32_t(0x7C00U) << 13;
+        const std::uint32_t magic = std::uint32_t(127 - 14) << 23;
+
+        const std::uint32_t shifted = std::uint32_t(value & 0x7FFFU) << 13;
+        const std::uint32_t exponent = shifted & exponent_mask;
+        const std::uint32_t rebiased = shifted + (std::uint32_t(127 - 15) << 23);
+
+        const std::uint32_t special = rebiased + (std::uint32_t(128 - 16) << 23);
+        const std::uint32_t subnormal = bits(real(rebiased + (std::uint32_t(1) << 23)) - real(magic));
+
+        const std::uint32_t result = (exponent == exponent_mask)
+            ? special
+            : ((exponent == 0) ? subnormal : rebiased);
+        return real(result | (std::uint32_t(value & 0x8000U) << 16));
+    }
+};
+
+// bfloat16: the upper half of a float32.
+struct bfloat16
+{
+    static const token::code::value code = token::code::array8_bfloat16;
+
+    static std::uint16_t encode(token::float32::type value)
+    {
+        const std::uint32_t input = bits(value);
+        const std::uint32_t rounded = (input + 0x7FFFU + ((input >> 16) & 1)) >> 16;
+        // NaN must stay NaN after truncation of the mantissa
+        const std::uint32_t quiet = (input >> 16) | 0x0040U;
+        const std::uint32_t result = ((input & 0x7FFFFFFFU) > 0x7F800000U) ? quiet : rounded;
+        return static_cast<std::uint16_t>(result);
+    }
+
+    static token::float32::type decode(std::uint16_t value)
+    {
+        return real(std::uint32_t(value) << 16);
+    }
+};
+
+//! @brief Converts reals to a little-endian 16-bit format.
+template <typename Format, typename T>
+void encode(std::uint8_t *output, const T *input, std::size_t count)
+{
+    std::uint16_t values[128];
+    for (std::size_t i = 0; i < count; i += 128)
+    {
+        const std::size_t size = std::min<std::size_t>(128, count - i);
+        for (std::size_t j = 0; j < size; ++j)
+        {
+            values[j] = Format::encode(static_cast<token::float32::type>(input[i + j]));
+        }
+        endian::write(output + i * sizeof(std::uint16_t), values, size);
+    }
+}
+
+//! @brief Converts a little-endian 16-bit format to reals.
+template <typename Format, typename T>
+void decode(T *output, const std::uint8_t *input, std::size_t count)
+{
+    std::uint16_t values[128];
+    for (std::size_t i = 0; i < count; i += 128)
+    {
+        const std::size_t size = std::min<std::size_t>(128, count - i);
+        endian::read(values, input + i * sizeof(std::uint16_t), size);
+        for (std::size_t j = 0; j < size; ++j)
+        {
+            output[i + j] = static_cast<T>(Format::decode(values[j]));
+        }
+    }
+}
+
+} // namespace half
+} // namespace detail
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_HALF_HPP
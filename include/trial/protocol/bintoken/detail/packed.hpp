@@ -0,0 +1,243 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_PACKED_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_PACKED_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+namespace packed
+{
+
+// The payload of a packed array starts with a header
+//
+//   mode      : uint8
+//   width     : uint8, number of bits per packed value (0 - 64)
+//   count     : uint64, number of elements
+//   reference : int64
+//   first     : int64, first element (delta mode only)
+//
+// followed by the packed values stored as a little-endian bit stream.
+//
+// With frame of reference, element i is reference + value[i].
+// With delta, element 0 is first and element i is element i-1 plus
+// reference + value[i-1]. All arithmetic is modulo 2^64.
+
+namespace mode
+{
+
+enum value
+{
+    frame_of_reference = 0,
+    delta = 1
+};
+
+} // namespace mode
+
+const std::size_t header_size = 2 + 2 * sizeof(std::uint64_t);
+const std::size_t delta_header_size = header_size + sizeof(std::uint64_t);
+
+// Values are packed and unpacked in blocks whose bit length is a multiple of
+// eight for all widths, so blocks always start on a byte boundary.
+const std::size_t block_size = 64;
+
+struct header
+{
+    packed::mode::value mode;
+    unsigned int width;
+    std::uint64_t count;
+    std::uint64_t reference;
+    std::uint64_t first;
+};
+
+//! @brief Returns the number of bits needed to represent range.
+inline unsigned int width(std::uint64_t range)
+{
+    unsigned int result = 0;
+    while (range != 0)
+    {
+        ++result;
+        range >>= 1;
+    }
+    return result;
+}
+
+//! @brief Returns the number of bytes needed for count values of width bits.
+inline std::size_t size(std::size_t count, unsigned int width)
+{
+    return (count / 8) * width + ((count % 8) * width + 7) / 8;
+}
+
+//! @brief Returns the number of packed values for count elements.
+inline std::size_t values(mode::value m, std::size_t count)
+{
+    return ((m == mode::delta) && (count > 0)) ? count - 1 : count;
+}
+
+inline std::size_t write_header(std::uint8_t *output, const header& data)
+{
+    output[0] = static_cast<std::uint8_t>(data.mode);
+    output[1] = static_cast<std::uint8_t>(data.width);
+    endian::write(&output[2], data.count);
+    endian::write(&output[10], data.reference);
+    if (data.mode == mode::delta)
+    {
+        endian::write(&output[header_size], data.first);
+        return delta_header_size;
+    }
+    return header_size;
+}
+
+//! @brief Reads and validates the header of a packed array payload.
+//!
+//! @returns False if the payload is malformed.
+inline bool read_header(const std::uint8_t *input, std::size_t input_size, header& result)
+{
+    if (input_size < header_size)
+        return false;
+    if (input[0] > mode::delta)
+        return false;
+    result.mode = static_cast<mode::value>(input[0]);
+    result.width = input[1];
+    if (result.width > 64)
+        return false;
+    result.count = endian::read<std::uint64_t>(&input[2]);
+    result.reference = endian::read<std::uint64_t>(&input[10]);
+    std::size_t expected = header_size;
+    if (result.mode == mode::delta)
+    {
+        if ((input_size < delta_header_size) || (result.count == 0))
+            return false;
+        result.first = endian::read<std::uint64_t>(&input[header_size]);
+        expected = delta_header_size;
+    }
+    // Guard against overflow of the bit length
+    if (result.count > std::numeric_limits<std::size_t>::max() / 64)
+        return false;
+    expected += size(values(result.mode, result.count), result.width);
+    return input_size == expected;
+}
+
+//! @brief Packs count values of width bits into output.
+//!
+//! @returns Number of bytes written.
+inline std::size_t pack(std::uint8_t *output,
+                        const std::uint64_t *input,
+                        std::size_t count,
+                        unsigned int width)
+{
+    if (width == 0)
+        return 0;
+
+    std::uint8_t *first = output;
+    std::uint64_t accumulator = 0;
+    unsigned int bits = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::uint64_t value = input[i];
+        accumulator |= value << bits;
+        bits += width;
+        if (bits >= 64)
+        {
+            endian::write(output, accumulator);
+            output += sizeof(accumulator);
+            bits -= 64;
+            accumulator = (bits > 0) ? value >> (width - bits) : 0;
+        }
+    }
+    for (; bits > 0; bits = (bits > 8) ? bits - 8 : 0)
+    {
+        *output++ = static_cast<std::uint8_t>(accumulator);
+        accumulator >>= 8;
+    }
+    return output - first;
+}
+
+//! @brief Unpacks count values of width bits from [input, input + input_size).
+//!
+//! Each value is extracted independently with an unaligned 64-bit load so
+//! that the loop has no carried dependency and can be vectorized.
+inline void unpack(const std::uint8_t *input,
+                   std::size_t input_size,
+                   std::uint64_t *output,
+                   std::size_t count,
+                   unsigned int width)
+{
+    if (width == 0)
+    {
+        std::fill(output, output + count, 0);
+        return;
+    }
+
+    const std::uint64_t mask = (width == 64)
+        ? std::numeric_limits<std::uint64_t>::max()
+        : (std::uint64_t(1) << width) - 1;
+
+    // Values whose 64-bit load window does not overrun the input
+    std::size_t safe = 0;
+    if (input_size >= sizeof(std::uint64_t) + 1)
+    {
+        safe = std::min(count, ((input_size - sizeof(std::uint64_t) - 1) * 8) / width + 1);
+    }
+
+    for (std::size_t i = 0; i < safe; ++i)
+    {
+        const std::size_t bit = i * width;
+        const std::uint8_t *cursor = input + bit / 8;
+        const unsigned int shift = bit % 8;
+        std::uint64_t value = endian::read<std::uint64_t>(cursor) >> shift;
+        if (shift + width > 64)
+        {
+            value |= std::uint64_t(cursor[sizeof(std::uint64_t)]) << (64 - shift);
+        }
+        output[i] = value & mask;
+    }
+
+    // Remaining values near the end of the input are read from a padded copy
+    if (safe < count)
+    {
+        const std::size_t offset = (safe * width) / 8;
+        std::uint8_t tail[2 * sizeof(std::uint64_t) + 1] = {};
+        std::memcpy(tail, input + offset, std::min(sizeof(tail), input_size - offset));
+        for (std::size_t i = safe; i < count; ++i)
+        {
+            const std::size_t bit = i * width - offset * 8;
+            const std::uint8_t *cursor = tail + bit / 8;
+            const unsigned int shift = bit % 8;
+            std::uint64_t value = endian::read<std::uint64_t>(cursor) >> shift;
+            if (shift + width > 64)
+            {
+                value |= std::uint64_t(cursor[sizeof(std::uint64_t)]) << (64 - shift);
+            }
+            output[i] = value & mask;
+        }
+    }
+}
+
+} // namespace packed
+} // namespace detail
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_PACKED_HPP
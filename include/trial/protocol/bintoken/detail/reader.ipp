@@ -13,10 +13,15 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdint> // std::uintptr_t
 #include <limits>
 #include <vector>
 #include <trial/protocol/core/detail/type_traits.hpp>
 #include <trial/protocol/bintoken/token.hpp>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+#include <trial/protocol/bintoken/detail/varint.hpp>
+#include <trial/protocol/bintoken/detail/packed.hpp>
+#include <trial/protocol/bintoken/detail/bitmap.hpp>
 
 namespace trial
 {
@@ -25,6 +30,126 @@ namespace protocol
 namespace bintoken
 {
 
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+// array_code
+//-----------------------------------------------------------------------------
+
+// The compact array token whose elements have the same representation as T.
+
+template <typename T, typename Enable = void>
+struct array_code
+{
+    static bool same(token::code::value)
+    {
+        return false;
+    }
+
+    static bool convertible(token::code::value)
+    {
+        return false;
+    }
+};
+
+template <token::code::value Code>
+struct basic_array_code
+{
+    // The four length variants of an array token differ in the upper nibble
+    static bool same(token::code::value code)
+    {
+        return (code == Code) ||
+            (code == Code + 0x10) ||
+            (code == Code + 0x20) ||
+            (code == Code + 0x30);
+    }
+
+    static bool convertible(token::code::value code)
+    {
+        return same(code);
+    }
+};
+
+template <token::code::value Code, std::size_t Size>
+struct basic_integer_array_code : basic_array_code<Code>
+{
+    // Integer arrays can also be decoded from narrower integers, from
+    // variable-length integers, and from packed integers
+    static bool convertible(token::code::value code)
+    {
+        return basic_array_code<token::code::array8_int8>::same(code) ||
+            ((Size >= token::int16::size) && basic_array_code<token::code::array8_int16>::same(code)) ||
+            ((Size >= token::int32::size) && basic_array_code<token::code::array8_int32>::same(code)) ||
+            ((Size >= token::int64::size) && basic_array_code<token::code::array8_int64>::same(code)) ||
+            basic_array_code<token::code::array8_varint>::same(code) ||
+            basic_array_code<token::code::array8_packed>::same(code);
+    }
+};
+
+template <typename T>
+struct array_code<
+    T,
+    typename std::enable_if<std::is_integral<T>::value &&
+                            !core::detail::is_bool<T>::value &&
+                            sizeof(T) == token::int8::size>::type>
+    : basic_integer_array_code<token::code::array8_int8, token::int8::size>
+{
+};
+
+template <typename T>
+struct array_code<
+    T,
+    typename std::enable_if<std::is_integral<T>::value &&
+                            sizeof(T) == token::int16::size>::type>
+    : basic_integer_array_code<token::code::array8_int16, token::int16::size>
+{
+};
+
+template <typename T>
+struct array_code<
+    T,
+    typename std::enable_if<std::is_integral<T>::value &&
+                            sizeof(T) == token::int32::size>::type>
+    : basic_integer_array_code<token::code::array8_int32, token::int32::size>
+{
+};
+
+template <typename T>
+struct array_code<
+    T,
+    typename std::enable_if<std::is_integral<T>::value &&
+                            sizeof(T) == token::int64::size>::type>
+    : basic_integer_array_code<token::code::array8_int64, token::int64::size>
+{
+};
+
+template <token::code::value Code>
+struct basic_real_array_code : basic_array_code<Code>
+{
+    // Real arrays can also be decoded from 16-bit reals
+    static bool convertible(token::code::value code)
+    {
+        return basic_array_code<Code>::same(code) ||
+            basic_array_code<token::code::array8_float16>::same(code) ||
+            basic_array_code<token::code::array8_bfloat16>::same(code);
+    }
+};
+
+template <>
+struct array_code<token::float32::type>
+    : basic_real_array_code<token::code::array8_float32>
+{
+};
+
+template <>
+struct array_code<token::float64::type>
+    : basic_real_array_code<token::code::array8_float64>
+{
+};
+
+} // namespace detail
+
 //-----------------------------------------------------------------------------
 // reader::overloader
 //-----------------------------------------------------------------------------
@@ -85,6 +210,14 @@ struct reader::overloader<bool>
             *output = convert(self);
             return size_type(1);
 
+        case token::code::array8_bool:
+        case token::code::array16_bool:
+        case token::code::array32_bool:
+        case token::code::array64_bool:
+            if (self.length() != output_length)
+                throw bintoken::error(overflow);
+            return self.decoder.array(output, output_length);
+
         default:
             throw bintoken::error(incompatible_type);
         }
@@ -141,6 +274,16 @@ struct reader::overloader<
                 return ReturnType(result);
             }
 
+        case token::varint::code:
+            {
+                token::varint::type result = self.decoder.value<token::varint>();
+                using widest_type = typename std::common_type<ReturnType, token::varint::type>::type;
+                if ((widest_type(result) > widest_type(std::numeric_limits<ReturnType>::max())) ||
+                    (widest_type(result) < widest_type(std::numeric_limits<ReturnType>::lowest())))
+                    throw bintoken::error(overflow);
+                return ReturnType(result);
+            }
+
         case token::float32::code:
             {
                 token::float32::type result = self.decoder.value<token::float32>();
@@ -182,7 +325,9 @@ struct reader::overloader<
         case token::code::array16_int8:
         case token::code::array32_int8:
         case token::code::array64_int8:
-            assert(sizeof(ReturnType) == token::int8::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int8::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(output, output_length);
@@ -191,7 +336,9 @@ struct reader::overloader<
         case token::code::array16_int16:
         case token::code::array32_int16:
         case token::code::array64_int16:
-            assert(sizeof(ReturnType) == token::int16::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int16::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(output, output_length);
@@ -200,7 +347,9 @@ struct reader::overloader<
         case token::code::array16_int32:
         case token::code::array32_int32:
         case token::code::array64_int32:
-            assert(sizeof(ReturnType) == token::int32::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int32::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(output, output_length);
@@ -209,7 +358,9 @@ struct reader::overloader<
         case token::code::array16_int64:
         case token::code::array32_int64:
         case token::code::array64_int64:
-            assert(sizeof(ReturnType) == token::int64::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int64::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(output, output_length);
@@ -232,6 +383,33 @@ struct reader::overloader<
                 throw bintoken::error(overflow);
             return self.decoder.array(output, output_length);
 
+        case token::code::array8_float16:
+        case token::code::array16_float16:
+        case token::code::array32_float16:
+        case token::code::array8_bfloat16:
+        case token::code::array16_bfloat16:
+        case token::code::array32_bfloat16:
+            // 16-bit reals are widened
+            if (!std::is_floating_point<ReturnType>::value)
+                throw bintoken::error(incompatible_type);
+            if (self.length() != output_length)
+                throw bintoken::error(overflow);
+            return self.decoder.array(output, output_length);
+
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
+            if (!std::is_integral<ReturnType>::value)
+                throw bintoken::error(incompatible_type);
+            if (self.length() != output_length)
+                throw bintoken::error(overflow);
+            return self.decoder.array(output, output_length);
+
         default:
             throw bintoken::error(incompatible_type);
         }
@@ -293,6 +471,25 @@ struct reader::overloader<
                 return ReturnType(wide);
             }
 
+        case token::varint::code:
+            {
+                // Negative numbers are interpreted as the two's complement
+                // bit pattern of the return type.
+                token::varint::type result = self.decoder.value<token::varint>();
+                using signed_type = typename std::make_signed<ReturnType>::type;
+                if (result < 0)
+                {
+                    if (result < std::numeric_limits<signed_type>::min())
+                        throw bintoken::error(overflow);
+                    return ReturnType(signed_type(result));
+                }
+                using unsigned_type = typename std::make_unsigned<token::varint::type>::type;
+                using widest_type = typename std::common_type<ReturnType, unsigned_type>::type;
+                if (widest_type(result) > widest_type(std::numeric_limits<ReturnType>::max()))
+                    throw bintoken::error(overflow);
+                return ReturnType(result);
+            }
+
         default:
             throw bintoken::error(invalid_value);
         }
@@ -308,7 +505,9 @@ struct reader::overloader<
         case token::code::array16_int8:
         case token::code::array32_int8:
         case token::code::array64_int8:
-            assert(sizeof(ReturnType) == token::int8::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int8::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(reinterpret_cast<typename std::make_signed<ReturnType>::type *>(output),
@@ -318,7 +517,9 @@ struct reader::overloader<
         case token::code::array16_int16:
         case token::code::array32_int16:
         case token::code::array64_int16:
-            assert(sizeof(ReturnType) == token::int16::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int16::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(reinterpret_cast<typename std::make_signed<ReturnType>::type *>(output),
@@ -328,7 +529,9 @@ struct reader::overloader<
         case token::code::array16_int32:
         case token::code::array32_int32:
         case token::code::array64_int32:
-            assert(sizeof(ReturnType) == token::int32::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int32::size))
+                throw bintoken::error(incompatible_type);
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(reinterpret_cast<typename std::make_signed<ReturnType>::type *>(output),
@@ -338,7 +541,22 @@ struct reader::overloader<
         case token::code::array16_int64:
         case token::code::array32_int64:
         case token::code::array64_int64:
-            assert(sizeof(ReturnType) == token::int64::size);
+            // Narrower integers are widened
+            if (!std::is_integral<ReturnType>::value || (sizeof(ReturnType) < token::int64::size))
+                throw bintoken::error(incompatible_type);
+            if (self.length() != output_length)
+                throw bintoken::error(overflow);
+            return self.decoder.array(reinterpret_cast<typename std::make_signed<ReturnType>::type *>(output),
+                                      output_length);
+
+        case token::code::array8_varint:
+        case token::code::array16_varint:
+        case token::code::array32_varint:
+        case token::code::array64_varint:
+        case token::code::array8_packed:
+        case token::code::array16_packed:
+        case token::code::array32_packed:
+        case token::code::array64_packed:
             if (self.length() != output_length)
                 throw bintoken::error(overflow);
             return self.decoder.array(reinterpret_cast<typename std::make_signed<ReturnType>::type *>(output),
@@ -379,14 +597,35 @@ struct reader::overloader<std::string>
 //-----------------------------------------------------------------------------
 
 inline reader::reader(view_type view)
-    : decoder(std::move(view))
+    : decoder(std::move(view)),
+      is_trusted(false),
+      depth(0)
 {
     stack.push(token::code::end);
 }
 
 template <typename T>
 reader::reader(const T& input)
-    : decoder(input)
+    : decoder(input),
+      is_trusted(false),
+      depth(0)
+{
+    stack.push(token::code::end);
+}
+
+inline reader::reader(view_type view, trusted_t)
+    : decoder(std::move(view), true),
+      is_trusted(true),
+      depth(0)
+{
+    stack.push(token::code::end);
+}
+
+template <typename T>
+reader::reader(const T& input, trusted_t)
+    : decoder(input, true),
+      is_trusted(true),
+      depth(0)
 {
     stack.push(token::code::end);
 }
@@ -427,6 +666,7 @@ inline auto reader::length() const -> size_type
     case token::code::int64:
     case token::code::float32:
     case token::code::float64:
+    case token::code::varint:
         return 1;
 
     case token::code::array8_int8:
@@ -465,6 +705,43 @@ inline auto reader::length() const -> size_type
     case token::code::array64_float64:
         return decoder.literal().size() / token::float64::size;
 
+    case token::code::array8_float16:
+    case token::code::array16_float16:
+    case token::code::array32_float16:
+    case token::code::array8_bfloat16:
+    case token::code::array16_bfloat16:
+    case token::code::array32_bfloat16:
+        return decoder.literal().size() / sizeof(std::uint16_t);
+
+    case token::code::array8_bool:
+    case token::code::array16_bool:
+    case token::code::array32_bool:
+    case token::code::array64_bool:
+        {
+            std::uint64_t count = 0;
+            if (!detail::bitmap::read_header(decoder.literal().data(), decoder.literal().size(), count))
+                throw bintoken::error(invalid_value);
+            return count;
+        }
+
+    case token::code::array8_varint:
+    case token::code::array16_varint:
+    case token::code::array32_varint:
+    case token::code::array64_varint:
+        return detail::varint::count(decoder.literal().data(),
+                                     decoder.literal().data() + decoder.literal().size());
+
+    case token::code::array8_packed:
+    case token::code::array16_packed:
+    case token::code::array32_packed:
+    case token::code::array64_packed:
+        {
+            detail::packed::header header;
+            if (!detail::packed::read_header(decoder.literal().data(), decoder.literal().size(), header))
+                throw bintoken::error(invalid_value);
+            return header.count;
+        }
+
     case token::code::string8:
     case token::code::string16:
     case token::code::string32:
@@ -479,11 +756,32 @@ inline auto reader::length() const -> size_type
 inline reader::size_type reader::level() const BOOST_NOEXCEPT
 {
     assert(stack.size() > 0);
-    return stack.size() - 1;
+    return is_trusted ? depth : stack.size() - 1;
+}
+
+inline auto reader::rank() const BOOST_NOEXCEPT -> size_type
+{
+    if (symbol() != token::symbol::array)
+        return 0;
+    const auto& shape = decoder.shape();
+    return shape.empty() ? 1 : shape.size() / sizeof(std::uint32_t);
+}
+
+inline auto reader::extent(size_type dimension) const -> size_type
+{
+    if (dimension >= rank())
+        throw bintoken::error(invalid_value);
+    const auto& shape = decoder.shape();
+    if (shape.empty())
+        return length();
+    return detail::endian::read<std::uint32_t>(shape.data() + dimension * sizeof(std::uint32_t));
 }
 
 inline bool reader::next() BOOST_NOEXCEPT
 {
+    if (is_trusted)
+        return next_trusted();
+
     const token::code::value current = decoder.code();
     switch (current)
     {
@@ -541,6 +839,32 @@ inline bool reader::next() BOOST_NOEXCEPT
     return (category() != token::category::status);
 }
 
+inline bool reader::next_trusted() BOOST_NOEXCEPT
+{
+    switch (decoder.code())
+    {
+    case token::code::begin_record:
+    case token::code::begin_array:
+    case token::code::begin_assoc_array:
+        ++depth;
+        break;
+
+    case token::code::end_record:
+    case token::code::end_array:
+    case token::code::end_assoc_array:
+        if (depth > 0)
+            --depth;
+        break;
+
+    default:
+        break;
+    }
+
+    decoder.next();
+    // Status codes precede all token codes
+    return (decoder.code() > token::code::error_truncated);
+}
+
 inline bool reader::next(token::code::value expect) BOOST_NOEXCEPT
 {
     const token::code::value current = decoder.code();
@@ -552,6 +876,83 @@ inline bool reader::next(token::code::value expect) BOOST_NOEXCEPT
     return next();
 }
 
+inline bool reader::skip() BOOST_NOEXCEPT
+{
+    switch (decoder.code())
+    {
+    case token::code::begin_record:
+        return skip(token::code::end_record, token::code::error_expected_end_record);
+
+    case token::code::begin_array:
+        return skip(token::code::end_array, token::code::error_expected_end_array);
+
+    case token::code::begin_assoc_array:
+        return skip(token::code::end_assoc_array, token::code::error_expected_end_assoc_array);
+
+    case token::code::field:
+        // Skip both the tag and the value
+        if (!next())
+            return false;
+        return skip();
+
+    default:
+        return next();
+    }
+}
+
+inline bool reader::find_field(token::field::type tag) BOOST_NOEXCEPT
+{
+    // Fields are ordered by tag, so the search stops at the first larger tag
+    while (decoder.code() == token::code::field)
+    {
+        const auto current = decoder.value<token::field>();
+        if (current == tag)
+            return next();
+        if (current > tag)
+            return false;
+        if (!skip())
+            return false;
+    }
+    return false;
+}
+
+inline bool reader::skip(token::code::value end_code,
+                         token::code::value error_code) BOOST_NOEXCEPT
+{
+    const auto& view = decoder.literal();
+    if (view.empty())
+    {
+        // Container without length prefix must be decoded token by token
+        const size_type depth = level();
+        do
+        {
+            next();
+            if (category() == token::category::status)
+            {
+                if (level() > depth)
+                {
+                    if (code() == token::code::end)
+                    {
+                        decoder.code(error_code);
+                    }
+                    return false;
+                }
+                break;
+            }
+        } while (level() > depth);
+    }
+    else
+    {
+        if (view.back() != end_code)
+        {
+            decoder.code(error_code);
+            return false;
+        }
+        decoder.skip();
+    }
+    return (category() != token::category::status);
+}
+
 template <typename ReturnType>
 typename token::type_cast<ReturnType>::type reader::value() const
 {
@@ -567,6 +968,31 @@ auto reader::array(T* output,
     return overloader<type>::convert(*this, output, output_length);
 }
 
+template <typename T>
+auto reader::array_view() const -> array_span<typename std::remove_const<T>::type>
+{
+    using type = typename std::remove_const<T>::type;
+
+    const bool is_same = detail::array_code<type>::same(code());
+    if ((symbol() == token::symbol::array) && !detail::array_code<type>::convertible(code()))
+        throw bintoken::error(incompatible_type);
+
+    if (detail::endian::is_native && is_same)
+    {
+        const auto& view = literal();
+        if (!view.empty() &&
+            (reinterpret_cast<std::uintptr_t>(view.data()) % alignof(type) == 0))
+        {
+            return array_span<type>(reinterpret_cast<const type *>(view.data()),
+                                    view.size() / sizeof(type));
+        }
+    }
+
+    std::vector<type> storage(length());
+    array(storage.data(), storage.size());
+    return array_span<type>(std::move(storage));
+}
+
 inline const reader::view_type& reader::literal() const BOOST_NOEXCEPT
 {
     return decoder.literal();
@@ -42,6 +42,7 @@ inline symbol::value symbol::convert(code::value value)
     case code::error_expected_end_record:
     case code::error_expected_end_array:
     case code::error_expected_end_assoc_array:
+    case code::error_truncated:
         return symbol::error;
 
     case code::null:
@@ -55,6 +56,7 @@ inline symbol::value symbol::convert(code::value value)
     case code::int16:
     case code::int32:
     case code::int64:
+    case code::varint:
         return symbol::integer;
 
     case code::float32:
@@ -91,25 +93,57 @@ inline symbol::value symbol::convert(code::value value)
     case code::array16_float64:
     case code::array32_float64:
     case code::array64_float64:
+    case code::array8_float16:
+    case code::array16_float16:
+    case code::array32_float16:
+    case code::array8_bfloat16:
+    case code::array16_bfloat16:
+    case code::array32_bfloat16:
+    case code::array8_bool:
+    case code::array16_bool:
+    case code::array32_bool:
+    case code::array64_bool:
+    case code::array8_varint:
+    case code::array16_varint:
+    case code::array32_varint:
+    case code::array64_varint:
+    case code::array8_packed:
+    case code::array16_packed:
+    case code::array32_packed:
+    case code::array64_packed:
         return symbol::array;
 
     case code::begin_record:
+    case code::begin_record32:
         return symbol::begin_record;
 
     case code::end_record:
         return symbol::end_record;
 
+    case code::field:
+        return symbol::field;
+
     case code::begin_array:
+    case code::begin_array32:
         return symbol::begin_array;
 
     case code::end_array:
         return symbol::end_array;
 
     case code::begin_assoc_array:
+    case code::begin_assoc_array32:
         return symbol::begin_assoc_array;
 
     case code::end_assoc_array:
         return symbol::end_assoc_array;
+
+    case code::padding:
+    case code::string_define:
+    case code::string_reference8:
+    case code::string_reference16:
+    case code::tensor:
+        // Never exposed by the decoder
+        break;
     }
     return symbol::error;
 }
@@ -134,6 +168,7 @@ inline category::value category::convert(symbol::value value)
 
     case symbol::begin_record:
     case symbol::end_record:
+    case symbol::field:
     case symbol::begin_array:
     case symbol::end_array:
     case symbol::begin_assoc_array:
@@ -230,6 +265,16 @@ inline bool float64::same(token::code::value v)
     return (v == code);
 }
 
+inline bool varint::same(token::code::value v)
+{
+    return (v == code);
+}
+
+inline bool field::same(token::code::value v)
+{
+    return (v == code);
+}
+
 inline bool string::same(token::code::value v)
 {
     switch (v)
@@ -373,6 +418,18 @@ struct is_tag<token::float64>
     static const bool value = true;
 };
 
+template <>
+struct is_tag<token::varint>
+{
+    static const bool value = true;
+};
+
+template <>
+struct is_tag<token::field>
+{
+    static const bool value = true;
+};
+
 template <>
 struct is_tag<token::string>
 {
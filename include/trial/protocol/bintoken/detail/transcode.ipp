@@ -0,0 +1,453 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_TRANSCODE_IPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_TRANSCODE_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <trial/protocol/core/detail/small_stack.hpp>
+#include <trial/protocol/bintoken/detail/endian.hpp>
+#include <trial/protocol/bintoken/detail/varint.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+// JSON to bintoken
+//-----------------------------------------------------------------------------
+
+template <typename CharT>
+class json_transcoder
+{
+public:
+    using reader_type = json::basic_reader<CharT>;
+
+    json_transcoder(reader_type& input,
+                    bintoken::writer& output,
+                    std::size_t lookahead)
+        : input(input),
+          output(output),
+          lookahead(lookahead)
+    {
+    }
+
+    void run()
+    {
+        const auto depth = input.level();
+        do
+        {
+            switch (input.symbol())
+            {
+            case json::token::symbol::end:
+                return;
+
+            case json::token::symbol::error:
+                throw json::error(input.error());
+
+            case json::token::symbol::null:
+                output.value<token::null>();
+                break;
+
+            case json::token::symbol::boolean:
+                output.value(input.template value<bool>());
+                break;
+
+            case json::token::symbol::integer:
+                output.value(input.template value<std::int64_t>());
+                break;
+
+            case json::token::symbol::real:
+                output.value(input.template value<double>());
+                break;
+
+            case json::token::symbol::string:
+                output.value(input.template value<std::string>());
+                break;
+
+            case json::token::symbol::begin_array:
+                // Positions the input at the next unprocessed token
+                begin_array();
+                continue;
+
+            case json::token::symbol::end_array:
+                output.value<token::end_array>();
+                break;
+
+            case json::token::symbol::begin_object:
+                output.value<token::begin_assoc_array>();
+                break;
+
+            case json::token::symbol::end_object:
+                output.value<token::end_assoc_array>();
+                break;
+            }
+            input.next();
+        } while (input.level() > depth);
+    }
+
+private:
+    void begin_array()
+    {
+        integers.clear();
+        reals.clear();
+        bool is_real = false;
+
+        input.next();
+        while (integers.size() + reals.size() < lookahead)
+        {
+            switch (input.symbol())
+            {
+            case json::token::symbol::integer:
+                {
+                    const auto value = input.template value<std::int64_t>();
+                    if (is_real)
+                    {
+                        if (!is_exact(value))
+                            return flush();
+                        reals.push_back(double(value));
+                    }
+                    else
+                    {
+                        integers.push_back(value);
+                    }
+                }
+                break;
+
+            case json::token::symbol::real:
+                if (!is_real)
+                {
+                    // Integers seen so far are converted if they can be
+                    // represented exactly
+                    for (auto value : integers)
+                    {
+                        if (!is_exact(value))
+                            return flush();
+                    }
+                    reals.assign(integers.begin(), integers.end());
+                    integers.clear();
+                    is_real = true;
+                }
+                reals.push_back(input.template value<double>());
+                break;
+
+            case json::token::symbol::end_array:
+                if (is_real)
+                {
+                    output.array(reals.data(), reals.size());
+                }
+                else if (!integers.empty())
+                {
+                    output.array(integers.data(), integers.size());
+                }
+                else
+                {
+                    output.value<token::begin_array>();
+                    output.value<token::end_array>();
+                }
+                input.next();
+                return;
+
+            default:
+                return flush();
+            }
+            input.next();
+        }
+        flush();
+    }
+
+    void flush()
+    {
+        // The array is written element by element from here on
+        output.value<token::begin_array>();
+        for (auto value : integers)
+        {
+            output.value(value);
+        }
+        for (auto value : reals)
+        {
+            output.value(value);
+        }
+    }
+
+    static bool is_exact(std::int64_t value)
+    {
+        // Integers with up to 53 significant bits are exact as doubles
+        const std::int64_t limit = std::int64_t(1) << 53;
+        return (value <= limit) && (value >= -limit);
+    }
+
+private:
+    reader_type& input;
+    bintoken::writer& output;
+    const std::size_t lookahead;
+    std::vector<std::int64_t> integers;
+    std::vector<double> reals;
+};
+
+//-----------------------------------------------------------------------------
+// Bintoken to JSON
+//-----------------------------------------------------------------------------
+
+template <typename CharT, std::size_t N>
+class bintoken_transcoder
+{
+public:
+    using writer_type = json::basic_writer<CharT, N>;
+
+    bintoken_transcoder(bintoken::reader& input,
+                        writer_type& output)
+        : input(input),
+          output(output)
+    {
+    }
+
+    void run()
+    {
+        const auto depth = input.level();
+        do
+        {
+            const auto symbol = input.symbol();
+            if (!scope.empty() && scope.top().is_object && scope.top().expect_key)
+            {
+                switch (symbol)
+                {
+                case token::symbol::string:
+                case token::symbol::end_assoc_array:
+                case token::symbol::end:
+                case token::symbol::error:
+                    break;
+
+                default:
+                    throw bintoken::error(incompatible_type);
+                }
+            }
+
+            switch (symbol)
+            {
+            case token::symbol::end:
+                if (input.level() > depth)
+                    throw bintoken::error(unexpected_token);
+                return;
+
+            case token::symbol::error:
+                throw bintoken::error(input.error());
+
+            case token::symbol::null:
+                advance();
+                output.template value<json::token::null>();
+                break;
+
+            case token::symbol::boolean:
+                advance();
+                output.value(input.value<bool>());
+                break;
+
+            case token::symbol::integer:
+                advance();
+                output.value(input.value<std::int64_t>());
+                break;
+
+            case token::symbol::real:
+                advance();
+                output.value(input.value<double>());
+                break;
+
+            case token::symbol::string:
+                advance();
+                output.value(input.value<std::string>());
+                break;
+
+            case token::symbol::array:
+                advance();
+                array();
+                break;
+
+            case token::symbol::begin_record:
+            case token::symbol::begin_array:
+                advance();
+                output.template value<json::token::begin_array>();
+                scope.push(frame{ false, false });
+                break;
+
+            case token::symbol::begin_assoc_array:
+                advance();
+                output.template value<json::token::begin_object>();
+                scope.push(frame{ true, true });
+                break;
+
+            case token::symbol::end_record:
+            case token::symbol::end_array:
+                output.template value<json::token::end_array>();
+                scope.pop();
+                break;
+
+            case token::symbol::field:
+                // Field tags have no JSON counterpart
+                break;
+
+            case token::symbol::end_assoc_array:
+                // Keys and values must be paired
+                if (!scope.top().expect_key)
+                    throw bintoken::error(invalid_value);
+                output.template value<json::token::end_object>();
+                scope.pop();
+                break;
+            }
+            input.next();
+        } while (input.level() > depth);
+    }
+
+private:
+    struct frame
+    {
+        bool is_object;
+        bool expect_key;
+    };
+
+    void advance()
+    {
+        // Alternate between keys and values in associative arrays
+        if (!scope.empty() && scope.top().is_object)
+        {
+            scope.top().expect_key = !scope.top().expect_key;
+        }
+    }
+
+    void array()
+    {
+        output.template value<json::token::begin_array>();
+        const auto& view = input.literal();
+        const auto code = input.code();
+        if (basic_array_code<token::code::array8_int8>::same(code))
+        {
+            elements<token::int8::type>(view);
+        }
+        else if (basic_array_code<token::code::array8_int16>::same(code))
+        {
+            elements<token::int16::type>(view);
+        }
+        else if (basic_array_code<token::code::array8_int32>::same(code))
+        {
+            elements<token::int32::type>(view);
+        }
+        else if (basic_array_code<token::code::array8_int64>::same(code))
+        {
+            elements<token::int64::type>(view);
+        }
+        else if (basic_array_code<token::code::array8_float32>::same(code))
+        {
+            elements<token::float32::type>(view);
+        }
+        else if (basic_array_code<token::code::array8_float64>::same(code))
+        {
+            elements<token::float64::type>(view);
+        }
+        else if (basic_array_code<token::code::array8_varint>::same(code))
+        {
+            auto first = view.data();
+            const auto last = first + view.size();
+            while (first != last)
+            {
+                std::int64_t value = 0;
+                first = varint::decode(first, last, value);
+                if (!first)
+                    throw bintoken::error(invalid_value);
+                output.value(value);
+            }
+        }
+        else if (basic_array_code<token::code::array8_bool>::same(code))
+        {
+            std::unique_ptr<bool[]> values(new bool[input.length()]);
+            const auto size = input.array(values.get(), input.length());
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                output.value(values[i]);
+            }
+        }
+        else if ((code == token::code::array8_float16) ||
+                 (code == token::code::array16_float16) ||
+                 (code == token::code::array32_float16) ||
+                 (code == token::code::array8_bfloat16) ||
+                 (code == token::code::array16_bfloat16) ||
+                 (code == token::code::array32_bfloat16))
+        {
+            // 16-bit reals are widened before conversion
+            const auto span = input.array_view<double>();
+            for (auto value : span)
+            {
+                output.value(value);
+            }
+        }
+        else
+        {
+            // Packed arrays are expanded before conversion
+            const auto span = input.array_view<std::int64_t>();
+            for (auto value : span)
+            {
+                output.value(value);
+            }
+        }
+        output.template value<json::token::end_array>();
+    }
+
+    template <typename T>
+    void elements(const bintoken::reader::view_type& view)
+    {
+        // Widen elements so that int8 is not written as a character
+        using widen_type = typename std::conditional<std::is_integral<T>::value,
+                                                     std::int64_t,
+                                                     double>::type;
+        const auto size = view.size() / sizeof(T);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            output.value(widen_type(endian::read<T>(view.data() + i * sizeof(T))));
+        }
+    }
+
+private:
+    bintoken::reader& input;
+    writer_type& output;
+    core::detail::small_stack<frame, 16> scope;
+};
+
+} // namespace detail
+
+template <typename CharT>
+void transcode(json::basic_reader<CharT>& input,
+               bintoken::writer& output,
+               std::size_t lookahead)
+{
+    detail::json_transcoder<CharT> transcoder(input, output, lookahead);
+    transcoder.run();
+}
+
+template <typename CharT, std::size_t N>
+void transcode(bintoken::reader& input,
+               json::basic_writer<CharT, N>& output)
+{
+    detail::bintoken_transcoder<CharT, N> transcoder(input, output);
+    transcoder.run();
+}
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_TRANSCODE_IPP
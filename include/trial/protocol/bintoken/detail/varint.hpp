@@ -0,0 +1,118 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_DETAIL_VARINT_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_DETAIL_VARINT_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace detail
+{
+namespace varint
+{
+
+// Signed integers are zigzag encoded, so that numbers with a small magnitude
+// have a small encoding, and then stored as LEB128 with 7 bits per byte and
+// the high bit set on all but the last byte.
+
+const std::size_t max_size = 10;
+
+inline std::uint64_t zigzag_encode(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t zigzag_decode(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+//! @brief Returns the number of bytes needed to encode value.
+inline std::size_t size(std::int64_t value)
+{
+    std::uint64_t bits = zigzag_encode(value);
+    std::size_t result = 1;
+    while (bits >= 0x80)
+    {
+        bits >>= 7;
+        ++result;
+    }
+    return result;
+}
+
+//! @brief Encodes value into output, which must have room for max_size bytes.
+//!
+//! @returns Number of bytes written.
+inline std::size_t encode(std::uint8_t *output, std::int64_t value)
+{
+    std::uint64_t bits = zigzag_encode(value);
+    std::size_t result = 0;
+    while (bits >= 0x80)
+    {
+        output[result++] = static_cast<std::uint8_t>(bits | 0x80);
+        bits >>= 7;
+    }
+    output[result++] = static_cast<std::uint8_t>(bits);
+    return result;
+}
+
+//! @brief Decodes a value from [first, last).
+//!
+//! @returns Pointer past the decoded value, or nullptr if the input is
+//! truncated or the encoding is too long.
+inline const std::uint8_t *decode(const std::uint8_t *first,
+                                  const std::uint8_t *last,
+                                  std::int64_t& value)
+{
+    std::uint64_t bits = 0;
+    unsigned int shift = 0;
+    while (first != last)
+    {
+        const std::uint8_t byte = *first++;
+        bits |= std::uint64_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            value = zigzag_decode(bits);
+            return first;
+        }
+        shift += 7;
+        if (shift >= 7 * max_size)
+            break;
+    }
+    return nullptr;
+}
+
+//! @brief Returns the number of encoded values in [first, last).
+inline std::size_t count(const std::uint8_t *first,
+                         const std::uint8_t *last)
+{
+    // Every value ends with a byte whose high bit is clear
+    std::size_t result = 0;
+    for (; first != last; ++first)
+    {
+        result += ((*first & 0x80) == 0);
+    }
+    return result;
+}
+
+} // namespace varint
+} // namespace detail
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_DETAIL_VARINT_HPP
@@ -44,6 +44,11 @@ struct writer::overloader<bool>
     {
         return self.encoder.value(data);
     }
+
+    static size_type array(writer& self, const bool *data, size_type size)
+    {
+        return self.encoder.array(data, size);
+    }
 };
 
 template <typename T>
@@ -264,6 +269,49 @@ writer::writer(T& buffer)
     stack.push(token::code::end_array);
 }
 
+template <typename T>
+void writer::reset(T& buffer)
+{
+    encoder.reset(buffer);
+    stack.clear();
+    stack.push(token::code::end_array);
+}
+
+inline void writer::align(size_type size)
+{
+    encoder.align(size);
+}
+
+inline void writer::length_prefix(bool enable)
+{
+    encoder.length_prefix(enable);
+}
+
+inline void writer::varint(bool enable)
+{
+    encoder.varint(enable);
+}
+
+inline void writer::narrow(bool enable)
+{
+    encoder.narrow(enable);
+}
+
+inline void writer::packing(packing::value policy)
+{
+    encoder.packing(policy);
+}
+
+inline void writer::precision(bintoken::precision::value policy)
+{
+    encoder.precision(policy);
+}
+
+inline void writer::dictionary(bool enable)
+{
+    encoder.dictionary(enable);
+}
+
 template <typename T>
 writer::size_type writer::value(const T& data)
 {
@@ -282,6 +330,35 @@ auto writer::array(const T *data, size_type size) -> size_type
     return overloader<T>::array(*this, data, size);
 }
 
+template <typename T>
+auto writer::tensor(const T *data,
+                    const size_type *extents,
+                    size_type rank) -> size_type
+{
+    if ((rank == 0) || (rank > std::numeric_limits<std::uint8_t>::max()))
+        throw bintoken::error(invalid_value);
+
+    std::uint32_t shape[std::numeric_limits<std::uint8_t>::max()];
+    size_type size = 1;
+    for (size_type i = 0; i < rank; ++i)
+    {
+        if (extents[i] > std::numeric_limits<std::uint32_t>::max())
+            throw bintoken::error(invalid_value);
+        shape[i] = static_cast<std::uint32_t>(extents[i]);
+        size *= extents[i];
+    }
+    const size_type header = encoder.tensor(shape, rank);
+    if (header == 0)
+        return 0;
+    return header + overloader<T>::array(*this, data, size);
+}
+
+inline auto writer::field(token::field::type tag) -> size_type
+{
+    validate_scope(token::code::end_record, unexpected_token);
+    return encoder.field(tag);
+}
+
 inline void writer::validate_scope(token::code::value code,
                                    enum bintoken::errc e)
 {
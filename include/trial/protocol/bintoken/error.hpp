@@ -35,7 +35,8 @@ enum errc
     incompatible_type,
     expected_end_record,
     expected_end_array,
-    expected_end_assoc_array
+    expected_end_assoc_array,
+    truncated
 };
 
 inline enum errc to_errc(token::code::value value)
@@ -66,6 +67,9 @@ inline enum errc to_errc(token::code::value value)
     case token::code::error_expected_end_assoc_array:
         return expected_end_assoc_array;
 
+    case token::code::error_truncated:
+        return truncated;
+
     default:
         return no_error;
     }
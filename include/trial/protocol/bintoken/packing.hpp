@@ -0,0 +1,45 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_PACKING_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_PACKING_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace packing
+{
+
+//! @brief Policy for encoding integer arrays as bit-packed arrays.
+//!
+//! A packed array is only used if it is smaller than the other encodings.
+
+enum value
+{
+    //! Never pack arrays (the default.)
+    none,
+    //! Pack the difference from the smallest element.
+    frame_of_reference,
+    //! Pack the difference between consecutive elements.
+    //! Suitable for timestamps and other monotonic sequences.
+    delta,
+    //! Use whichever of the above is smallest.
+    automatic
+};
+
+} // namespace packing
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_PACKING_HPP
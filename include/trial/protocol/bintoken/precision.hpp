@@ -0,0 +1,44 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_PRECISION_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_PRECISION_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+namespace precision
+{
+
+//! @brief Policy for encoding floating-point arrays with 16-bit elements.
+//!
+//! Reduced precision is lossy. Elements are rounded to nearest even, and
+//! elements beyond the range of the format become infinity.
+
+enum value
+{
+    //! Keep the precision of the elements (the default.)
+    full,
+    //! IEEE 754 half precision with 11 significant bits and a largest
+    //! finite value of 65504.
+    float16,
+    //! bfloat16 with 8 significant bits and the range of float32.
+    bfloat16
+};
+
+} // namespace precision
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_PRECISION_HPP
@@ -12,8 +12,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cstddef> // std::size_t
-#include <stack>
+#include <trial/protocol/core/detail/small_stack.hpp>
 #include <trial/protocol/bintoken/error.hpp>
+#include <trial/protocol/bintoken/array_span.hpp>
 #include <trial/protocol/bintoken/detail/decoder.hpp>
 
 namespace trial
@@ -23,6 +24,10 @@ namespace protocol
 namespace bintoken
 {
 
+//! @brief Tag for readers of trusted input.
+struct trusted_t {};
+const trusted_t trusted = trusted_t();
+
 class reader
 {
 public:
@@ -33,10 +38,40 @@ public:
     reader(view_type);
     template <typename T> reader(const T&);
 
+    //! @brief Construct a reader for trusted input.
+    //!
+    //! Intended for input that has been written by bintoken::writer and whose
+    //! integrity is ensured by other means, such as a checksum. Tokens are
+    //! framed with a dispatch table and their length fields only. The nesting
+    //! of containers is not validated, so level() is only tracked as a depth
+    //! counter, and malformed input yields unspecified tokens. The reader never
+    //! reads beyond the end of the input.
+    reader(view_type, trusted_t);
+    template <typename T> reader(const T&, trusted_t);
+
     //! @brief Advance to the next token.
     bool next() BOOST_NOEXCEPT;
     bool next(token::code::value) BOOST_NOEXCEPT;
 
+    //! @brief Advance past the current value.
+    //!
+    //! If the current token begins a container, then the entire container is
+    //! skipped. This takes constant time if the container was encoded with a
+    //! length prefix.
+    bool skip() BOOST_NOEXCEPT;
+
+    //! @brief Advance to the value of a tagged record field.
+    //!
+    //! Fields in the current record must be written in ascending tag order.
+    //! Fields with smaller tags are skipped with skip() until a field with the
+    //! given tag is found. The search starts at the current field token, and
+    //! stops at a larger tag or at the end of the record, where the reader is
+    //! left so that subsequent fields can be searched for.
+    //!
+    //! @returns true if the field was found, in which case the value of the
+    //! field becomes the current token.
+    bool find_field(token::field::type tag) BOOST_NOEXCEPT;
+
     //! @brief Returns the current token.
     token::code::value code() const BOOST_NOEXCEPT;
 
@@ -57,6 +92,19 @@ public:
     //! @brief Returns the current nesting level.
     size_type level() const BOOST_NOEXCEPT;
 
+    //! @brief Returns the number of dimensions of the current array.
+    //!
+    //! Arrays preceded by a shape have the rank of the shape, and other
+    //! arrays have rank 1. Other tokens have rank 0.
+    size_type rank() const BOOST_NOEXCEPT;
+
+    //! @brief Returns the extent of a dimension of the current array.
+    //!
+    //! The extent of an array without a shape is its length.
+    //!
+    //! @throws system_error if dimension is not less than rank().
+    size_type extent(size_type dimension) const;
+
     //! @brief Return the current value.
     //!
     //! @throws system_error if requested type is incompatible with the current token.
@@ -72,17 +120,36 @@ public:
     template <typename T>
     size_type array(T* output, size_type output_length) const;
 
+    //! @brief Return a view of the current array value.
+    //!
+    //! The view aliases the input buffer without copying if the host uses
+    //! the same byte order as the encoding, and the array payload is suitably
+    //! aligned for T. Otherwise the values are copied into the view.
+    //!
+    //! @throws system_error if requested type is incompatible with the current token.
+    template <typename T>
+    array_span<typename std::remove_const<T>::type> array_view() const;
+
     //! @brief Return a view of the current value before it is converted into its type.
     const view_type& literal() const BOOST_NOEXCEPT;
 
     //! @returns A view of the remaining buffer.
     const view_type& tail() const BOOST_NOEXCEPT;
 
+private:
+    friend class chunked_reader;
+
+    bool skip(token::code::value, token::code::value) BOOST_NOEXCEPT;
+    bool next_trusted() BOOST_NOEXCEPT;
+
 private:
     template <typename ReturnType, typename Enable = void> struct overloader;
 
     mutable detail::decoder decoder;
-    std::stack<token::code::value> stack;
+    core::detail::small_stack<token::code::value, 16> stack;
+    // Nesting level of trusted readers, which do not use the stack
+    bool is_trusted;
+    size_type depth;
 };
 
 } // namespace bintoken
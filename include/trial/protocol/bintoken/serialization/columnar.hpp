@@ -0,0 +1,305 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_COLUMNAR_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_COLUMNAR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/serialization/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/std/string.hpp>
+#include <trial/protocol/bintoken/serialization/std/vector.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+//! @brief Wrapper that serializes a vector of records column by column.
+//!
+//! Use columnar() to create the wrapper.
+template <typename Container>
+class columnar_wrapper
+{
+public:
+    explicit columnar_wrapper(Container& data)
+        : data(data)
+    {
+    }
+
+    Container& get() const
+    {
+        return data;
+    }
+
+private:
+    Container& data;
+};
+
+//! @brief Serialize a vector of records as columns.
+//!
+//! The fields of the records are described by their serialize() function,
+//! which must only apply operator& (or operator<< and operator>>) to the
+//! fields, and must visit the same fields in the same order for all records.
+//! The records must be default constructible.
+//!
+//! The vector is encoded as a record that contains the number of rows
+//! followed by one vector per field. The field vectors are encoded with the
+//! normal std::vector serialization, so arithmetic fields become compact
+//! arrays.
+//!
+//! @code
+//! std::vector<point> points;
+//! archive << bintoken::columnar(points);
+//! @endcode
+template <typename T, typename Allocator>
+const columnar_wrapper<std::vector<T, Allocator>> columnar(std::vector<T, Allocator>& data)
+{
+    return columnar_wrapper<std::vector<T, Allocator>>(data);
+}
+
+template <typename T, typename Allocator>
+const columnar_wrapper<const std::vector<T, Allocator>> columnar(const std::vector<T, Allocator>& data)
+{
+    return columnar_wrapper<const std::vector<T, Allocator>>(data);
+}
+
+namespace detail
+{
+
+template <typename T>
+struct column_tag
+{
+    static const char id;
+};
+
+template <typename T>
+const char column_tag<T>::id = 0;
+
+class column_base
+{
+public:
+    virtual ~column_base() {}
+
+    virtual const void *type() const = 0;
+    virtual std::size_t size() const = 0;
+    virtual void save(oarchive&, unsigned int) const = 0;
+    virtual void load(iarchive&, unsigned int) = 0;
+};
+
+template <typename T>
+class column : public column_base
+{
+public:
+    const void *type() const override
+    {
+        return &column_tag<T>::id;
+    }
+
+    std::size_t size() const override
+    {
+        return values.size();
+    }
+
+    void save(oarchive& ar, unsigned int protocol_version) const override
+    {
+        ar.save_override(values, protocol_version);
+    }
+
+    void load(iarchive& ar, unsigned int protocol_version) override
+    {
+        ar.load_override(values, protocol_version);
+    }
+
+    std::vector<T> values;
+};
+
+// Archive that visits the fields of a record and connects them with columns
+class column_archive
+{
+public:
+    enum mode
+    {
+        describe,
+        gather,
+        scatter
+    };
+
+    using columns_type = std::vector<std::unique_ptr<column_base>>;
+
+    column_archive(columns_type& columns, mode action)
+        : columns(columns),
+          action(action),
+          index(0),
+          row(0)
+    {
+    }
+
+    template <typename T>
+    void visit(T& data, std::size_t position, unsigned int protocol_version)
+    {
+        index = 0;
+        row = position;
+        boost::serialization::serialize_adl(*this, data, protocol_version);
+        if (index != columns.size())
+            throw bintoken::error(bintoken::incompatible_type);
+    }
+
+    template <typename T>
+    column_archive& operator& (T& field)
+    {
+        using value_type = typename std::remove_const<T>::type;
+
+        if (action == describe)
+        {
+            columns.emplace_back(new column<value_type>());
+        }
+        if ((index >= columns.size()) || (columns[index]->type() != &column_tag<value_type>::id))
+            throw bintoken::error(bintoken::incompatible_type);
+        auto& current = static_cast<column<value_type>&>(*columns[index]);
+        ++index;
+
+        switch (action)
+        {
+        case describe:
+            break;
+        case gather:
+            current.values.push_back(field);
+            break;
+        case scatter:
+            const_cast<value_type&>(field) = std::move(current.values[row]);
+            break;
+        }
+        return *this;
+    }
+
+    template <typename T>
+    column_archive& operator<< (const T& field)
+    {
+        return *this & field;
+    }
+
+    template <typename T>
+    column_archive& operator>> (T& field)
+    {
+        return *this & field;
+    }
+
+private:
+    columns_type& columns;
+    const mode action;
+    std::size_t index;
+    std::size_t row;
+};
+
+template <typename T, typename Allocator>
+void save_columns(oarchive& ar,
+                  const std::vector<T, Allocator>& data,
+                  const unsigned int protocol_version)
+{
+    column_archive::columns_type columns;
+    T prototype;
+    column_archive(columns, column_archive::describe).visit(prototype, 0, protocol_version);
+
+    column_archive gatherer(columns, column_archive::gather);
+    for (std::size_t row = 0; row < data.size(); ++row)
+    {
+        gatherer.visit(const_cast<T&>(data[row]), row, protocol_version);
+    }
+
+    ar.save<token::begin_record>();
+    ar.save<std::size_t>(data.size());
+    for (const auto& current : columns)
+    {
+        current->save(ar, protocol_version);
+    }
+    ar.save<token::end_record>();
+}
+
+template <typename T, typename Allocator>
+void load_columns(iarchive& ar,
+                  std::vector<T, Allocator>& data,
+                  const unsigned int protocol_version)
+{
+    column_archive::columns_type columns;
+    T prototype;
+    column_archive(columns, column_archive::describe).visit(prototype, 0, protocol_version);
+
+    ar.load<token::begin_record>();
+    std::size_t count;
+    ar.load_override(count, protocol_version);
+    for (const auto& current : columns)
+    {
+        current->load(ar, protocol_version);
+        if (current->size() != count)
+            throw bintoken::error(bintoken::invalid_value);
+    }
+    if (!ar.at<token::end_record>())
+        throw bintoken::error(bintoken::expected_end_record);
+    ar.load<token::end_record>();
+
+    data.resize(count);
+    column_archive scatterer(columns, column_archive::scatter);
+    for (std::size_t row = 0; row < count; ++row)
+    {
+        scatterer.visit(data[row], row, protocol_version);
+    }
+}
+
+} // namespace detail
+} // namespace bintoken
+
+namespace serialization
+{
+
+template <typename Container>
+struct save_overloader< bintoken::oarchive,
+                        bintoken::columnar_wrapper<Container> >
+{
+    static void save(bintoken::oarchive& ar,
+                     const bintoken::columnar_wrapper<Container>& data,
+                     const unsigned int protocol_version)
+    {
+        bintoken::detail::save_columns(ar, data.get(), protocol_version);
+    }
+};
+
+template <typename Container>
+struct load_overloader< bintoken::iarchive,
+                        bintoken::columnar_wrapper<Container> >
+{
+    static void load(bintoken::iarchive& ar,
+                     const bintoken::columnar_wrapper<Container>& data,
+                     const unsigned int protocol_version)
+    {
+        bintoken::detail::load_columns(ar, data.get(), protocol_version);
+    }
+};
+
+// The wrapper is passed as a const temporary
+template <typename Container>
+struct load_overloader< bintoken::iarchive,
+                        const bintoken::columnar_wrapper<Container> >
+    : load_overloader< bintoken::iarchive,
+                       bintoken::columnar_wrapper<Container> >
+{
+};
+
+} // namespace serialization
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_COLUMNAR_HPP
@@ -73,9 +73,7 @@ struct load_overloader< bintoken::iarchive,
 
         for (std::size_t i = 0; i < N; ++i)
         {
-            T value;
-            ar >> value;
-            data[i] = value;
+            ar >> data[i];
         }
         if (!ar.at<bintoken::token::end_array>())
             throw bintoken::error(bintoken::expected_end_array);
@@ -106,6 +104,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -136,6 +135,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -166,6 +166,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -196,6 +197,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -226,6 +228,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -256,6 +259,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -286,6 +290,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -316,6 +321,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -339,6 +345,13 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_float32:
         case bintoken::token::code::array32_float32:
         case bintoken::token::code::array64_float32:
+            // 16-bit reals are widened
+        case bintoken::token::code::array8_float16:
+        case bintoken::token::code::array16_float16:
+        case bintoken::token::code::array32_float16:
+        case bintoken::token::code::array8_bfloat16:
+        case bintoken::token::code::array16_bfloat16:
+        case bintoken::token::code::array32_bfloat16:
             {
                 const auto length = ar.length();
                 if (length > N)
@@ -346,6 +359,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -369,6 +383,13 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_float64:
         case bintoken::token::code::array32_float64:
         case bintoken::token::code::array64_float64:
+            // 16-bit reals are widened
+        case bintoken::token::code::array8_float16:
+        case bintoken::token::code::array16_float16:
+        case bintoken::token::code::array32_float16:
+        case bintoken::token::code::array8_bfloat16:
+        case bintoken::token::code::array16_bfloat16:
+        case bintoken::token::code::array32_bfloat16:
             {
                 const auto length = ar.length();
                 if (length > N)
@@ -376,6 +397,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data, length);
+                ar.next();
             }
             break;
 
@@ -0,0 +1,371 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_DETAIL_BULK_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_DETAIL_BULK_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+#include <trial/protocol/core/detail/type_traits.hpp>
+#include <trial/protocol/bintoken/serialization/serialization.hpp>
+
+//-----------------------------------------------------------------------------
+// Bulk encoding of contiguous sequences
+//
+// Sequences of elements without a dedicated compact array overloader are
+// saved as a single compact array instead of element by element:
+//
+//   - Arithmetic elements are saved as a typed array of the same size and
+//     signedness.
+//   - Booleans are saved as a bit-packed array.
+//   - std::pair of arithmetic elements is saved as a record with one typed
+//     array for the first elements and another for the second elements.
+//   - Classes declared with BOOST_IS_BITWISE_SERIALIZABLE are saved as an
+//     int8 array with the raw bytes of the elements in host byte order and
+//     layout.
+//
+// Loading also accepts the element-by-element encoding, except for bitwise
+// serializable classes which need not be serializable element by element.
+//-----------------------------------------------------------------------------
+
+namespace trial
+{
+namespace protocol
+{
+namespace serialization
+{
+namespace detail
+{
+
+template <std::size_t N, bool Signed> struct bulk_integer;
+template <> struct bulk_integer<1, true> { using type = std::int8_t; };
+template <> struct bulk_integer<1, false> { using type = std::uint8_t; };
+template <> struct bulk_integer<2, true> { using type = std::int16_t; };
+template <> struct bulk_integer<2, false> { using type = std::uint16_t; };
+template <> struct bulk_integer<4, true> { using type = std::int32_t; };
+template <> struct bulk_integer<4, false> { using type = std::uint32_t; };
+template <> struct bulk_integer<8, true> { using type = std::int64_t; };
+template <> struct bulk_integer<8, false> { using type = std::uint64_t; };
+
+// Element type of the typed array that an arithmetic type is saved as
+
+template <typename T, typename Enable = void>
+struct bulk_storage
+{
+    static const bool value = false;
+};
+
+template <typename T>
+struct bulk_storage<
+    T,
+    typename std::enable_if<core::detail::is_bool<T>::value>::type>
+{
+    static const bool value = true;
+    using type = std::int8_t;
+};
+
+template <typename T>
+struct bulk_storage<
+    T,
+    typename std::enable_if<std::is_integral<T>::value &&
+                            !core::detail::is_bool<T>::value>::type>
+{
+    static const bool value = true;
+    using type = typename bulk_integer<sizeof(T), std::is_signed<T>::value>::type;
+};
+
+template <typename T>
+struct bulk_storage<
+    T,
+    typename std::enable_if<std::is_floating_point<T>::value &&
+                            sizeof(T) == sizeof(bintoken::token::float32::type)>::type>
+{
+    static const bool value = true;
+    using type = bintoken::token::float32::type;
+};
+
+template <typename T>
+struct bulk_storage<
+    T,
+    typename std::enable_if<std::is_floating_point<T>::value &&
+                            sizeof(T) == sizeof(bintoken::token::float64::type)>::type>
+{
+    static const bool value = true;
+    using type = bintoken::token::float64::type;
+};
+
+template <typename T>
+struct is_pair : std::false_type {};
+
+template <typename T1, typename T2>
+struct is_pair<std::pair<T1, T2>> : std::true_type {};
+
+//-----------------------------------------------------------------------------
+
+template <typename T, typename Enable = void>
+struct bulk
+{
+    static const bool value = false;
+    static const bool elementwise = true;
+};
+
+template <typename T>
+struct bulk<
+    T,
+    typename std::enable_if<bulk_storage<T>::value &&
+                            !core::detail::is_bool<T>::value>::type>
+{
+    static const bool value = true;
+    static const bool elementwise = true;
+    using storage_type = typename bulk_storage<T>::type;
+
+    template <typename Iterator>
+    static void save(bintoken::oarchive& ar, Iterator first, std::size_t size)
+    {
+        std::vector<storage_type> buffer;
+        buffer.reserve(size);
+        for (std::size_t i = 0; i < size; ++i, ++first)
+        {
+            buffer.push_back(static_cast<storage_type>(*first));
+        }
+        ar.save_array(buffer.data(), buffer.size());
+    }
+
+    static bool accept(const bintoken::iarchive& ar)
+    {
+        return ar.symbol() == bintoken::token::symbol::array;
+    }
+
+    template <typename Allocator>
+    static void load(bintoken::iarchive& ar, std::vector<T, Allocator>& data)
+    {
+        const auto view = ar.array_view<storage_type>();
+        data.assign(view.begin(), view.end());
+        ar.next();
+    }
+
+    static void load(bintoken::iarchive& ar, T *data, std::size_t size)
+    {
+        const auto view = ar.array_view<storage_type>();
+        if (view.size() > size)
+            throw bintoken::error(bintoken::overflow);
+        std::copy(view.begin(), view.end(), data);
+        ar.next();
+    }
+};
+
+template <>
+struct bulk<bool>
+{
+    static const bool value = true;
+    static const bool elementwise = true;
+
+    template <typename Iterator>
+    static void save(bintoken::oarchive& ar, Iterator first, std::size_t size)
+    {
+        // Also used for std::vector<bool> which does not store bool
+        std::unique_ptr<bool[]> buffer(new bool[size]);
+        for (std::size_t i = 0; i < size; ++i, ++first)
+        {
+            buffer[i] = *first;
+        }
+        ar.save_array(buffer.get(), size);
+    }
+
+    static bool accept(const bintoken::iarchive& ar)
+    {
+        return ar.symbol() == bintoken::token::symbol::array;
+    }
+
+    template <typename Allocator>
+    static void load(bintoken::iarchive& ar, std::vector<bool, Allocator>& data)
+    {
+        if (is_packed(ar))
+        {
+            const auto size = ar.length();
+            std::unique_ptr<bool[]> buffer(new bool[size]);
+            ar.load_array(buffer.get(), size);
+            data.assign(buffer.get(), buffer.get() + size);
+        }
+        else
+        {
+            const auto view = ar.array_view<std::int8_t>();
+            data.assign(view.begin(), view.end());
+        }
+        ar.next();
+    }
+
+    static void load(bintoken::iarchive& ar, bool *data, std::size_t size)
+    {
+        if (is_packed(ar))
+        {
+            const auto length = ar.length();
+            if (length > size)
+                throw bintoken::error(bintoken::overflow);
+            ar.load_array(data, length);
+        }
+        else
+        {
+            const auto view = ar.array_view<std::int8_t>();
+            if (view.size() > size)
+                throw bintoken::error(bintoken::overflow);
+            std::copy(view.begin(), view.end(), data);
+        }
+        ar.next();
+    }
+
+private:
+    // Booleans were formerly saved as int8 arrays
+    static bool is_packed(const bintoken::iarchive& ar)
+    {
+        return bintoken::detail::basic_array_code<bintoken::token::code::array8_bool>::same(ar.code());
+    }
+};
+
+template <typename T1, typename T2>
+struct bulk<
+    std::pair<T1, T2>,
+    typename std::enable_if<bulk_storage<T1>::value && bulk_storage<T2>::value>::type>
+{
+    static const bool value = true;
+    static const bool elementwise = true;
+    using first_type = typename bulk_storage<T1>::type;
+    using second_type = typename bulk_storage<T2>::type;
+
+    static void save(bintoken::oarchive& ar, const std::pair<T1, T2> *data, std::size_t size)
+    {
+        std::vector<first_type> first;
+        first.reserve(size);
+        std::vector<second_type> second;
+        second.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            first.push_back(static_cast<first_type>(data[i].first));
+            second.push_back(static_cast<second_type>(data[i].second));
+        }
+        ar.save<bintoken::token::begin_record>();
+        ar.save_array(first.data(), first.size());
+        ar.save_array(second.data(), second.size());
+        ar.save<bintoken::token::end_record>();
+    }
+
+    static bool accept(const bintoken::iarchive& ar)
+    {
+        return ar.at<bintoken::token::begin_record>();
+    }
+
+    template <typename Allocator>
+    static void load(bintoken::iarchive& ar, std::vector<std::pair<T1, T2>, Allocator>& data)
+    {
+        ar.load<bintoken::token::begin_record>();
+        const auto first = ar.array_view<first_type>();
+        ar.next();
+        const auto second = ar.array_view<second_type>();
+        ar.next();
+        if (second.size() != first.size())
+            throw bintoken::error(bintoken::invalid_value);
+        if (!ar.at<bintoken::token::end_record>())
+            throw bintoken::error(bintoken::expected_end_record);
+        ar.load<bintoken::token::end_record>();
+
+        data.clear();
+        data.reserve(first.size());
+        for (std::size_t i = 0; i < first.size(); ++i)
+        {
+            data.emplace_back(static_cast<T1>(first[i]), static_cast<T2>(second[i]));
+        }
+    }
+
+    static void load(bintoken::iarchive& ar, std::pair<T1, T2> *data, std::size_t size)
+    {
+        ar.load<bintoken::token::begin_record>();
+        const auto first = ar.array_view<first_type>();
+        ar.next();
+        const auto second = ar.array_view<second_type>();
+        ar.next();
+        if (second.size() != first.size())
+            throw bintoken::error(bintoken::invalid_value);
+        if (first.size() > size)
+            throw bintoken::error(bintoken::overflow);
+        if (!ar.at<bintoken::token::end_record>())
+            throw bintoken::error(bintoken::expected_end_record);
+        ar.load<bintoken::token::end_record>();
+
+        for (std::size_t i = 0; i < first.size(); ++i)
+        {
+            data[i].first = static_cast<T1>(first[i]);
+            data[i].second = static_cast<T2>(second[i]);
+        }
+    }
+};
+
+template <typename T>
+struct bulk<
+    T,
+    typename std::enable_if<std::is_class<T>::value &&
+                            !is_pair<T>::value &&
+                            boost::serialization::is_bitwise_serializable<T>::value>::type>
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Bitwise serializable type must be trivially copyable");
+
+    static const bool value = true;
+    static const bool elementwise = false;
+
+    static void save(bintoken::oarchive& ar, const T *data, std::size_t size)
+    {
+        ar.save_array(reinterpret_cast<const std::int8_t *>(data), size * sizeof(T));
+    }
+
+    static bool accept(const bintoken::iarchive& ar)
+    {
+        return ar.symbol() == bintoken::token::symbol::array;
+    }
+
+    template <typename Allocator>
+    static void load(bintoken::iarchive& ar, std::vector<T, Allocator>& data)
+    {
+        const auto view = ar.array_view<std::uint8_t>();
+        if (view.size() % sizeof(T) != 0)
+            throw bintoken::error(bintoken::invalid_value);
+        data.resize(view.size() / sizeof(T));
+        if (!view.empty())
+        {
+            std::memcpy(data.data(), view.data(), view.size());
+        }
+        ar.next();
+    }
+
+    static void load(bintoken::iarchive& ar, T *data, std::size_t size)
+    {
+        const auto view = ar.array_view<std::uint8_t>();
+        if (view.size() % sizeof(T) != 0)
+            throw bintoken::error(bintoken::invalid_value);
+        if (view.size() > size * sizeof(T))
+            throw bintoken::error(bintoken::overflow);
+        if (!view.empty())
+        {
+            std::memcpy(data, view.data(), view.size());
+        }
+        ar.next();
+    }
+};
+
+} // namespace detail
+} // namespace serialization
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_DETAIL_BULK_HPP
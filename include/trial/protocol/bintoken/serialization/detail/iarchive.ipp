@@ -26,6 +26,12 @@ iarchive::iarchive(const T& input)
 {
 }
 
+template <typename T>
+iarchive::iarchive(const T& input, trusted_t)
+    : reader(input, trusted)
+{
+}
+
 template <typename T>
 void iarchive::load_override(T& data)
 {
@@ -59,6 +65,12 @@ void iarchive::load_array(T *data, std::size_t size)
     reader.array(data, size);
 }
 
+template <typename T>
+array_span<T> iarchive::array_view() const
+{
+    return reader.array_view<T>();
+}
+
 template <typename Tag>
 void iarchive::load()
 {
@@ -93,6 +105,16 @@ inline auto iarchive::length() const -> size_type
     return reader.length();
 }
 
+inline auto iarchive::rank() const -> size_type
+{
+    return reader.rank();
+}
+
+inline auto iarchive::extent(size_type dimension) const -> size_type
+{
+    return reader.extent(dimension);
+}
+
 inline void iarchive::next()
 {
     if (!reader.next() && (reader.symbol() == token::symbol::error))
@@ -109,6 +131,28 @@ inline void iarchive::next(token::code::value expect)
     }
 }
 
+inline bool iarchive::find_field(token::field::type tag)
+{
+    if (reader.find_field(tag))
+        return true;
+    if (reader.symbol() == token::symbol::error)
+    {
+        throw bintoken::error(reader.error());
+    }
+    return false;
+}
+
+inline void iarchive::skip_fields()
+{
+    while (reader.code() == token::code::field)
+    {
+        if (!reader.skip() && (reader.symbol() == token::symbol::error))
+        {
+            throw bintoken::error(reader.error());
+        }
+    }
+}
+
 } // namespace bintoken
 } // namespace protocol
 } // namespace trial
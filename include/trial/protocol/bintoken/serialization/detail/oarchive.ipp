@@ -26,6 +26,31 @@ oarchive::oarchive(T& buffer)
 {
 }
 
+inline void oarchive::packing(bintoken::packing::value policy)
+{
+    writer.packing(policy);
+}
+
+inline void oarchive::precision(bintoken::precision::value policy)
+{
+    writer.precision(policy);
+}
+
+inline void oarchive::dictionary(bool enable)
+{
+    writer.dictionary(enable);
+}
+
+inline void oarchive::length_prefix(bool enable)
+{
+    writer.length_prefix(enable);
+}
+
+inline void oarchive::field(token::field::type tag)
+{
+    writer.field(tag);
+}
+
 template <typename T>
 inline void oarchive::save_override(const T& data)
 {
@@ -58,6 +83,12 @@ void oarchive::save_array(const T *data, std::size_t size)
     writer.array(data, size);
 }
 
+template <typename T>
+void oarchive::save_tensor(const T *data, const std::size_t *extents, std::size_t rank)
+{
+    writer.tensor(data, extents, rank);
+}
+
 } // namespace bintoken
 } // namespace protocol
 } // namespace trial
@@ -0,0 +1,118 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_FIELD_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_FIELD_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <trial/protocol/bintoken/serialization/serialization.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+//! @brief Wrapper that serializes a record member as a tagged field.
+//!
+//! Use field() to create the wrapper.
+template <typename T>
+class field_wrapper
+{
+public:
+    field_wrapper(token::field::type tag, T& data)
+        : tag_(tag),
+          data(data)
+    {
+    }
+
+    token::field::type tag() const
+    {
+        return tag_;
+    }
+
+    T& get() const
+    {
+        return data;
+    }
+
+private:
+    token::field::type tag_;
+    T& data;
+};
+
+//! @brief Serialize a record member as a tagged field.
+//!
+//! The value is preceded by a field tag. Members must be serialized in
+//! ascending tag order. When loading, fields with unknown tags are skipped,
+//! and the member is left unchanged if the record does not contain the tag.
+//! Fields can therefore be added or removed without breaking older readers.
+//!
+//! @code
+//! template <typename T>
+//! void serialize(T& archive, const unsigned int)
+//! {
+//!     archive & bintoken::field(1, name);
+//!     archive & bintoken::field(2, age);
+//! }
+//! @endcode
+template <typename T>
+const field_wrapper<T> field(token::field::type tag, T& data)
+{
+    return field_wrapper<T>(tag, data);
+}
+
+} // namespace bintoken
+
+namespace serialization
+{
+
+template <typename T>
+struct save_overloader< bintoken::oarchive,
+                        bintoken::field_wrapper<T> >
+{
+    static void save(bintoken::oarchive& ar,
+                     const bintoken::field_wrapper<T>& data,
+                     const unsigned int protocol_version)
+    {
+        ar.field(data.tag());
+        ar.save_override(data.get(), protocol_version);
+    }
+};
+
+template <typename T>
+struct load_overloader< bintoken::iarchive,
+                        bintoken::field_wrapper<T> >
+{
+    static void load(bintoken::iarchive& ar,
+                     const bintoken::field_wrapper<T>& data,
+                     const unsigned int protocol_version)
+    {
+        if (ar.find_field(data.tag()))
+        {
+            ar.load_override(data.get(), protocol_version);
+        }
+    }
+};
+
+// The wrapper is passed as a const temporary
+template <typename T>
+struct load_overloader< bintoken::iarchive,
+                        const bintoken::field_wrapper<T> >
+    : load_overloader< bintoken::iarchive,
+                       bintoken::field_wrapper<T> >
+{
+};
+
+} // namespace serialization
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_FIELD_HPP
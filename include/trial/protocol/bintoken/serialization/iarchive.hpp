@@ -36,6 +36,12 @@ public:
     template <typename T>
     iarchive(const T&);
 
+    //! @brief Construct an archive for trusted input.
+    //!
+    //! @sa reader::reader(view_type, trusted_t)
+    template <typename T>
+    iarchive(const T&, trusted_t);
+
     template <typename T>
     void load_override(T& data);
 
@@ -50,6 +56,9 @@ public:
     template <typename T>
     void load_array(T *data, size_type size);
 
+    template <typename T>
+    array_span<T> array_view() const;
+
     template <typename Tag>
     void load();
 
@@ -60,6 +69,8 @@ public:
     token::symbol::value symbol() const;
     token::category::value category() const;
     size_type length() const;
+    size_type rank() const;
+    size_type extent(size_type dimension) const;
 
     // Ignore these
     void load(boost::archive::version_type&) {}
@@ -74,6 +85,14 @@ public:
     void next();
     void next(token::code::value);
 
+    //! @brief Advance to the value of a tagged record field.
+    //!
+    //! @returns false if the current record has no such field.
+    bool find_field(token::field::type tag);
+
+    //! @brief Skip the remaining tagged fields of the current record.
+    void skip_fields();
+
 private:
     bintoken::reader reader;
 };
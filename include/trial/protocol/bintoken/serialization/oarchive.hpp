@@ -30,6 +30,29 @@ public:
     template <typename T>
     oarchive(T&);
 
+    //! @brief Select the bit-packing policy for integer arrays.
+    //!
+    //! Applies to containers that are saved as compact arrays, such as
+    //! std::vector of integers.
+    void packing(bintoken::packing::value policy);
+
+    //! @brief Select the precision of real arrays.
+    //!
+    //! Applies to containers that are saved as compact arrays, such as
+    //! std::vector of float or double.
+    void precision(bintoken::precision::value policy);
+
+    //! @brief Encode repeated strings, such as map keys, with a dictionary.
+    void dictionary(bool enable);
+
+    //! @brief Prefix records, arrays, and maps with their encoded length.
+    //!
+    //! Allows readers to skip unknown tagged fields in constant time.
+    void length_prefix(bool enable);
+
+    //! @brief Tag the next value in the current record.
+    void field(token::field::type tag);
+
     template <typename T>
     void save_override(const T& data);
 
@@ -45,6 +68,9 @@ public:
     template <typename T>
     void save_array(const T *data, std::size_t size);
 
+    template <typename T>
+    void save_tensor(const T *data, const std::size_t *extents, std::size_t rank);
+
     // Ignore these
     void save_override(const boost::archive::version_type) {}
     void save_override(const boost::archive::object_id_type) {}
@@ -53,6 +53,7 @@ struct load_overloader<bintoken::iarchive,
     {
         ar.load<bintoken::token::begin_record>();
         data.load(ar, protocol_version);
+        ar.skip_fields();
         ar.load<bintoken::token::end_record>();
     }
 };
@@ -69,6 +70,7 @@ struct serialize_overloader<bintoken::iarchive,
     {
         ar.template load<bintoken::token::begin_record>();
         data.serialize(ar, protocol_version);
+        ar.skip_fields();
         ar.template load<bintoken::token::end_record>();
     }
 };
@@ -12,6 +12,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <trial/protocol/bintoken/serialization/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/detail/bulk.hpp>
 #include <trial/protocol/core/serialization/std/array.hpp>
 
 //-----------------------------------------------------------------------------
@@ -94,6 +95,23 @@ struct save_overloader< protocol::bintoken::oarchive,
     static void save(protocol::bintoken::oarchive& ar,
                      const std::array<T, N>& data,
                      const unsigned int protocol_version)
+    {
+        save(ar, data, protocol_version, std::integral_constant<bool, detail::bulk<T>::value>());
+    }
+
+private:
+    static void save(protocol::bintoken::oarchive& ar,
+                     const std::array<T, N>& data,
+                     const unsigned int,
+                     std::true_type)
+    {
+        detail::bulk<T>::save(ar, data.data(), N);
+    }
+
+    static void save(protocol::bintoken::oarchive& ar,
+                     const std::array<T, N>& data,
+                     const unsigned int protocol_version,
+                     std::false_type)
     {
         ar.save<bintoken::token::begin_array>();
         ar.save<std::size_t>(N);
@@ -112,6 +130,46 @@ struct load_overloader< protocol::bintoken::iarchive,
     static void load(protocol::bintoken::iarchive& ar,
                      std::array<T, N>& data,
                      const unsigned int protocol_version)
+    {
+        load(ar, data, protocol_version, std::integral_constant<bool, detail::bulk<T>::value>());
+    }
+
+private:
+    static void load(protocol::bintoken::iarchive& ar,
+                     std::array<T, N>& data,
+                     const unsigned int protocol_version,
+                     std::true_type)
+    {
+        if (detail::bulk<T>::accept(ar))
+        {
+            detail::bulk<T>::load(ar, data.data(), N);
+        }
+        else
+        {
+            load_elements(ar, data, protocol_version, std::integral_constant<bool, detail::bulk<T>::elementwise>());
+        }
+    }
+
+    static void load(protocol::bintoken::iarchive& ar,
+                     std::array<T, N>& data,
+                     const unsigned int protocol_version,
+                     std::false_type)
+    {
+        load_elements(ar, data, protocol_version, std::true_type());
+    }
+
+    static void load_elements(protocol::bintoken::iarchive&,
+                              std::array<T, N>&,
+                              const unsigned int,
+                              std::false_type)
+    {
+        throw bintoken::error(bintoken::incompatible_type);
+    }
+
+    static void load_elements(protocol::bintoken::iarchive& ar,
+                              std::array<T, N>& data,
+                              const unsigned int protocol_version,
+                              std::true_type)
     {
         ar.load<bintoken::token::begin_array>();
 
@@ -122,9 +180,7 @@ struct load_overloader< protocol::bintoken::iarchive,
 
         for (std::size_t i = 0; i < N; ++i)
         {
-            T value;
-            ar >> value;
-            data[i] = value;
+            ar >> data[i];
         }
         if (!ar.at<bintoken::token::end_array>())
             throw bintoken::error(bintoken::expected_end_array);
@@ -167,6 +223,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -209,6 +266,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -251,6 +309,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -293,6 +352,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -335,6 +395,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -377,6 +438,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -419,6 +481,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -461,6 +524,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -496,6 +560,13 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_float32:
         case bintoken::token::code::array32_float32:
         case bintoken::token::code::array64_float32:
+            // 16-bit reals are widened
+        case bintoken::token::code::array8_float16:
+        case bintoken::token::code::array16_float16:
+        case bintoken::token::code::array32_float16:
+        case bintoken::token::code::array8_bfloat16:
+        case bintoken::token::code::array16_bfloat16:
+        case bintoken::token::code::array32_bfloat16:
             {
                 const auto length = ar.length();
                 if (length > N)
@@ -503,6 +574,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -538,6 +610,13 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_float64:
         case bintoken::token::code::array32_float64:
         case bintoken::token::code::array64_float64:
+            // 16-bit reals are widened
+        case bintoken::token::code::array8_float16:
+        case bintoken::token::code::array16_float16:
+        case bintoken::token::code::array32_float16:
+        case bintoken::token::code::array8_bfloat16:
+        case bintoken::token::code::array16_bfloat16:
+        case bintoken::token::code::array32_bfloat16:
             {
                 const auto length = ar.length();
                 if (length > N)
@@ -545,6 +624,7 @@ struct load_overloader< bintoken::iarchive,
                     throw bintoken::error(bintoken::overflow);
                 }
                 ar.load_array(data.data(), length);
+                ar.next();
             }
             break;
 
@@ -13,6 +13,7 @@
 
 #include <trial/protocol/bintoken/serialization/serialization.hpp>
 #include <trial/protocol/bintoken/serialization/boost/optional.hpp>
+#include <trial/protocol/bintoken/serialization/detail/bulk.hpp>
 #include <trial/protocol/core/serialization/std/vector.hpp>
 
 namespace trial
@@ -29,6 +30,23 @@ struct save_overloader< bintoken::oarchive,
     static void save(bintoken::oarchive& ar,
                      const std::vector<T, Allocator>& data,
                      const unsigned int protocol_version)
+    {
+        save(ar, data, protocol_version, std::integral_constant<bool, detail::bulk<T>::value>());
+    }
+
+private:
+    static void save(bintoken::oarchive& ar,
+                     const std::vector<T, Allocator>& data,
+                     const unsigned int,
+                     std::true_type)
+    {
+        detail::bulk<T>::save(ar, data.data(), data.size());
+    }
+
+    static void save(bintoken::oarchive& ar,
+                     const std::vector<T, Allocator>& data,
+                     const unsigned int protocol_version,
+                     std::false_type)
     {
         ar.save<bintoken::token::begin_array>();
         ar.save<std::size_t>(data.size());
@@ -49,6 +67,46 @@ struct load_overloader< bintoken::iarchive,
     static void load(bintoken::iarchive& ar,
                      std::vector<T, Allocator>& data,
                      const unsigned int protocol_version)
+    {
+        load(ar, data, protocol_version, std::integral_constant<bool, detail::bulk<T>::value>());
+    }
+
+private:
+    static void load(bintoken::iarchive& ar,
+                     std::vector<T, Allocator>& data,
+                     const unsigned int protocol_version,
+                     std::true_type)
+    {
+        if (detail::bulk<T>::accept(ar))
+        {
+            detail::bulk<T>::load(ar, data);
+        }
+        else
+        {
+            load_elements(ar, data, protocol_version, std::integral_constant<bool, detail::bulk<T>::elementwise>());
+        }
+    }
+
+    static void load(bintoken::iarchive& ar,
+                     std::vector<T, Allocator>& data,
+                     const unsigned int protocol_version,
+                     std::false_type)
+    {
+        load_elements(ar, data, protocol_version, std::true_type());
+    }
+
+    static void load_elements(bintoken::iarchive&,
+                              std::vector<T, Allocator>&,
+                              const unsigned int,
+                              std::false_type)
+    {
+        throw bintoken::error(bintoken::incompatible_type);
+    }
+
+    static void load_elements(bintoken::iarchive& ar,
+                              std::vector<T, Allocator>& data,
+                              const unsigned int protocol_version,
+                              std::true_type)
     {
         ar.load<bintoken::token::begin_array>();
 
@@ -63,7 +121,7 @@ struct load_overloader< bintoken::iarchive,
         {
             T value;
             ar >> value;
-            data.push_back(value);
+            data.push_back(std::move(value));
         }
         ar.load<bintoken::token::end_array>();
     }
@@ -97,8 +155,11 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int8:
         case bintoken::token::code::array32_int8:
         case bintoken::token::code::array64_int8:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            {
+                const auto view = ar.array_view<std::int8_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -134,8 +195,11 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int8:
         case bintoken::token::code::array32_int8:
         case bintoken::token::code::array64_int8:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            {
+                const auto view = ar.array_view<std::uint8_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -170,8 +234,24 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int16:
         case bintoken::token::code::array32_int16:
         case bintoken::token::code::array64_int16:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // Narrowed, variable-length, or packed integers are widened
+        case bintoken::token::code::array8_int8:
+        case bintoken::token::code::array16_int8:
+        case bintoken::token::code::array32_int8:
+        case bintoken::token::code::array64_int8:
+        case bintoken::token::code::array8_varint:
+        case bintoken::token::code::array16_varint:
+        case bintoken::token::code::array32_varint:
+        case bintoken::token::code::array64_varint:
+        case bintoken::token::code::array8_packed:
+        case bintoken::token::code::array16_packed:
+        case bintoken::token::code::array32_packed:
+        case bintoken::token::code::array64_packed:
+            {
+                const auto view = ar.array_view<std::int16_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -207,8 +287,24 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int16:
         case bintoken::token::code::array32_int16:
         case bintoken::token::code::array64_int16:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // Narrowed, variable-length, or packed integers are widened
+        case bintoken::token::code::array8_int8:
+        case bintoken::token::code::array16_int8:
+        case bintoken::token::code::array32_int8:
+        case bintoken::token::code::array64_int8:
+        case bintoken::token::code::array8_varint:
+        case bintoken::token::code::array16_varint:
+        case bintoken::token::code::array32_varint:
+        case bintoken::token::code::array64_varint:
+        case bintoken::token::code::array8_packed:
+        case bintoken::token::code::array16_packed:
+        case bintoken::token::code::array32_packed:
+        case bintoken::token::code::array64_packed:
+            {
+                const auto view = ar.array_view<std::uint16_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -243,8 +339,28 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int32:
         case bintoken::token::code::array32_int32:
         case bintoken::token::code::array64_int32:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // Narrowed, variable-length, or packed integers are widened
+        case bintoken::token::code::array8_int8:
+        case bintoken::token::code::array16_int8:
+        case bintoken::token::code::array32_int8:
+        case bintoken::token::code::array64_int8:
+        case bintoken::token::code::array8_int16:
+        case bintoken::token::code::array16_int16:
+        case bintoken::token::code::array32_int16:
+        case bintoken::token::code::array64_int16:
+        case bintoken::token::code::array8_varint:
+        case bintoken::token::code::array16_varint:
+        case bintoken::token::code::array32_varint:
+        case bintoken::token::code::array64_varint:
+        case bintoken::token::code::array8_packed:
+        case bintoken::token::code::array16_packed:
+        case bintoken::token::code::array32_packed:
+        case bintoken::token::code::array64_packed:
+            {
+                const auto view = ar.array_view<std::int32_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -280,8 +396,28 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int32:
         case bintoken::token::code::array32_int32:
         case bintoken::token::code::array64_int32:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // Narrowed, variable-length, or packed integers are widened
+        case bintoken::token::code::array8_int8:
+        case bintoken::token::code::array16_int8:
+        case bintoken::token::code::array32_int8:
+        case bintoken::token::code::array64_int8:
+        case bintoken::token::code::array8_int16:
+        case bintoken::token::code::array16_int16:
+        case bintoken::token::code::array32_int16:
+        case bintoken::token::code::array64_int16:
+        case bintoken::token::code::array8_varint:
+        case bintoken::token::code::array16_varint:
+        case bintoken::token::code::array32_varint:
+        case bintoken::token::code::array64_varint:
+        case bintoken::token::code::array8_packed:
+        case bintoken::token::code::array16_packed:
+        case bintoken::token::code::array32_packed:
+        case bintoken::token::code::array64_packed:
+            {
+                const auto view = ar.array_view<std::uint32_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -316,8 +452,32 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int64:
         case bintoken::token::code::array32_int64:
         case bintoken::token::code::array64_int64:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // Narrowed, variable-length, or packed integers are widened
+        case bintoken::token::code::array8_int8:
+        case bintoken::token::code::array16_int8:
+        case bintoken::token::code::array32_int8:
+        case bintoken::token::code::array64_int8:
+        case bintoken::token::code::array8_int16:
+        case bintoken::token::code::array16_int16:
+        case bintoken::token::code::array32_int16:
+        case bintoken::token::code::array64_int16:
+        case bintoken::token::code::array8_int32:
+        case bintoken::token::code::array16_int32:
+        case bintoken::token::code::array32_int32:
+        case bintoken::token::code::array64_int32:
+        case bintoken::token::code::array8_varint:
+        case bintoken::token::code::array16_varint:
+        case bintoken::token::code::array32_varint:
+        case bintoken::token::code::array64_varint:
+        case bintoken::token::code::array8_packed:
+        case bintoken::token::code::array16_packed:
+        case bintoken::token::code::array32_packed:
+        case bintoken::token::code::array64_packed:
+            {
+                const auto view = ar.array_view<std::int64_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -353,8 +513,32 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_int64:
         case bintoken::token::code::array32_int64:
         case bintoken::token::code::array64_int64:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // Narrowed, variable-length, or packed integers are widened
+        case bintoken::token::code::array8_int8:
+        case bintoken::token::code::array16_int8:
+        case bintoken::token::code::array32_int8:
+        case bintoken::token::code::array64_int8:
+        case bintoken::token::code::array8_int16:
+        case bintoken::token::code::array16_int16:
+        case bintoken::token::code::array32_int16:
+        case bintoken::token::code::array64_int16:
+        case bintoken::token::code::array8_int32:
+        case bintoken::token::code::array16_int32:
+        case bintoken::token::code::array32_int32:
+        case bintoken::token::code::array64_int32:
+        case bintoken::token::code::array8_varint:
+        case bintoken::token::code::array16_varint:
+        case bintoken::token::code::array32_varint:
+        case bintoken::token::code::array64_varint:
+        case bintoken::token::code::array8_packed:
+        case bintoken::token::code::array16_packed:
+        case bintoken::token::code::array32_packed:
+        case bintoken::token::code::array64_packed:
+            {
+                const auto view = ar.array_view<std::uint64_t>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -389,8 +573,18 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_float32:
         case bintoken::token::code::array32_float32:
         case bintoken::token::code::array64_float32:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // 16-bit reals are widened
+        case bintoken::token::code::array8_float16:
+        case bintoken::token::code::array16_float16:
+        case bintoken::token::code::array32_float16:
+        case bintoken::token::code::array8_bfloat16:
+        case bintoken::token::code::array16_bfloat16:
+        case bintoken::token::code::array32_bfloat16:
+            {
+                const auto view = ar.array_view<bintoken::token::float32::type>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -425,8 +619,18 @@ struct load_overloader< bintoken::iarchive,
         case bintoken::token::code::array16_float64:
         case bintoken::token::code::array32_float64:
         case bintoken::token::code::array64_float64:
-            data.assign(ar.length(), {});
-            ar.load_array(data.data(), data.size());
+            // 16-bit reals are widened
+        case bintoken::token::code::array8_float16:
+        case bintoken::token::code::array16_float16:
+        case bintoken::token::code::array32_float16:
+        case bintoken::token::code::array8_bfloat16:
+        case bintoken::token::code::array16_bfloat16:
+        case bintoken::token::code::array32_bfloat16:
+            {
+                const auto view = ar.array_view<bintoken::token::float64::type>();
+                data.assign(view.begin(), view.end());
+                ar.next();
+            }
             break;
 
         default:
@@ -443,18 +647,9 @@ struct save_overloader< bintoken::oarchive,
 {
     static void save(bintoken::oarchive& ar,
                      const std::vector<bool, Allocator>& data,
-                     const unsigned int protocol_version)
+                     const unsigned int /* protocol_version */)
     {
-        ar.save<bintoken::token::begin_array>();
-        ar.save<std::size_t>(data.size());
-        for (typename std::vector<bool, Allocator>::const_iterator it = data.begin();
-             it != data.end();
-             ++it)
-        {
-            bool value = *it;
-            ar.save_override(value, protocol_version);
-        }
-        ar.save<bintoken::token::end_array>();
+        detail::bulk<bool>::save(ar, data.begin(), data.size());
     }
 };
 
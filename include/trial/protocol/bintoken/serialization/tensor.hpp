@@ -0,0 +1,154 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_TENSOR_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_TENSOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <trial/protocol/bintoken/serialization/serialization.hpp>
+#include <trial/protocol/core/detail/type_traits.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+//! @brief Wrapper that serializes a vector as a multi-dimensional array.
+//!
+//! Use tensor() to create the wrapper.
+template <typename Data, typename Shape>
+class tensor_wrapper
+{
+public:
+    tensor_wrapper(Data& data, Shape& shape)
+        : data(data),
+          shape(shape)
+    {
+    }
+
+    Data& get() const
+    {
+        return data;
+    }
+
+    Shape& extents() const
+    {
+        return shape;
+    }
+
+private:
+    Data& data;
+    Shape& shape;
+};
+
+//! @brief Serialize a vector of arithmetic values with a shape.
+//!
+//! The values are stored in row-major order, and the shape holds the extent
+//! of each dimension. They are encoded as a single typed array preceded by
+//! the shape, so loading takes one allocation and one copy regardless of
+//! the number of dimensions.
+//!
+//! When loading, an array without a shape is loaded with a single dimension.
+//!
+//! @code
+//! std::vector<float> matrix(rows * columns);
+//! std::vector<std::size_t> shape = { rows, columns };
+//! archive << bintoken::tensor(matrix, shape);
+//! @endcode
+template <typename T, typename Allocator, typename Shape>
+const tensor_wrapper<std::vector<T, Allocator>, Shape> tensor(std::vector<T, Allocator>& data,
+                                                              Shape& shape)
+{
+    return tensor_wrapper<std::vector<T, Allocator>, Shape>(data, shape);
+}
+
+template <typename T, typename Allocator, typename Shape>
+const tensor_wrapper<const std::vector<T, Allocator>, Shape> tensor(const std::vector<T, Allocator>& data,
+                                                                    Shape& shape)
+{
+    return tensor_wrapper<const std::vector<T, Allocator>, Shape>(data, shape);
+}
+
+} // namespace bintoken
+
+namespace serialization
+{
+
+template <typename Data, typename Shape>
+struct save_overloader< bintoken::oarchive,
+                        bintoken::tensor_wrapper<Data, Shape> >
+{
+    using value_type = typename std::remove_const<Data>::type::value_type;
+
+    static_assert(!core::detail::is_bool<value_type>::value, "Tensor elements must be numbers");
+
+    static void save(bintoken::oarchive& ar,
+                     const bintoken::tensor_wrapper<Data, Shape>& wrapper,
+                     const unsigned int)
+    {
+        const auto& data = wrapper.get();
+        const std::vector<std::size_t> extents(wrapper.extents().begin(), wrapper.extents().end());
+        std::size_t size = extents.empty() ? 0 : 1;
+        for (auto extent : extents)
+        {
+            size *= extent;
+        }
+        if (size != data.size())
+            throw bintoken::error(bintoken::invalid_value);
+
+        ar.save_tensor(data.data(), extents.data(), extents.size());
+    }
+};
+
+template <typename Data, typename Shape>
+struct load_overloader< bintoken::iarchive,
+                        bintoken::tensor_wrapper<Data, Shape> >
+{
+    using value_type = typename Data::value_type;
+
+    static_assert(!core::detail::is_bool<value_type>::value, "Tensor elements must be numbers");
+
+    static void load(bintoken::iarchive& ar,
+                     const bintoken::tensor_wrapper<Data, Shape>& wrapper,
+                     const unsigned int)
+    {
+        if (ar.symbol() != bintoken::token::symbol::array)
+            throw bintoken::error(bintoken::incompatible_type);
+
+        auto& shape = wrapper.extents();
+        shape.resize(ar.rank());
+        for (std::size_t i = 0; i < shape.size(); ++i)
+        {
+            shape[i] = ar.extent(i);
+        }
+        const auto view = ar.array_view<value_type>();
+        wrapper.get().assign(view.begin(), view.end());
+        ar.next();
+    }
+};
+
+// The wrapper is passed as a const temporary
+template <typename Data, typename Shape>
+struct load_overloader< bintoken::iarchive,
+                        const bintoken::tensor_wrapper<Data, Shape> >
+    : load_overloader< bintoken::iarchive,
+                       bintoken::tensor_wrapper<Data, Shape> >
+{
+};
+
+} // namespace serialization
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_SERIALIZATION_TENSOR_HPP
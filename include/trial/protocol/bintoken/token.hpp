@@ -42,12 +42,28 @@ struct code
         error_expected_end_record,
         error_expected_end_array,
         error_expected_end_assoc_array,
+        error_truncated,
 
         // Value types
         null = 0x82,
         true_value = 0x81,
         false_value = 0x80,
 
+        // Alignment padding (skipped by the decoder)
+        padding = 0x83,
+
+        // String dictionary. A definition adds a string to the dictionary
+        // (consumed by the decoder) and a reference refers to a string by
+        // its position in the dictionary.
+        string_define = 0x86,
+        string_reference8 = 0x87,
+        string_reference16 = 0x88,
+
+        // Shape of the array that follows. An 8-bit rank is followed by the
+        // extent of each dimension as a 32-bit integer. The decoder attaches
+        // the shape to the array.
+        tensor = 0x89,
+
         // Fixed-length types
         int8 = 0xA0,
         int16 = 0xB2,
@@ -57,6 +73,12 @@ struct code
         float32 = 0xC5,
         float64 = 0xD7,
 
+        // Variable-length integer (zigzag LEB128)
+        varint = 0x84,
+
+        // Field tag in a record (zigzag LEB128 tag number)
+        field = 0x85,
+
         // Variable-length types
         array8_int8 = 0xA8,
         array16_int8 = 0xB8,
@@ -88,6 +110,35 @@ struct code
         array32_float64 = 0xCF,
         array64_float64 = 0xDF,
 
+        // Reduced-precision reals (IEEE 754 half precision and bfloat16.)
+        // There are no variants with a 64-bit length because their codes are
+        // taken by int64 and float64.
+        array8_float16 = 0xA6,
+        array16_float16 = 0xB6,
+        array32_float16 = 0xC6,
+
+        array8_bfloat16 = 0xA7,
+        array16_bfloat16 = 0xB7,
+        array32_bfloat16 = 0xC7,
+
+        // Bit-packed booleans, least significant bit first. The first byte
+        // of the payload is the number of unused bits in the last byte.
+        array8_bool = 0xAB,
+        array16_bool = 0xBB,
+        array32_bool = 0xCB,
+        array64_bool = 0xDB,
+
+        array8_varint = 0xA1,
+        array16_varint = 0xB1,
+        array32_varint = 0xC1,
+        array64_varint = 0xD1,
+
+        // Bit-packed integers with frame of reference or delta encoding
+        array8_packed = 0xA3,
+        array16_packed = 0xB3,
+        array32_packed = 0xC3,
+        array64_packed = 0xD3,
+
         string8 = 0xA9,
         string16 = 0xB9,
         string32 = 0xC9,
@@ -99,7 +150,12 @@ struct code
         begin_array = 0x92,
         end_array = 0x93,
         begin_assoc_array = 0x9C,
-        end_assoc_array = 0x9D
+        end_assoc_array = 0x9D,
+
+        // Group types with 32-bit length prefix
+        begin_record32 = 0x94,
+        begin_array32 = 0x96,
+        begin_assoc_array32 = 0x9E
     };
 };
 
@@ -119,6 +175,7 @@ struct symbol
 
         begin_record,
         end_record,
+        field,
         begin_array,
         end_array,
         begin_assoc_array,
@@ -258,6 +315,20 @@ struct float64
     static bool same(token::code::value);
 };
 
+struct varint
+{
+    using type = std::int64_t;
+    static const token::code::value code = token::code::varint;
+    static bool same(token::code::value);
+};
+
+struct field
+{
+    using type = std::uint32_t;
+    static const token::code::value code = token::code::field;
+    static bool same(token::code::value);
+};
+
 struct string
 {
     using type = std::string;
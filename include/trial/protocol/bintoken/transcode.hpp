@@ -0,0 +1,65 @@
+#ifndef TRIAL_PROTOCOL_BINTOKEN_TRANSCODE_HPP
+#define TRIAL_PROTOCOL_BINTOKEN_TRANSCODE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <trial/protocol/json/reader.hpp>
+#include <trial/protocol/json/writer.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace bintoken
+{
+
+const std::size_t default_lookahead = 4096;
+
+//! @brief Transcode the current JSON value into bintoken.
+//!
+//! The value is converted token by token without building a tree, and the
+//! reader is advanced past the value. JSON objects become associative arrays
+//! with alternating keys and values.
+//!
+//! A JSON array whose elements are all numbers is written as a typed array,
+//! subject to the packing options of the writer. Up to @c lookahead elements
+//! are buffered to determine this. Longer arrays, and arrays with other
+//! elements, are written element by element.
+//!
+//! @throws json::error if the input is malformed.
+template <typename CharT>
+void transcode(json::basic_reader<CharT>& input,
+               bintoken::writer& output,
+               std::size_t lookahead = default_lookahead);
+
+//! @brief Transcode the current bintoken value into JSON.
+//!
+//! The value is converted token by token without building a tree, and the
+//! reader is advanced past the value. Typed arrays become JSON arrays of
+//! numbers, records become JSON arrays, and associative arrays become JSON
+//! objects.
+//!
+//! @throws bintoken::error if the input is malformed, or if an associative
+//!         array has a key that is not a string.
+template <typename CharT, std::size_t N>
+void transcode(bintoken::reader& input,
+               json::basic_writer<CharT, N>& output);
+
+} // namespace bintoken
+} // namespace protocol
+} // namespace trial
+
+#include <trial/protocol/bintoken/detail/transcode.ipp>
+
+#endif // TRIAL_PROTOCOL_BINTOKEN_TRANSCODE_HPP
@@ -11,8 +11,10 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
+#include <trial/protocol/core/detail/small_stack.hpp>
 #include <trial/protocol/bintoken/error.hpp>
+#include <trial/protocol/bintoken/packing.hpp>
+#include <trial/protocol/bintoken/precision.hpp>
 #include <trial/protocol/bintoken/detail/encoder.hpp>
 
 namespace trial
@@ -31,6 +33,82 @@ public:
 
     template <typename T> writer(T&);
 
+    //! @brief Rebind the writer to a new output.
+    //!
+    //! Discards the nesting state so that the writer can be reused for a new
+    //! message without being reconstructed. The alignment is retained.
+    template <typename T> void reset(T&);
+
+    //! @brief Align the payload of subsequent arrays.
+    //!
+    //! Padding tokens are inserted before an array token so that its payload
+    //! starts at a multiple of @c size bytes from the beginning of the output.
+    //! This allows reader::array_view() to alias the payload without copying.
+    //!
+    //! A size of 0 or 1 disables alignment (the default.)
+    void align(size_type size);
+
+    //! @brief Prefix subsequent containers with their encoded length.
+    //!
+    //! Records, arrays, and associative arrays are encoded with a 32-bit byte
+    //! length that allows reader::skip() to jump over them. The containers are
+    //! kept in an internal buffer until the outermost of them is closed.
+    //!
+    //! Disabled by default.
+    void length_prefix(bool enable);
+
+    //! @brief Encode subsequent integers as variable-length integers.
+    //!
+    //! Integers and integer arrays are zigzag encoded with 7 bits per byte
+    //! whenever that is shorter than their fixed-size encoding. This favors
+    //! integers of small magnitude stored in wide types. Arrays encoded this
+    //! way cannot be aliased by reader::array_view().
+    //!
+    //! Disabled by default.
+    void varint(bool enable);
+
+    //! @brief Encode subsequent integer arrays with the narrowest element type.
+    //!
+    //! The range of each integer array is scanned, and the array is encoded
+    //! with the smallest integer token that can hold all its elements. The
+    //! reader widens the elements again when the array is read into a wider
+    //! type.
+    //!
+    //! Disabled by default.
+    void narrow(bool enable);
+
+    //! @brief Select the bit-packing policy for subsequent integer arrays.
+    //!
+    //! Packed arrays store the elements relative to a reference value, or
+    //! relative to the previous element, using only as many bits per
+    //! element as the largest difference needs.
+    //!
+    //! Defaults to packing::none.
+    void packing(packing::value policy);
+
+    //! @brief Select the precision of subsequent floating-point arrays.
+    //!
+    //! Arrays of float and double are encoded with 16-bit elements, which
+    //! halves or quarters their size at the cost of precision. The reader
+    //! converts the elements back into float or double. Single values are
+    //! not affected, nor are arrays too long for a 32-bit length.
+    //!
+    //! Defaults to precision::full.
+    void precision(bintoken::precision::value policy);
+
+    //! @brief Encode subsequent strings with a string dictionary.
+    //!
+    //! The first occurrence of a string defines a dictionary entry, and later
+    //! occurrences refer to the entry by its position. This reduces the size
+    //! of repeated keys in records and associative arrays. The reader yields
+    //! the same literal view for all occurrences, so repeated strings can be
+    //! compared by address.
+    //!
+    //! The dictionary lasts until the writer is reset. Definitions are written
+    //! ahead of any length-prefixed container being encoded, which may offset
+    //! the alignment inside that container. Disabled by default.
+    void dictionary(bool enable);
+
     template <typename T>
     size_type value();
 
@@ -40,6 +118,31 @@ public:
     template <typename T>
     size_type array(const T *, size_type);
 
+    //! @brief Write a multi-dimensional array.
+    //!
+    //! The elements are stored contiguously in row-major order as a single
+    //! typed array, which is preceded by the rank and the extents.
+    //!
+    //! @param data Elements whose number is the product of the extents.
+    //! @param extents Extent of each dimension.
+    //! @param rank Number of dimensions.
+    //!
+    //! @throws system_error if rank is zero or larger than 255, or if an
+    //! extent does not fit into 32 bits.
+    template <typename T>
+    size_type tensor(const T *data, const size_type *extents, size_type rank);
+
+    //! @brief Tag the next value in the current record.
+    //!
+    //! Fields must be written in ascending tag order. A record whose values
+    //! are tagged can be read with
+    //! reader::find_field(), which skips the fields that the reader does not
+    //! know. Combine with length_prefix() so that skipping a field that holds
+    //! a container takes constant time.
+    //!
+    //! @throws system_error if not inside a record.
+    size_type field(token::field::type tag);
+
 private:
     void validate_scope(token::code::value, enum bintoken::errc);
 
@@ -47,7 +150,7 @@ private:
     template <typename T, typename Enable = void> struct overloader;
     detail::encoder encoder;
 
-    std::stack<token::code::value> stack;
+    core::detail::small_stack<token::code::value, 16> stack;
 };
 
 } // namespace bintoken
@@ -0,0 +1,485 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_ASYNC_DESCRIPTOR_HPP
+#define TRIAL_PROTOCOL_BUFFER_ASYNC_DESCRIPTOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+# include <io.h>
+#else
+# include <unistd.h>
+# include <sys/uio.h>
+#endif
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/buffer/detail/forward.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+
+//! @brief Behavior of asynchronous sinks when the ring buffer is full.
+struct backpressure
+{
+    enum value
+    {
+        //! Wait until the flusher thread has made room.
+        block,
+        //! Discard the write and count the dropped characters.
+        drop,
+        //! Queue the write in an unbounded overflow area.
+        grow
+    };
+};
+
+//! @brief Counters of asynchronous sink activity.
+//!
+//! Latencies are measured from when the oldest character of a batch was
+//! written by the producer until the batch has been written to the file
+//! descriptor.
+struct async_statistics
+{
+    std::uint64_t written;
+    std::uint64_t dropped;
+    std::uint64_t batches;
+    std::uint64_t stalls;
+    std::chrono::nanoseconds total_latency;
+    std::chrono::nanoseconds max_latency;
+};
+
+//! @brief Asynchronous file descriptor sink.
+//!
+//! The producer writes into a lock-free single-producer/single-consumer ring
+//! buffer, and a dedicated flusher thread drains the ring buffer to the file
+//! descriptor in batches. The file descriptor is not closed by the sink.
+//!
+//! Only one thread may write to the sink at a time.
+template <typename CharT>
+class basic_async_descriptor
+{
+    using clock_type = std::chrono::steady_clock;
+
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using view_type = typename base<CharT>::view_type;
+
+    static const size_type default_capacity = 64 * 1024;
+
+    //! @brief Creates sink and starts the flusher thread.
+    //!
+    //! The capacity of the ring buffer is rounded up to a power of two.
+    //! The flusher thread wakes up at least once per interval.
+    explicit basic_async_descriptor(int fd,
+                                    size_type capacity = default_capacity,
+                                    backpressure::value policy = backpressure::block,
+                                    std::chrono::microseconds interval = std::chrono::microseconds(1000))
+        : fd(fd),
+          policy(policy),
+          interval(interval),
+          capacity(round_up(capacity)),
+          ring(new value_type[this->capacity]),
+          head(0),
+          tail(0),
+          mark(0),
+          spilling(false),
+          stopping(false),
+          failed(false),
+          written(0),
+          dropped(0),
+          batches(0),
+          stalls(0),
+          total_latency(0),
+          max_latency(0),
+          flusher(&basic_async_descriptor::run, this)
+    {
+    }
+
+    basic_async_descriptor(const basic_async_descriptor&) = delete;
+    basic_async_descriptor& operator= (const basic_async_descriptor&) = delete;
+
+    ~basic_async_descriptor()
+    {
+        close();
+    }
+
+    //! @brief Waits until all pending output has been written.
+    bool flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!idle() && !stopped())
+        {
+            wakeup.notify_one();
+            drained.wait_for(lock, interval);
+        }
+        return good();
+    }
+
+    //! @brief Writes pending output and stops the flusher thread.
+    //!
+    //! Output written after close is discarded.
+    void close()
+    {
+        if (flusher.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wakeup.notify_one();
+            flusher.join();
+        }
+    }
+
+    bool good() const
+    {
+        return !failed.load(std::memory_order_acquire);
+    }
+
+    //! @brief Returns the error of the first failed write.
+    //!
+    //! Must only be called after flush() or close().
+    const std::error_code& error() const
+    {
+        return failure;
+    }
+
+    //! @brief Returns a snapshot of the activity counters.
+    async_statistics statistics() const
+    {
+        async_statistics result;
+        result.written = written.load(std::memory_order_relaxed);
+        result.dropped = dropped.load(std::memory_order_relaxed);
+        result.batches = batches.load(std::memory_order_relaxed);
+        result.stalls = stalls.load(std::memory_order_relaxed);
+        result.total_latency = std::chrono::nanoseconds(total_latency.load(std::memory_order_relaxed));
+        result.max_latency = std::chrono::nanoseconds(max_latency.load(std::memory_order_relaxed));
+        return result;
+    }
+
+    bool grow(size_type)
+    {
+        return good();
+    }
+
+    void write(value_type value)
+    {
+        put(&value, 1);
+    }
+
+    void write(const view_type& view)
+    {
+        put(view.data(), view.size());
+    }
+
+private:
+    static size_type round_up(size_type value)
+    {
+        size_type result = 64;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+    }
+
+    bool idle() const
+    {
+        return (tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire))
+            && !spilling.load(std::memory_order_acquire);
+    }
+
+    bool stopped() const
+    {
+        return !flusher.joinable() || stopping;
+    }
+
+    //-------------------------------------------------------------------------
+    // Producer
+    //-------------------------------------------------------------------------
+
+    void put(const value_type *data, size_type size)
+    {
+        if (spilling.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // The flusher may have emptied the overflow area in the meantime
+            if (spilling.load(std::memory_order_relaxed))
+            {
+                spill.insert(spill.end(), data, data + size);
+                return;
+            }
+        }
+
+        const size_type first = head.load(std::memory_order_relaxed);
+        size_type available = capacity - (first - tail.load(std::memory_order_acquire));
+        if (size > available)
+        {
+            switch (policy)
+            {
+            case backpressure::drop:
+                dropped.fetch_add(size, std::memory_order_relaxed);
+                return;
+
+            case backpressure::grow:
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    spill.insert(spill.end(), data, data + size);
+                    spilling.store(true, std::memory_order_release);
+                }
+                wakeup.notify_one();
+                return;
+
+            case backpressure::block:
+                break;
+            }
+        }
+
+        // Copy as much as there is room for, and wait for the flusher to
+        // make room for the rest.
+        while (size > 0)
+        {
+            size_type position = head.load(std::memory_order_relaxed);
+            available = capacity - (position - tail.load(std::memory_order_acquire));
+            if (available == 0)
+            {
+                stalls.fetch_add(1, std::memory_order_relaxed);
+                std::unique_lock<std::mutex> lock(mutex);
+                while (capacity == (position - tail.load(std::memory_order_acquire)))
+                {
+                    if (stopped())
+                        return;
+                    wakeup.notify_one();
+                    drained.wait_for(lock, interval);
+                }
+                continue;
+            }
+            if (position == tail.load(std::memory_order_acquire))
+            {
+                // Ring buffer is empty so this is the oldest output
+                mark.store(now(), std::memory_order_relaxed);
+            }
+            const size_type count = std::min(size, available);
+            const size_type offset = position & (capacity - 1);
+            const size_type before = std::min(count, capacity - offset);
+            std::memcpy(ring.get() + offset, data, before * sizeof(value_type));
+            std::memcpy(ring.get(), data + before, (count - before) * sizeof(value_type));
+            head.store(position + count, std::memory_order_release);
+            data += count;
+            size -= count;
+
+            // Wake up flusher when the ring buffer passes the half-way mark
+            const size_type used = capacity - available;
+            if ((used < capacity / 2) && (used + count >= capacity / 2))
+            {
+                wakeup.notify_one();
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Flusher
+    //-------------------------------------------------------------------------
+
+    void run()
+    {
+        std::int64_t previous = now();
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (idle())
+                {
+                    if (stopping)
+                        break;
+                    wakeup.wait_for(lock, interval);
+                }
+            }
+            const std::int64_t start = now();
+            std::int64_t oldest = mark.exchange(0, std::memory_order_relaxed);
+            if (oldest == 0)
+            {
+                // Output arrived while the previous batch was being written
+                oldest = previous;
+            }
+            previous = start;
+
+            bool active = drain();
+            if (spilling.load(std::memory_order_acquire))
+            {
+                // The producer no longer writes to the ring buffer, so
+                // everything written before the overflow is drained first.
+                active = drain() || active;
+                std::vector<value_type> batch;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    batch.swap(spill);
+                    if (batch.empty())
+                    {
+                        spilling.store(false, std::memory_order_release);
+                    }
+                }
+                if (!batch.empty())
+                {
+                    output(batch.data(), batch.size() * sizeof(value_type), nullptr, 0);
+                    active = true;
+                }
+            }
+            if (active)
+            {
+                const std::int64_t latency = now() - oldest;
+                batches.fetch_add(1, std::memory_order_relaxed);
+                total_latency.fetch_add(latency, std::memory_order_relaxed);
+                if (latency > max_latency.load(std::memory_order_relaxed))
+                {
+                    max_latency.store(latency, std::memory_order_relaxed);
+                }
+            }
+            drained.notify_all();
+        }
+        drained.notify_all();
+    }
+
+    bool drain()
+    {
+        const size_type first = tail.load(std::memory_order_relaxed);
+        const size_type last = head.load(std::memory_order_acquire);
+        if (first == last)
+            return false;
+
+        const size_type offset = first & (capacity - 1);
+        const size_type size = last - first;
+        const size_type before = std::min(size, capacity - offset);
+        output(ring.get() + offset, before * sizeof(value_type),
+               ring.get(), (size - before) * sizeof(value_type));
+        tail.store(last, std::memory_order_release);
+        return true;
+    }
+
+    void output(const value_type *first, size_type first_size,
+                const value_type *second, size_type second_size)
+    {
+        const size_type size = first_size + second_size;
+        if (!good())
+            return;
+
+        const char *head_data = reinterpret_cast<const char *>(first);
+        const char *tail_data = reinterpret_cast<const char *>(second);
+        while (first_size + second_size > 0)
+        {
+#if defined(_WIN32)
+            const char *data = (first_size > 0) ? head_data : tail_data;
+            const size_type length = (first_size > 0) ? first_size : second_size;
+            const int result = ::_write(fd, data, static_cast<unsigned int>(length));
+#else
+            struct iovec vec[2];
+            int count = 0;
+            if (first_size > 0)
+            {
+                vec[count].iov_base = const_cast<char *>(head_data);
+                vec[count].iov_len = first_size;
+                ++count;
+            }
+            if (second_size > 0)
+            {
+                vec[count].iov_base = const_cast<char *>(tail_data);
+                vec[count].iov_len = second_size;
+                ++count;
+            }
+            const ssize_t result = ::writev(fd, vec, count);
+#endif
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                failure = std::error_code(errno, std::system_category());
+                failed.store(true, std::memory_order_release);
+                return;
+            }
+            size_type done = static_cast<size_type>(result);
+            if (done >= first_size)
+            {
+                done -= first_size;
+                first_size = 0;
+                tail_data += done;
+                second_size -= done;
+            }
+            else
+            {
+                head_data += done;
+                first_size -= done;
+            }
+        }
+        written.fetch_add(size, std::memory_order_relaxed);
+    }
+
+private:
+    const int fd;
+    const backpressure::value policy;
+    const std::chrono::microseconds interval;
+    const size_type capacity;
+    std::unique_ptr<value_type[]> ring;
+
+    // Producer and consumer positions are kept on separate cache lines
+    alignas(64) std::atomic<size_type> head;
+    alignas(64) std::atomic<size_type> tail;
+    alignas(64) std::atomic<std::int64_t> mark;
+
+    std::atomic<bool> spilling;
+    std::vector<value_type> spill;
+
+    bool stopping;
+    std::atomic<bool> failed;
+    std::error_code failure;
+
+    std::atomic<std::uint64_t> written;
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<std::uint64_t> batches;
+    std::atomic<std::uint64_t> stalls;
+    std::atomic<std::int64_t> total_latency;
+    std::atomic<std::int64_t> max_latency;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable drained;
+    std::thread flusher;
+};
+
+using async_descriptor = basic_async_descriptor<char>;
+
+template <typename CharT>
+struct traits< basic_async_descriptor<CharT> >
+{
+    using buffer_type = detail::forward< basic_async_descriptor<CharT> >;
+};
+
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_ASYNC_DESCRIPTOR_HPP
@@ -0,0 +1,136 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_BUFFERED_OSTREAM_HPP
+#define TRIAL_PROTOCOL_BUFFER_BUFFERED_OSTREAM_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <ostream>
+#include <memory>
+#include <trial/protocol/core/char_traits.hpp>
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/buffer/detail/forward.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+
+//! @brief Block-buffered output stream sink.
+//!
+//! Output is collected in a fixed-size block that is handed to the stream
+//! buffer in large chunks. Pending output is flushed when the sink is
+//! destroyed.
+template <typename CharT, typename Traits = core::char_traits<CharT>>
+class basic_buffered_ostream
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using view_type = typename base<CharT>::view_type;
+    using stream_type = std::basic_ostream<CharT, Traits>;
+
+    static const size_type default_capacity = 4096;
+
+    explicit basic_buffered_ostream(stream_type& stream,
+                                    size_type capacity = default_capacity)
+        : stream(stream),
+          block(new value_type[capacity]),
+          capacity(capacity),
+          size(0)
+    {
+    }
+
+    basic_buffered_ostream(const basic_buffered_ostream&) = delete;
+    basic_buffered_ostream& operator= (const basic_buffered_ostream&) = delete;
+
+    ~basic_buffered_ostream()
+    {
+        flush();
+    }
+
+    //! @brief Writes pending output to the stream.
+    bool flush()
+    {
+        if (size > 0)
+        {
+            put(block.get(), size);
+            size = 0;
+        }
+        return stream.good();
+    }
+
+    bool good() const
+    {
+        return stream.good();
+    }
+
+    bool grow(size_type)
+    {
+        return stream.good();
+    }
+
+    void write(value_type value)
+    {
+        if (size == capacity)
+        {
+            flush();
+        }
+        block[size++] = value;
+    }
+
+    void write(const view_type& view)
+    {
+        if (size + view.size() > capacity)
+        {
+            flush();
+            if (view.size() >= capacity)
+            {
+                // Bypass the block for large views
+                put(view.data(), view.size());
+                return;
+            }
+        }
+        Traits::copy(block.get() + size, view.data(), view.size());
+        size += view.size();
+    }
+
+private:
+    void put(const value_type *data, size_type length)
+    {
+        const std::streamsize count = length;
+        if (stream.rdbuf()->sputn(data, count) != count)
+        {
+            stream.setstate(std::ios_base::badbit);
+        }
+    }
+
+private:
+    stream_type& stream;
+    std::unique_ptr<value_type[]> block;
+    const size_type capacity;
+    size_type size;
+};
+
+using buffered_ostream = basic_buffered_ostream<char>;
+
+template <typename CharT, typename Traits>
+struct traits< basic_buffered_ostream<CharT, Traits> >
+{
+    using buffer_type = detail::forward< basic_buffered_ostream<CharT, Traits> >;
+};
+
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_BUFFERED_OSTREAM_HPP
@@ -0,0 +1,164 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_COMPRESSOR_HPP
+#define TRIAL_PROTOCOL_BUFFER_COMPRESSOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/buffer/detail/forward.hpp>
+#include <trial/protocol/buffer/detail/lz.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+
+//! @brief Compressing sink.
+//!
+//! Output is collected in blocks that are compressed independently and
+//! written as a frame to an output buffer of type T, which can be any type
+//! with buffer traits. Each flush() ends the current block, so a reader can
+//! later start decompressing at that position. Pending output is flushed
+//! when the sink is destroyed.
+//!
+//! @sa decompressor
+template <typename T>
+class compressor
+{
+    using buffer_type = typename traits<T>::buffer_type;
+
+public:
+    using value_type = typename buffer_type::value_type;
+    using size_type = std::size_t;
+    using view_type = typename base<value_type>::view_type;
+
+    static const size_type default_capacity = 64 * 1024;
+
+    explicit compressor(T& output,
+                        size_type capacity = default_capacity)
+        : sink(output),
+          capacity(capacity),
+          success(true)
+    {
+        assert(capacity > 0);
+        assert(capacity <= detail::lz::max_block_size);
+        static_assert(sizeof(value_type) == 1, "Character type must be a single byte");
+
+        block.reserve(capacity);
+        put(detail::lz::magic, detail::lz::magic_size);
+    }
+
+    compressor(const compressor&) = delete;
+    compressor& operator= (const compressor&) = delete;
+
+    ~compressor()
+    {
+        flush();
+    }
+
+    //! @brief Compresses pending output and writes it as a block.
+    bool flush()
+    {
+        if (!block.empty())
+        {
+            const size_type size = block.size();
+            scratch.resize(detail::lz::block_header_size + detail::lz::bound(size));
+            std::uint8_t *header = scratch.data();
+            std::uint8_t *payload = header + detail::lz::block_header_size;
+            std::uint32_t stored = static_cast<std::uint32_t>(detail::lz::compress(block.data(), size, payload));
+            if (stored >= size)
+            {
+                // Incompressible blocks are stored as is
+                std::memcpy(payload, block.data(), size);
+                stored = static_cast<std::uint32_t>(size) | detail::lz::stored_flag;
+            }
+            detail::lz::write32(header, static_cast<std::uint32_t>(size));
+            detail::lz::write32(header + sizeof(std::uint32_t), stored);
+            put(scratch.data(), detail::lz::block_header_size + (stored & ~detail::lz::stored_flag));
+            block.clear();
+        }
+        return success;
+    }
+
+    bool good() const
+    {
+        return success;
+    }
+
+    bool grow(size_type)
+    {
+        return success;
+    }
+
+    void write(value_type value)
+    {
+        if (block.size() == capacity)
+        {
+            flush();
+        }
+        block.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void write(const view_type& view)
+    {
+        const std::uint8_t *data = reinterpret_cast<const std::uint8_t *>(view.data());
+        size_type size = view.size();
+        while (size > 0)
+        {
+            if (block.size() == capacity)
+            {
+                flush();
+            }
+            const size_type count = std::min(size, capacity - block.size());
+            block.insert(block.end(), data, data + count);
+            data += count;
+            size -= count;
+        }
+    }
+
+private:
+    void put(const std::uint8_t *data, size_type size)
+    {
+        base<value_type>& output = sink;
+        if (!output.grow(size))
+        {
+            success = false;
+            return;
+        }
+        output.write(view_type(reinterpret_cast<const value_type *>(data), size));
+    }
+
+private:
+    buffer_type sink;
+    std::vector<std::uint8_t> block;
+    std::vector<std::uint8_t> scratch;
+    const size_type capacity;
+    bool success;
+};
+
+template <typename T>
+struct traits< compressor<T> >
+{
+    using buffer_type = detail::forward< compressor<T> >;
+};
+
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_COMPRESSOR_HPP
@@ -0,0 +1,182 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_DECOMPRESSOR_HPP
+#define TRIAL_PROTOCOL_BUFFER_DECOMPRESSOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <trial/protocol/core/char_traits.hpp>
+#include <trial/protocol/core/detail/string_view.hpp>
+#include <trial/protocol/buffer/detail/lz.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+
+//! @brief Input adapter for frames written by compressor.
+//!
+//! The block headers are indexed on construction without decompressing the
+//! payloads. Decompression can start at any block, so the input can be
+//! positioned at a block boundary without decompressing the preceding blocks.
+//!
+//! @sa compressor
+template <typename CharT>
+class basic_decompressor
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using view_type = core::detail::basic_string_view<value_type, core::char_traits<value_type>>;
+
+    static const size_type npos = size_type(-1);
+
+    //! @brief Indexes the blocks of a frame.
+    //!
+    //! The frame must outlive the decompressor. Use good() to check if the
+    //! frame is well-formed.
+    explicit basic_decompressor(const view_type& frame)
+        : total(0),
+          success(false)
+    {
+        static_assert(sizeof(value_type) == 1, "Character type must be a single byte");
+
+        const std::uint8_t *input = reinterpret_cast<const std::uint8_t *>(frame.data());
+        const std::uint8_t *last = input + frame.size();
+        if ((frame.size() < detail::lz::magic_size) ||
+            (std::memcmp(input, detail::lz::magic, detail::lz::magic_size) != 0))
+            return;
+        input += detail::lz::magic_size;
+
+        size_type offset = 0;
+        while (input != last)
+        {
+            if (size_type(last - input) < detail::lz::block_header_size)
+                return;
+            entry current;
+            current.raw = detail::lz::read32(input);
+            const std::uint32_t stored = detail::lz::read32(input + sizeof(std::uint32_t));
+            current.is_stored = (stored & detail::lz::stored_flag) != 0;
+            current.size = stored & ~detail::lz::stored_flag;
+            input += detail::lz::block_header_size;
+            if ((current.size > size_type(last - input)) ||
+                (current.is_stored && (current.size != current.raw)) ||
+                (current.raw > std::numeric_limits<size_type>::max() - offset))
+                return;
+            current.data = input;
+            current.offset = offset;
+            blocks.push_back(current);
+            input += current.size;
+            offset += current.raw;
+        }
+        total = offset;
+        success = true;
+    }
+
+    template <typename T>
+    explicit basic_decompressor(const T& frame)
+        : basic_decompressor(view_type(reinterpret_cast<const value_type *>(frame.data()), frame.size()))
+    {
+    }
+
+    bool good() const
+    {
+        return success;
+    }
+
+    //! @brief Returns the number of blocks.
+    size_type size() const
+    {
+        return blocks.size();
+    }
+
+    //! @brief Returns the number of uncompressed bytes in the frame.
+    size_type raw_size() const
+    {
+        return total;
+    }
+
+    //! @brief Returns the uncompressed position where a block starts.
+    size_type offset(size_type index) const
+    {
+        return (index < blocks.size()) ? blocks[index].offset : total;
+    }
+
+    //! @brief Returns the block that contains an uncompressed position.
+    size_type find(size_type position) const
+    {
+        auto where = std::upper_bound(blocks.begin(), blocks.end(), position,
+                                      [] (size_type lhs, const entry& rhs) { return lhs < rhs.offset; });
+        return (where == blocks.begin()) ? 0 : size_type(where - blocks.begin()) - 1;
+    }
+
+    //! @brief Appends the uncompressed content of blocks [first, last) to output.
+    //!
+    //! @returns False if a block is malformed.
+    template <typename Allocator>
+    bool read(std::vector<value_type, Allocator>& output,
+              size_type first = 0,
+              size_type last = npos)
+    {
+        if (!success)
+            return false;
+        last = std::min(last, blocks.size());
+        if (first >= last)
+            return true;
+
+        const size_type start = output.size();
+        output.resize(start + offset(last) - offset(first));
+        std::uint8_t *cursor = reinterpret_cast<std::uint8_t *>(output.data() + start);
+        for (size_type index = first; index < last; ++index)
+        {
+            const entry& current = blocks[index];
+            if (current.is_stored)
+            {
+                std::memcpy(cursor, current.data, current.raw);
+            }
+            else if (!detail::lz::decompress(current.data, current.size, cursor, current.raw))
+            {
+                output.resize(start);
+                return false;
+            }
+            cursor += current.raw;
+        }
+        return true;
+    }
+
+private:
+    struct entry
+    {
+        const std::uint8_t *data;
+        size_type size;
+        size_type raw;
+        size_type offset;
+        bool is_stored;
+    };
+
+    std::vector<entry> blocks;
+    size_type total;
+    bool success;
+};
+
+using decompressor = basic_decompressor<char>;
+
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_DECOMPRESSOR_HPP
@@ -0,0 +1,202 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_DESCRIPTOR_HPP
+#define TRIAL_PROTOCOL_BUFFER_DESCRIPTOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <system_error>
+#if defined(_WIN32)
+# include <io.h>
+#else
+# include <unistd.h>
+# include <sys/uio.h>
+#endif
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/buffer/detail/forward.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+
+//! @brief Block-buffered file descriptor sink.
+//!
+//! Output is collected in a fixed-size block and written to the file
+//! descriptor with as few system calls as possible. The file descriptor
+//! is not closed by the sink. Pending output is flushed when the sink is
+//! destroyed.
+template <typename CharT>
+class basic_descriptor
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using view_type = typename base<CharT>::view_type;
+
+    static const size_type default_capacity = 64 * 1024;
+
+    explicit basic_descriptor(int fd,
+                              size_type capacity = default_capacity)
+        : fd(fd),
+          block(new value_type[capacity]),
+          capacity(capacity),
+          size(0)
+    {
+    }
+
+    basic_descriptor(const basic_descriptor&) = delete;
+    basic_descriptor& operator= (const basic_descriptor&) = delete;
+
+    ~basic_descriptor()
+    {
+        flush();
+    }
+
+    //! @brief Writes pending output to the file descriptor.
+    bool flush()
+    {
+        if (size > 0)
+        {
+            put(block.get(), size * sizeof(value_type));
+            size = 0;
+        }
+        return good();
+    }
+
+    bool good() const
+    {
+        return !failure;
+    }
+
+    //! @brief Returns the error of the first failed write.
+    const std::error_code& error() const
+    {
+        return failure;
+    }
+
+    bool grow(size_type)
+    {
+        return good();
+    }
+
+    void write(value_type value)
+    {
+        if (size == capacity)
+        {
+            flush();
+        }
+        block[size++] = value;
+    }
+
+    void write(const view_type& view)
+    {
+        if (size + view.size() > capacity)
+        {
+            if (view.size() >= capacity)
+            {
+                // Bypass the block for large views
+                put(view.data(), view.size() * sizeof(value_type));
+                return;
+            }
+            flush();
+        }
+        std::memcpy(block.get() + size, view.data(), view.size() * sizeof(value_type));
+        size += view.size();
+    }
+
+private:
+    // Writes pending output followed by data
+    void put(const value_type *data, size_type length)
+    {
+        const char *head = reinterpret_cast<const char *>(block.get());
+        size_type head_size = size * sizeof(value_type);
+        const char *tail = reinterpret_cast<const char *>(data);
+        size_type tail_size = length;
+        if (data == block.get())
+        {
+            head_size = 0;
+        }
+        size = 0;
+        if (failure)
+            return;
+
+        while (head_size + tail_size > 0)
+        {
+#if defined(_WIN32)
+            const char *first = (head_size > 0) ? head : tail;
+            const size_type first_size = (head_size > 0) ? head_size : tail_size;
+            const int result = ::_write(fd, first, static_cast<unsigned int>(first_size));
+#else
+            struct iovec vec[2];
+            int count = 0;
+            if (head_size > 0)
+            {
+                vec[count].iov_base = const_cast<char *>(head);
+                vec[count].iov_len = head_size;
+                ++count;
+            }
+            if (tail_size > 0)
+            {
+                vec[count].iov_base = const_cast<char *>(tail);
+                vec[count].iov_len = tail_size;
+                ++count;
+            }
+            const ssize_t result = ::writev(fd, vec, count);
+#endif
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                failure = std::error_code(errno, std::system_category());
+                return;
+            }
+            size_type written = static_cast<size_type>(result);
+            if (written >= head_size)
+            {
+                written -= head_size;
+                head_size = 0;
+                tail += written;
+                tail_size -= written;
+            }
+            else
+            {
+                head += written;
+                head_size -= written;
+            }
+        }
+    }
+
+private:
+    const int fd;
+    std::unique_ptr<value_type[]> block;
+    const size_type capacity;
+    size_type size;
+    std::error_code failure;
+};
+
+using descriptor = basic_descriptor<char>;
+
+template <typename CharT>
+struct traits< basic_descriptor<CharT> >
+{
+    using buffer_type = detail::forward< basic_descriptor<CharT> >;
+};
+
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_DESCRIPTOR_HPP
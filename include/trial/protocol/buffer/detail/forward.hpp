@@ -0,0 +1,70 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_DETAIL_FORWARD_HPP
+#define TRIAL_PROTOCOL_BUFFER_DETAIL_FORWARD_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <trial/protocol/buffer/base.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+namespace detail
+{
+
+// Buffer wrapper for sinks that carry their own state.
+//
+// The sink is owned by the user and must outlive the protocol generator.
+// Sink operations are non-virtual, so only a single indirection is incurred.
+
+template <typename Sink>
+class forward : public base<typename Sink::value_type>
+{
+    using super = base<typename Sink::value_type>;
+
+public:
+    using value_type = typename super::value_type;
+    using size_type = typename super::size_type;
+    using view_type = typename super::view_type;
+
+    forward(Sink& sink)
+        : sink(sink)
+    {
+    }
+
+protected:
+    virtual bool grow(size_type delta)
+    {
+        return sink.grow(delta);
+    }
+
+    virtual void write(value_type value)
+    {
+        sink.write(value);
+    }
+
+    virtual void write(const view_type& view)
+    {
+        sink.write(view);
+    }
+
+private:
+    Sink& sink;
+};
+
+} // namespace detail
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_DETAIL_FORWARD_HPP
@@ -0,0 +1,305 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_DETAIL_LZ_HPP
+#define TRIAL_PROTOCOL_BUFFER_DETAIL_LZ_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <array>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+namespace detail
+{
+namespace lz
+{
+
+// Block codec in the LZ77 family with an LZ4-like sequence format.
+//
+// A compressed block is a series of sequences
+//
+//   token    : uint8, literal length (high nibble) and match length - 4 (low)
+//   literals : extra literal length bytes followed by the literals
+//   offset   : uint16, little-endian distance back to the match (1 - 65535)
+//   match    : extra match length bytes
+//
+// A nibble value of 15 is followed by extra length bytes that are added to
+// it. Each extra byte of 255 means that another extra byte follows. The last
+// sequence only contains literals and ends the block. Blocks are independent
+// so they can be decompressed in any order.
+
+const std::size_t min_match = 4;
+const std::size_t max_offset = 0xFFFF;
+// Matches must not start within the last bytes of a block, and must leave
+// room for trailing literals.
+const std::size_t match_limit = 12;
+const std::size_t last_literals = 5;
+const unsigned int hash_bits = 12;
+
+//! @brief Returns the maximum compressed size of size bytes.
+inline std::size_t bound(std::size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+inline std::uint32_t load32(const std::uint8_t *input)
+{
+    std::uint32_t result;
+    std::memcpy(&result, input, sizeof(result));
+    return result;
+}
+
+inline std::uint64_t load64(const std::uint8_t *input)
+{
+    std::uint64_t result;
+    std::memcpy(&result, input, sizeof(result));
+    return result;
+}
+
+inline std::uint32_t hash(std::uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - hash_bits);
+}
+
+inline std::uint8_t *write_length(std::uint8_t *output, std::size_t length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        *output++ = 255;
+    }
+    *output++ = static_cast<std::uint8_t>(length);
+    return output;
+}
+
+inline std::uint8_t *write_literals(std::uint8_t *output,
+                                    std::uint8_t *token,
+                                    const std::uint8_t *literals,
+                                    std::size_t length)
+{
+    if (length >= 15)
+    {
+        *token = 15 << 4;
+        output = write_length(output, length - 15);
+    }
+    else
+    {
+        *token = static_cast<std::uint8_t>(length << 4);
+    }
+    if (length > 0)
+    {
+        std::memcpy(output, literals, length);
+    }
+    return output + length;
+}
+
+//! @brief Compresses [input, input + size) into output.
+//!
+//! The output must have room for bound(size) bytes.
+//!
+//! @returns Number of bytes written.
+inline std::size_t compress(const std::uint8_t *input,
+                            std::size_t size,
+                            std::uint8_t *output)
+{
+    std::uint8_t *first = output;
+    std::size_t anchor = 0;
+
+    if (size > match_limit)
+    {
+        // Positions of recently seen four-byte sequences. Candidates are
+        // verified before use, so stale or colliding entries are harmless.
+        std::array<std::uint32_t, (1U << hash_bits)> table;
+        table.fill(0);
+
+        const std::size_t limit = size - match_limit;
+        const std::size_t match_end = size - last_literals;
+        std::size_t i = 1;
+        table[hash(load32(input))] = 0;
+        while (i < limit)
+        {
+            const std::uint32_t sequence = load32(input + i);
+            std::uint32_t& entry = table[hash(sequence)];
+            const std::size_t candidate = entry;
+            entry = static_cast<std::uint32_t>(i);
+            if ((i - candidate > max_offset) || (load32(input + candidate) != sequence))
+            {
+                // Skip faster through incompressible input
+                i += 1 + ((i - anchor) >> 6);
+                continue;
+            }
+
+            // Extend the match eight bytes at a time
+            std::size_t length = min_match;
+            while (i + length + sizeof(std::uint64_t) <= match_end)
+            {
+                if (load64(input + candidate + length) != load64(input + i + length))
+                    break;
+                length += sizeof(std::uint64_t);
+            }
+            while ((i + length < match_end) && (input[candidate + length] == input[i + length]))
+            {
+                ++length;
+            }
+
+            std::uint8_t *token = output++;
+            output = write_literals(output, token, input + anchor, i - anchor);
+            const std::size_t offset = i - candidate;
+            *output++ = static_cast<std::uint8_t>(offset);
+            *output++ = static_cast<std::uint8_t>(offset >> 8);
+            const std::size_t extra = length - min_match;
+            if (extra >= 15)
+            {
+                *token |= 15;
+                output = write_length(output, extra - 15);
+            }
+            else
+            {
+                *token |= static_cast<std::uint8_t>(extra);
+            }
+
+            i += length;
+            anchor = i;
+        }
+    }
+
+    std::uint8_t *token = output++;
+    output = write_literals(output, token, input + anchor, size - anchor);
+    return output - first;
+}
+
+inline bool read_length(const std::uint8_t *& input,
+                        const std::uint8_t *last,
+                        std::size_t& length)
+{
+    std::uint8_t byte;
+    do
+    {
+        if (input == last)
+            return false;
+        byte = *input++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+//! @brief Decompresses [input, input + input_size) into exactly output_size
+//! bytes of output.
+//!
+//! @returns False if the input is malformed.
+inline bool decompress(const std::uint8_t *input,
+                       std::size_t input_size,
+                       std::uint8_t *output,
+                       std::size_t output_size)
+{
+    const std::uint8_t *const input_end = input + input_size;
+    std::uint8_t *const output_begin = output;
+    std::uint8_t *const output_end = output + output_size;
+
+    while (input != input_end)
+    {
+        const std::uint8_t token = *input++;
+
+        std::size_t literals = token >> 4;
+        if ((literals == 15) && !read_length(input, input_end, literals))
+            return false;
+        if ((literals > std::size_t(input_end - input)) || (literals > std::size_t(output_end - output)))
+            return false;
+        if (literals > 0)
+        {
+            std::memcpy(output, input, literals);
+        }
+        input += literals;
+        output += literals;
+
+        if (input == input_end)
+            return output == output_end;
+
+        if (input_end - input < 2)
+            return false;
+        const std::size_t offset = input[0] | (std::size_t(input[1]) << 8);
+        input += 2;
+        if ((offset == 0) || (offset > std::size_t(output - output_begin)))
+            return false;
+
+        std::size_t length = token & 0x0F;
+        if ((length == 15) && !read_length(input, input_end, length))
+            return false;
+        length += min_match;
+        if (length > std::size_t(output_end - output))
+            return false;
+
+        const std::uint8_t *match = output - offset;
+        if (offset >= sizeof(std::uint64_t))
+        {
+            // Chunks do not overlap, although the match may overlap output
+            for (; length >= sizeof(std::uint64_t); length -= sizeof(std::uint64_t))
+            {
+                std::memcpy(output, match, sizeof(std::uint64_t));
+                output += sizeof(std::uint64_t);
+                match += sizeof(std::uint64_t);
+            }
+        }
+        for (; length > 0; --length)
+        {
+            *output++ = *match++;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Frame format
+//-----------------------------------------------------------------------------
+
+// A frame starts with the four magic bytes "TPLZ" followed by blocks
+//
+//   raw size    : uint32, number of uncompressed bytes
+//   stored size : uint32, number of payload bytes. The high bit is set if
+//                 the payload is stored uncompressed
+//   payload     : compressed or stored bytes
+//
+// All fields are little-endian. Blocks can be located by walking the block
+// headers without decompressing the payloads.
+
+const std::uint8_t magic[] = { 'T', 'P', 'L', 'Z' };
+const std::size_t magic_size = sizeof(magic);
+const std::size_t block_header_size = 2 * sizeof(std::uint32_t);
+const std::uint32_t stored_flag = 0x80000000U;
+const std::size_t max_block_size = 0x7FFFFFFFU;
+
+inline void write32(std::uint8_t *output, std::uint32_t value)
+{
+    output[0] = static_cast<std::uint8_t>(value);
+    output[1] = static_cast<std::uint8_t>(value >> 8);
+    output[2] = static_cast<std::uint8_t>(value >> 16);
+    output[3] = static_cast<std::uint8_t>(value >> 24);
+}
+
+inline std::uint32_t read32(const std::uint8_t *input)
+{
+    return std::uint32_t(input[0])
+        | (std::uint32_t(input[1]) << 8)
+        | (std::uint32_t(input[2]) << 16)
+        | (std::uint32_t(input[3]) << 24);
+}
+
+} // namespace lz
+} // namespace detail
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_DETAIL_LZ_HPP
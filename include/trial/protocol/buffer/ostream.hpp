@@ -39,14 +39,24 @@ protected:
         return content.good();
     }
 
+    // Bypass formatted output to avoid sentry construction and locale
+    // lookups for each write.
+
     virtual void write(value_type value)
     {
-        content << value;
+        if (Traits::eq_int_type(content.rdbuf()->sputc(value), Traits::eof()))
+        {
+            content.setstate(std::ios_base::badbit);
+        }
     }
 
     virtual void write(const view_type& view)
     {
-        content << view;
+        const std::streamsize size = view.size();
+        if (content.rdbuf()->sputn(view.data(), size) != size)
+        {
+            content.setstate(std::ios_base::badbit);
+        }
     }
 
 private:
@@ -0,0 +1,268 @@
+#ifndef TRIAL_PROTOCOL_BUFFER_SEGMENTED_HPP
+#define TRIAL_PROTOCOL_BUFFER_SEGMENTED_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+# include <sys/uio.h>
+#endif
+#include <trial/protocol/core/char_traits.hpp>
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/buffer/detail/forward.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace buffer
+{
+
+//! @brief Pool of fixed-size memory blocks.
+//!
+//! Blocks released to the pool are kept for reuse until the pool is
+//! destroyed. The pool can be shared by several segmented buffers, but
+//! it is not thread-safe.
+template <typename CharT>
+class basic_segment_pool
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using block_type = std::unique_ptr<value_type[]>;
+
+    static const size_type default_block_size = 4096;
+
+    explicit basic_segment_pool(size_type block_size = default_block_size)
+        : length(std::max<size_type>(block_size, 1))
+    {
+    }
+
+    basic_segment_pool(const basic_segment_pool&) = delete;
+    basic_segment_pool& operator= (const basic_segment_pool&) = delete;
+
+    //! @brief Returns the size of each block.
+    size_type block_size() const
+    {
+        return length;
+    }
+
+    //! @brief Returns the number of blocks available for reuse.
+    size_type available() const
+    {
+        return blocks.size();
+    }
+
+    block_type acquire()
+    {
+        if (blocks.empty())
+            return block_type(new value_type[length]);
+        block_type result = std::move(blocks.back());
+        blocks.pop_back();
+        return result;
+    }
+
+    void release(block_type block)
+    {
+        blocks.push_back(std::move(block));
+    }
+
+private:
+    const size_type length;
+    std::vector<block_type> blocks;
+};
+
+//! @brief Segmented output buffer.
+//!
+//! Output is appended into a chain of fixed-size blocks drawn from a pool,
+//! so existing output is never reallocated or copied when the buffer grows.
+//! The blocks are returned to the pool by reset().
+template <typename CharT>
+class basic_segmented
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using view_type = typename base<CharT>::view_type;
+    using string_type = std::basic_string<value_type, core::char_traits<value_type>>;
+    using pool_type = basic_segment_pool<CharT>;
+
+    //! @brief Creates segmented buffer with its own pool.
+    explicit basic_segmented(size_type block_size = pool_type::default_block_size)
+        : own_pool(new pool_type(block_size)),
+          pool(own_pool.get()),
+          total(0)
+    {
+    }
+
+    //! @brief Creates segmented buffer that draws blocks from a shared pool.
+    //!
+    //! The pool must outlive the segmented buffer.
+    explicit basic_segmented(pool_type& pool)
+        : pool(&pool),
+          total(0)
+    {
+    }
+
+    basic_segmented(const basic_segmented&) = delete;
+    basic_segmented& operator= (const basic_segmented&) = delete;
+
+    ~basic_segmented()
+    {
+        reset();
+    }
+
+    //! @brief Returns the number of characters in the buffer.
+    size_type size() const
+    {
+        return total;
+    }
+
+    bool empty() const
+    {
+        return total == 0;
+    }
+
+    //! @brief Returns the number of segments in the buffer.
+    size_type segment_count() const
+    {
+        return segments.size();
+    }
+
+    //! @brief Returns the content of a segment.
+    view_type segment(size_type index) const
+    {
+        return view_type(segments[index].data.get(), segments[index].size);
+    }
+
+    //! @brief Removes all content and returns the blocks to the pool.
+    void reset()
+    {
+        for (auto& entry : segments)
+        {
+            pool->release(std::move(entry.data));
+        }
+        segments.clear();
+        total = 0;
+    }
+
+    //! @brief Returns a contiguous copy of the content.
+    string_type str() const
+    {
+        string_type result;
+        result.reserve(total);
+        for (const auto& entry : segments)
+        {
+            result.append(entry.data.get(), entry.size);
+        }
+        return result;
+    }
+
+#if !defined(_WIN32)
+    //! @brief Exports segments as I/O vectors.
+    //!
+    //! Fills at most @c count I/O vectors with segments starting at segment
+    //! index @c first, and returns the number of I/O vectors filled.
+    size_type iovec(struct ::iovec *output, size_type count, size_type first = 0) const
+    {
+        size_type filled = 0;
+        for (size_type index = first;
+             (index < segments.size()) && (filled < count);
+             ++index, ++filled)
+        {
+            output[filled].iov_base = const_cast<value_type *>(segments[index].data.get());
+            output[filled].iov_len = segments[index].size * sizeof(value_type);
+        }
+        return filled;
+    }
+
+    //! @brief Exports all segments as I/O vectors.
+    std::vector<struct ::iovec> iovec() const
+    {
+        std::vector<struct ::iovec> result(segments.size());
+        iovec(result.data(), result.size());
+        return result;
+    }
+#endif
+
+    bool grow(size_type)
+    {
+        return true;
+    }
+
+    void write(value_type value)
+    {
+        if (segments.empty() || segments.back().size == pool->block_size())
+        {
+            append();
+        }
+        auto& entry = segments.back();
+        entry.data[entry.size++] = value;
+        ++total;
+    }
+
+    void write(const view_type& view)
+    {
+        const value_type *data = view.data();
+        size_type remaining = view.size();
+        while (remaining > 0)
+        {
+            if (segments.empty() || segments.back().size == pool->block_size())
+            {
+                append();
+            }
+            auto& entry = segments.back();
+            const size_type count = std::min(remaining, pool->block_size() - entry.size);
+            std::memcpy(entry.data.get() + entry.size, data, count * sizeof(value_type));
+            entry.size += count;
+            data += count;
+            remaining -= count;
+        }
+        total += view.size();
+    }
+
+private:
+    void append()
+    {
+        segments.push_back(segment_type{ pool->acquire(), 0 });
+    }
+
+    struct segment_type
+    {
+        typename pool_type::block_type data;
+        size_type size;
+    };
+
+    std::unique_ptr<pool_type> own_pool;
+    pool_type *pool;
+    std::vector<segment_type> segments;
+    size_type total;
+};
+
+using segment_pool = basic_segment_pool<char>;
+using segmented = basic_segmented<char>;
+
+template <typename CharT>
+struct traits< basic_segmented<CharT> >
+{
+    using buffer_type = detail::forward< basic_segmented<CharT> >;
+};
+
+} // namespace buffer
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_BUFFER_SEGMENTED_HPP
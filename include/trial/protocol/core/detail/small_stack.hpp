@@ -0,0 +1,100 @@
+#ifndef TRIAL_PROTOCOL_CORE_DETAIL_SMALL_STACK_HPP
+#define TRIAL_PROTOCOL_CORE_DETAIL_SMALL_STACK_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <array>
+#include <vector>
+
+namespace trial
+{
+namespace protocol
+{
+namespace core
+{
+namespace detail
+{
+
+//! @brief Stack that keeps the first N elements inline.
+//!
+//! Only allocates memory when nested deeper than N.
+
+template <typename T, std::size_t N>
+class small_stack
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    small_stack()
+        : length(0)
+    {
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    size_type size() const
+    {
+        return length;
+    }
+
+    value_type& top()
+    {
+        assert(length > 0);
+        return (length <= N) ? head[length - 1] : tail.back();
+    }
+
+    const value_type& top() const
+    {
+        assert(length > 0);
+        return (length <= N) ? head[length - 1] : tail.back();
+    }
+
+    void push(const value_type& value)
+    {
+        if (length < N)
+            head[length] = value;
+        else
+            tail.push_back(value);
+        ++length;
+    }
+
+    void pop()
+    {
+        assert(length > 0);
+        if (length > N)
+            tail.pop_back();
+        --length;
+    }
+
+    void clear()
+    {
+        tail.clear();
+        length = 0;
+    }
+
+private:
+    size_type length;
+    std::array<value_type, N> head;
+    std::vector<value_type> tail;
+};
+
+} // namespace detail
+} // namespace core
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_CORE_DETAIL_SMALL_STACK_HPP
@@ -38,6 +38,9 @@ public:
         case unexpected_token:
             return "unexpected token";
 
+        case invalid_key:
+            return "invalid key";
+
         case invalid_value:
             return "invalid value";
 
@@ -231,6 +231,54 @@ auto basic_reader<CharT>::tail() const BOOST_NOEXCEPT -> const view_type&
     return decoder.tail();
 }
 
+template <typename CharT>
+auto basic_reader<CharT>::subtree_literal() -> view_type
+{
+    const value_type *first = literal().data();
+
+    switch (code())
+    {
+    case token::code::begin_array:
+    case token::code::begin_object:
+        {
+            const bool is_array = (code() == token::code::begin_array);
+            const size_type depth = level() + 1;
+            while (true)
+            {
+                if (!next())
+                {
+                    if (code() == token::code::end)
+                    {
+                        throw json::error(is_array ? expected_end_array : expected_end_object);
+                    }
+                    throw json::error(error());
+                }
+                if (level() == depth)
+                {
+                    const token::code::value current = code();
+                    if ((current == token::code::end_array) || (current == token::code::end_object))
+                        break;
+                }
+            }
+        }
+        break;
+
+    case token::code::end_array:
+    case token::code::end_object:
+    case token::code::end:
+        throw json::error(unexpected_token);
+
+    default:
+        if (token::category::convert(code()) == token::category::status)
+            throw json::error(error());
+        break;
+    }
+
+    const value_type *last = literal().data() + literal().size();
+    next();
+    return view_type(first, last - first);
+}
+
 template <typename CharT>
 template <typename ReturnType>
 ReturnType basic_reader<CharT>::bool_value() const
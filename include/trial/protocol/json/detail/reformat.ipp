@@ -0,0 +1,388 @@
+#ifndef TRIAL_PROTOCOL_JSON_DETAIL_REFORMAT_IPP
+#define TRIAL_PROTOCOL_JSON_DETAIL_REFORMAT_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <trial/protocol/json/detail/traits.hpp>
+#include <trial/protocol/json/detail/scan.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace json
+{
+namespace detail
+{
+
+template <typename CharT>
+class basic_reformatter
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using buffer_type = buffer::base<value_type>;
+    using view_type = typename buffer_type::view_type;
+
+    basic_reformatter(buffer_type& buffer, const json::style& style)
+        : buffer(buffer),
+          layout(style.type()),
+          width(style.width()),
+          state(expect::value),
+          pending_first(nullptr),
+          pending_last(nullptr),
+          size(0),
+          failed(false)
+    {
+        indentation.push_back(traits<value_type>::alpha_newline);
+    }
+
+    size_type process(const view_type& input)
+    {
+        const value_type *cursor = input.data();
+        const value_type *last = cursor + input.size();
+
+        while (true)
+        {
+            cursor = skip_whitespace(cursor, last);
+            if (cursor == last)
+                break;
+
+            switch (*cursor)
+            {
+            case traits<value_type>::alpha_brace_open:
+            case traits<value_type>::alpha_bracket_open:
+                {
+                    begin_value();
+                    frame entry;
+                    entry.object = (*cursor == traits<value_type>::alpha_brace_open);
+                    entry.single_line = (layout == json::style::layout::compact_arrays)
+                        && !entry.object
+                        && is_scalar_array(cursor + 1, last);
+                    entry.count = 0;
+                    emit(cursor, cursor + 1);
+                    ++cursor;
+                    stack.push_back(entry);
+                    state = entry.object ? expect::key_or_end : expect::value_or_end;
+                }
+                break;
+
+            case traits<value_type>::alpha_brace_close:
+            case traits<value_type>::alpha_bracket_close:
+                {
+                    const bool object = (*cursor == traits<value_type>::alpha_brace_close);
+                    if (stack.empty())
+                        throw json::error(object ? unbalanced_end_object : unbalanced_end_array);
+                    if (stack.back().object != object)
+                        throw json::error(stack.back().object ? expected_end_object : expected_end_array);
+                    if ((state != expect::separator_or_end) && (state != expect::key_or_end) && (state != expect::value_or_end))
+                        throw json::error(unexpected_token);
+                    if ((stack.back().count > 0) && !stack.back().single_line)
+                    {
+                        newline(stack.size() - 1);
+                    }
+                    emit(cursor, cursor + 1);
+                    ++cursor;
+                    stack.pop_back();
+                    end_value();
+                }
+                break;
+
+            case traits<value_type>::alpha_comma:
+                if (state != expect::separator_or_end)
+                    throw json::error(unexpected_token);
+                emit(cursor, cursor + 1);
+                ++cursor;
+                state = stack.back().object ? expect::key : expect::value;
+                break;
+
+            case traits<value_type>::alpha_colon:
+                if (state != expect::colon)
+                    throw json::error(unexpected_token);
+                emit(cursor, cursor + 1);
+                ++cursor;
+                if (layout != json::style::layout::minify)
+                {
+                    static const value_type space = traits<value_type>::alpha_space;
+                    generate(&space, 1);
+                }
+                state = expect::value;
+                break;
+
+            case traits<value_type>::alpha_quote:
+                {
+                    const value_type *end = scan_string(cursor + 1, last);
+                    if ((state == expect::key) || (state == expect::key_or_end))
+                    {
+                        ++stack.back().count;
+                        newline(stack.size());
+                        emit(cursor, end);
+                        state = expect::colon;
+                    }
+                    else
+                    {
+                        begin_value();
+                        emit(cursor, end);
+                        end_value();
+                    }
+                    cursor = end;
+                }
+                break;
+
+            default:
+                {
+                    if ((state == expect::key) || (state == expect::key_or_end))
+                        throw json::error(invalid_key);
+                    const value_type *end = scan_literal(cursor, last);
+                    if ((end == cursor) || !is_literal(*cursor))
+                        throw json::error(invalid_value);
+                    begin_value();
+                    emit(cursor, end);
+                    end_value();
+                    cursor = end;
+                }
+                break;
+            }
+        }
+
+        if (!stack.empty())
+            throw json::error(stack.back().object ? expected_end_object : expected_end_array);
+        flush();
+        return failed ? 0 : size;
+    }
+
+private:
+    enum class expect
+    {
+        value,
+        value_or_end,
+        key,
+        key_or_end,
+        colon,
+        separator_or_end,
+        end
+    };
+
+    struct frame
+    {
+        bool object;
+        bool single_line;
+        size_type count;
+    };
+
+    void begin_value()
+    {
+        if ((state != expect::value) && (state != expect::value_or_end))
+            throw json::error(unexpected_token);
+
+        if (stack.empty() || stack.back().object)
+            return;
+
+        frame& top = stack.back();
+        if (top.single_line)
+        {
+            if (top.count > 0)
+            {
+                static const value_type space = traits<value_type>::alpha_space;
+                generate(&space, 1);
+            }
+        }
+        else
+        {
+            newline(stack.size());
+        }
+        ++top.count;
+    }
+
+    void end_value()
+    {
+        state = stack.empty() ? expect::end : expect::separator_or_end;
+    }
+
+    void newline(size_type depth)
+    {
+        if (layout == json::style::layout::minify)
+            return;
+
+        const size_type length = 1 + depth * width;
+        if (indentation.size() < length)
+        {
+            indentation.resize(length, traits<value_type>::alpha_space);
+        }
+        generate(indentation.data(), length);
+    }
+
+    static bool is_literal(value_type value)
+    {
+        return traits<value_type>::is_digit(value)
+            || (value == traits<value_type>::alpha_minus)
+            || (value == traits<value_type>::alpha_f)
+            || (value == traits<value_type>::alpha_n)
+            || (value == traits<value_type>::alpha_t);
+    }
+
+    static bool is_delimiter(value_type value)
+    {
+        switch (value)
+        {
+        case traits<value_type>::alpha_comma:
+        case traits<value_type>::alpha_colon:
+        case traits<value_type>::alpha_quote:
+        case traits<value_type>::alpha_brace_open:
+        case traits<value_type>::alpha_brace_close:
+        case traits<value_type>::alpha_bracket_open:
+        case traits<value_type>::alpha_bracket_close:
+            return true;
+        default:
+            return traits<value_type>::is_space(value);
+        }
+    }
+
+    // Returns position after the closing quote
+    static const value_type *scan_string(const value_type *first, const value_type *last)
+    {
+        while (true)
+        {
+            first = find_string_delimiter(first, last);
+            if (first == last)
+                throw json::error(invalid_value);
+            if (*first == traits<value_type>::alpha_quote)
+                return first + 1;
+            // Skip escaped character
+            if (last - first < 2)
+                throw json::error(invalid_value);
+            first += 2;
+        }
+    }
+
+    static const value_type *scan_literal(const value_type *first, const value_type *last)
+    {
+        while ((first != last) && !is_delimiter(*first))
+        {
+            ++first;
+        }
+        return first;
+    }
+
+    // Checks if the array only contains scalar values
+    static bool is_scalar_array(const value_type *first, const value_type *last)
+    {
+        while (true)
+        {
+            first = skip_whitespace(first, last);
+            if (first == last)
+                return false;
+
+            switch (*first)
+            {
+            case traits<value_type>::alpha_bracket_close:
+                return true;
+
+            case traits<value_type>::alpha_comma:
+                ++first;
+                break;
+
+            case traits<value_type>::alpha_quote:
+                first = scan_string(first + 1, last);
+                break;
+
+            case traits<value_type>::alpha_brace_open:
+            case traits<value_type>::alpha_bracket_open:
+            case traits<value_type>::alpha_brace_close:
+            case traits<value_type>::alpha_colon:
+                return false;
+
+            default:
+                first = scan_literal(first, last);
+                break;
+            }
+        }
+    }
+
+    // Input spans are coalesced when they are adjacent
+    void emit(const value_type *first, const value_type *last)
+    {
+        if (first != pending_last)
+        {
+            flush();
+            pending_first = first;
+        }
+        pending_last = last;
+    }
+
+    void flush()
+    {
+        if (pending_first != pending_last)
+        {
+            write(pending_first, pending_last - pending_first);
+        }
+        pending_first = pending_last = nullptr;
+    }
+
+    void generate(const value_type *data, size_type length)
+    {
+        flush();
+        write(data, length);
+    }
+
+    void write(const value_type *data, size_type length)
+    {
+        if (failed)
+            return;
+        if (!buffer.grow(length))
+        {
+            failed = true;
+            return;
+        }
+        buffer.write(view_type(data, length));
+        size += length;
+    }
+
+private:
+    buffer_type& buffer;
+    const typename json::style::layout::value layout;
+    const size_type width;
+    expect state;
+    std::vector<frame> stack;
+    std::basic_string<value_type, core::char_traits<value_type>> indentation;
+    const value_type *pending_first;
+    const value_type *pending_last;
+    size_type size;
+    bool failed;
+};
+
+} // namespace detail
+
+template <typename CharT, typename T>
+std::size_t reformat(const core::detail::basic_string_view<CharT, core::char_traits<CharT>>& input,
+                     T& output,
+                     const style& layout)
+{
+    typename buffer::traits<T>::buffer_type buffer(output);
+    detail::basic_reformatter<CharT> reformatter(buffer, layout);
+    return reformatter.process(input);
+}
+
+template <typename T>
+std::size_t reformat(const core::detail::string_view& input,
+                     T& output,
+                     const style& layout)
+{
+    return reformat<char, T>(input, output, layout);
+}
+
+} // namespace json
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_JSON_DETAIL_REFORMAT_IPP
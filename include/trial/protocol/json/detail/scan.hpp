@@ -0,0 +1,133 @@
+#ifndef TRIAL_PROTOCOL_JSON_DETAIL_SCAN_HPP
+#define TRIAL_PROTOCOL_JSON_DETAIL_SCAN_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <type_traits>
+#include <trial/protocol/json/detail/traits.hpp>
+
+#if !defined(TRIAL_PROTOCOL_JSON_USE_SSE2)
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#  define TRIAL_PROTOCOL_JSON_USE_SSE2 1
+# endif
+#endif
+
+#if TRIAL_PROTOCOL_JSON_USE_SSE2
+# include <emmintrin.h>
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# endif
+#endif
+
+namespace trial
+{
+namespace protocol
+{
+namespace json
+{
+namespace detail
+{
+
+// Bulk scanning of JSON input.
+//
+// Processes 16 characters at a time with SSE2 when available.
+
+#if TRIAL_PROTOCOL_JSON_USE_SSE2
+
+inline unsigned int first_bit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+    unsigned long result;
+    _BitScanForward(&result, mask);
+    return result;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Returns bit mask of whitespaces in 16 characters
+inline unsigned int whitespace_mask(__m128i chunk)
+{
+    const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x20)),
+                                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x0A)));
+    const __m128i other = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x09)),
+                                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x0D)));
+    return _mm_movemask_epi8(_mm_or_si128(space, other));
+}
+
+// Returns bit mask of quotes and reverse solidi in 16 characters
+inline unsigned int delimiter_mask(__m128i chunk)
+{
+    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                                          _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))));
+}
+
+#endif
+
+//! @brief Returns first non-whitespace character in range, or last.
+template <typename CharT>
+const CharT *skip_whitespace(const CharT *first, const CharT *last)
+{
+    static_assert(sizeof(CharT) == 1, "Type not supported");
+
+    // Most tokens are separated by at most a single whitespace
+    if ((first == last) || !traits<CharT>::is_space(*first))
+        return first;
+    ++first;
+
+#if TRIAL_PROTOCOL_JSON_USE_SSE2
+    while (last - first >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+        const unsigned int mask = ~whitespace_mask(chunk) & 0xFFFF;
+        if (mask != 0)
+            return first + first_bit(mask);
+        first += 16;
+    }
+#endif
+    while ((first != last) && traits<CharT>::is_space(*first))
+    {
+        ++first;
+    }
+    return first;
+}
+
+//! @brief Returns first quote or reverse solidus in range, or last.
+template <typename CharT>
+const CharT *find_string_delimiter(const CharT *first, const CharT *last)
+{
+    static_assert(sizeof(CharT) == 1, "Type not supported");
+
+#if TRIAL_PROTOCOL_JSON_USE_SSE2
+    while (last - first >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+        const unsigned int mask = delimiter_mask(chunk);
+        if (mask != 0)
+            return first + first_bit(mask);
+        first += 16;
+    }
+#endif
+    while (first != last)
+    {
+        if ((*first == traits<CharT>::alpha_quote) || (*first == traits<CharT>::alpha_reverse_solidus))
+            return first;
+        ++first;
+    }
+    return first;
+}
+
+} // namespace detail
+} // namespace json
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_JSON_DETAIL_SCAN_HPP
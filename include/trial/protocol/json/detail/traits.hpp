@@ -68,6 +68,7 @@ public:
     BOOST_STATIC_CONSTANT(value_type, alpha_backspace = '\b');
     BOOST_STATIC_CONSTANT(value_type, alpha_formfeed = '\f');
     BOOST_STATIC_CONSTANT(value_type, alpha_newline = '\n');
+    BOOST_STATIC_CONSTANT(value_type, alpha_space = ' ');
     BOOST_STATIC_CONSTANT(value_type, alpha_tab = '\t');
     BOOST_STATIC_CONSTANT(value_type, alpha_return = '\r');
     BOOST_STATIC_CONSTANT(value_type, alpha_quote = '"');
@@ -134,6 +135,7 @@ public:
     BOOST_STATIC_CONSTANT(value_type, alpha_backspace = '\b');
     BOOST_STATIC_CONSTANT(value_type, alpha_formfeed = '\f');
     BOOST_STATIC_CONSTANT(value_type, alpha_newline = '\n');
+    BOOST_STATIC_CONSTANT(value_type, alpha_space = ' ');
     BOOST_STATIC_CONSTANT(value_type, alpha_tab = '\t');
     BOOST_STATIC_CONSTANT(value_type, alpha_return = '\r');
     BOOST_STATIC_CONSTANT(value_type, alpha_quote = '"');
@@ -143,12 +143,40 @@ auto basic_writer<CharT, N>::value(T&& data) -> size_type
     return encoder.value(std::forward<T>(data));
 }
 
+template <typename CharT, std::size_t N>
+auto basic_writer<CharT, N>::key(const key_type& data) -> size_type
+{
+    validate_scope(token::code::end_object, json::invalid_key);
+
+    frame& top = stack.top();
+    if (top.counter % 2 != 0)
+    {
+        last_error = json::invalid_key;
+        throw json::error(error());
+    }
+    const view_type view = (top.counter == 0)
+        ? data.literal()
+        : data.separated_literal();
+    top.counter += 1;
+    top.separated = true;
+    return encoder.literal(view);
+}
+
 template <typename CharT, std::size_t N>
 auto basic_writer<CharT, N>::literal(const view_type& data) BOOST_NOEXCEPT -> size_type
 {
     return encoder.literal(data);
 }
 
+template <typename CharT, std::size_t N>
+auto basic_writer<CharT, N>::subtree_literal(const view_type& data) -> size_type
+{
+    validate_scope();
+
+    stack.top().write_separator();
+    return encoder.literal(data);
+}
+
 template <typename CharT, std::size_t N>
 void basic_writer<CharT, N>::validate_scope()
 {
@@ -228,14 +256,20 @@ basic_writer<CharT, N>::frame::frame(encoder_type& encoder,
                                      token::code::value code)
     : encoder(encoder),
       code(code),
-      counter(0)
+      counter(0),
+      separated(false)
 {
 }
 
 template <typename CharT, std::size_t N>
 void basic_writer<CharT, N>::frame::write_separator()
 {
-    if (counter != 0)
+    if (separated)
+    {
+        // Separator already written with pre-encoded key
+        separated = false;
+    }
+    else if (counter != 0)
     {
         switch (code)
         {
@@ -0,0 +1,89 @@
+#ifndef TRIAL_PROTOCOL_JSON_KEY_HPP
+#define TRIAL_PROTOCOL_JSON_KEY_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+#include <trial/protocol/core/char_traits.hpp>
+#include <trial/protocol/core/detail/string_view.hpp>
+#include <trial/protocol/buffer/string.hpp>
+#include <trial/protocol/json/detail/encoder.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace json
+{
+
+template <typename CharT, std::size_t N> class basic_writer;
+
+//! @brief Pre-encoded object key.
+//!
+//! The key is quoted and escaped once at construction, so writing it only
+//! involves copying the encoded key and separators. Keys for fixed schemas
+//! are typically declared as static constants.
+template <typename CharT>
+class basic_key
+{
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using view_type = core::detail::basic_string_view<value_type, core::char_traits<value_type>>;
+
+    //! @brief Construct pre-encoded key.
+    //!
+    //! @param[in] name The unescaped key name.
+    basic_key(const view_type& name)
+    {
+        content.push_back(value_type(','));
+        detail::basic_encoder<value_type, sizeof(buffer::basic_string<value_type>)> encoder(content);
+        encoder.value(name);
+        content.push_back(value_type(':'));
+    }
+
+    //! @brief Construct pre-encoded key.
+    //!
+    //! @param[in] name The unescaped key name.
+    basic_key(const value_type *name)
+        : basic_key(view_type(name))
+    {
+    }
+
+    //! @brief Returns the quoted and escaped key followed by the name separator.
+    view_type literal() const
+    {
+        return view_type(content.data() + 1, content.size() - 1);
+    }
+
+#ifndef BOOST_DOXYGEN_INVOKED
+private:
+    template <typename, std::size_t> friend class basic_writer;
+
+    // Key preceded by value separator
+    view_type separated_literal() const
+    {
+        return view_type(content.data(), content.size());
+    }
+
+private:
+    std::basic_string<value_type> content;
+#endif // BOOST_DOXYGEN_INVOKED
+};
+
+using key = basic_key<char>;
+
+} // namespace json
+} // namespace protocol
+} // namespace trial
+
+#endif // TRIAL_PROTOCOL_JSON_KEY_HPP
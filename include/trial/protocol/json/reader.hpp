@@ -116,6 +116,18 @@ public:
     //! @returns A view of the remaining buffer.
     const view_type& tail() const BOOST_NOEXCEPT;
 
+    //! @brief Captures the current value or container and moves past it.
+    //!
+    //! The returned view spans the exact input of the current value, or of
+    //! the entire container including its brackets if the current token
+    //! begins a container. Afterwards the reader is positioned at the token
+    //! following the captured input.
+    //!
+    //! @returns A view of the captured input.
+    //! @throws json::error If the current token is not a value or the
+    //!         beginning of a container, or if the container is malformed.
+    view_type subtree_literal();
+
 #ifndef BOOST_DOXYGEN_INVOKED
 private:
     template <typename ReturnType, typename Enable = void>
@@ -0,0 +1,110 @@
+#ifndef TRIAL_PROTOCOL_JSON_REFORMAT_HPP
+#define TRIAL_PROTOCOL_JSON_REFORMAT_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <trial/protocol/core/char_traits.hpp>
+#include <trial/protocol/core/detail/string_view.hpp>
+#include <trial/protocol/buffer/base.hpp>
+#include <trial/protocol/json/error.hpp>
+
+namespace trial
+{
+namespace protocol
+{
+namespace json
+{
+
+//! @brief Layout of reformatted JSON output.
+class style
+{
+public:
+    struct layout
+    {
+        enum value
+        {
+            //! Remove all insignificant whitespaces.
+            minify,
+            //! Place each value on a separate indented line.
+            indent,
+            //! Like indent, but arrays of scalars are placed on a single line.
+            compact_arrays
+        };
+    };
+
+    static style minify()
+    {
+        return style(layout::minify, 0);
+    }
+
+    static style indent(std::size_t width = 4)
+    {
+        return style(layout::indent, width);
+    }
+
+    static style compact_arrays(std::size_t width = 4)
+    {
+        return style(layout::compact_arrays, width);
+    }
+
+    layout::value type() const
+    {
+        return kind;
+    }
+
+    std::size_t width() const
+    {
+        return indentation;
+    }
+
+private:
+    style(layout::value kind, std::size_t indentation)
+        : kind(kind),
+          indentation(indentation)
+    {
+    }
+
+    layout::value kind;
+    std::size_t indentation;
+};
+
+//! @brief Reformat JSON input.
+//!
+//! String and number literals are copied verbatim, and only insignificant
+//! whitespaces are changed. The structure of the input is validated, but the
+//! content of literals is not.
+//!
+//! The buffer type can be any for which a buffer wrapper exists.
+//!
+//! @param[in] input A JSON formatted buffer.
+//! @param[out] output A buffer where the reformatted output is stored.
+//! @param[in] style The layout of the output.
+//! @returns The number of characters written, or zero if the output buffer
+//!          could not be grown.
+//! @throws json::error if the input is malformed.
+template <typename CharT, typename T>
+std::size_t reformat(const core::detail::basic_string_view<CharT, core::char_traits<CharT>>& input,
+                     T& output,
+                     const style& = style::minify());
+
+template <typename T>
+std::size_t reformat(const core::detail::string_view& input,
+                     T& output,
+                     const style& = style::minify());
+
+} // namespace json
+} // namespace protocol
+} // namespace trial
+
+#include <trial/protocol/json/detail/reformat.ipp>
+
+#endif // TRIAL_PROTOCOL_JSON_REFORMAT_HPP
@@ -15,6 +15,7 @@
 #include <trial/protocol/buffer/base.hpp>
 #include <trial/protocol/json/error.hpp>
 #include <trial/protocol/json/token.hpp>
+#include <trial/protocol/json/key.hpp>
 #include <trial/protocol/json/detail/encoder.hpp>
 
 namespace trial
@@ -34,6 +35,7 @@ public:
     using value_type = CharT;
     using size_type = std::size_t;
     using view_type = typename detail::basic_encoder<value_type, N>::view_type;
+    using key_type = basic_key<value_type>;
 
     //! @brief Construct an incremental JSON writer.
     //!
@@ -53,9 +55,27 @@ public:
     template <typename T>
     size_type value(T&& value);
 
+    //! @brief Write pre-encoded object key.
+    //!
+    //! The key and the surrounding separators are written as a single span.
+    //!
+    //! @returns The number of characters written.
+    //! @throws json::error if not at a key position inside an object.
+    size_type key(const key_type&);
+
     //! @brief Write raw output.
     size_type literal(const view_type&) BOOST_NOEXCEPT;
 
+    //! @brief Write pre-encoded value or container.
+    //!
+    //! Splices a complete JSON value, such as the result of
+    //! reader::subtree_literal(), into the output with a single copy.
+    //! Separators are inserted as for any other value. The input is not
+    //! validated.
+    //!
+    //! @returns The number of characters written, excluding separators.
+    size_type subtree_literal(const view_type&);
+
 #ifndef BOOST_DOXYGEN_INVOKED
 private:
     void validate_scope();
@@ -84,6 +104,7 @@ private:
         encoder_type& encoder;
         token::code::value code;
         std::size_t counter;
+        bool separated;
     };
     std::stack<frame> stack;
 #endif // BOOST_DOXYGEN_INVOKED
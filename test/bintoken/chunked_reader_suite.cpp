@@ -0,0 +1,521 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+#include <trial/protocol/bintoken/chunked_reader.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+using output_type = std::vector<std::uint8_t>;
+using status = bintoken::chunked_reader::status;
+
+namespace
+{
+
+struct entry
+{
+    bintoken::token::code::value code;
+    std::size_t level;
+    std::vector<std::uint8_t> literal;
+
+    bool operator== (const entry& other) const
+    {
+        return (code == other.code) && (level == other.level) && (literal == other.literal);
+    }
+};
+
+// Tokens as seen by the contiguous reader. The content of length-prefixed
+// containers is not part of their literal in the chunked reader.
+std::vector<entry> read_whole(const output_type& input)
+{
+    std::vector<entry> result;
+    bintoken::reader reader(input);
+    do
+    {
+        if (reader.category() == bintoken::token::category::status)
+            break;
+        entry current = { reader.code(), reader.level(), {} };
+        if (reader.category() == bintoken::token::category::data)
+        {
+            current.literal.assign(reader.literal().begin(), reader.literal().end());
+        }
+        result.push_back(current);
+    } while (reader.next());
+    return result;
+}
+
+// Tokens as seen by the chunked reader with pieces joined together
+std::vector<entry> read_chunked(const output_type& input,
+                                std::size_t chunk_size,
+                                std::size_t capacity = bintoken::chunked_reader::default_capacity)
+{
+    std::vector<entry> result;
+    bintoken::chunked_reader reader(capacity);
+    std::size_t offset = 0;
+    bool joining = false;
+    for (;;)
+    {
+        const auto progress = reader.next();
+        if (progress == status::incomplete)
+        {
+            if (offset < input.size())
+            {
+                const std::size_t size = std::min(chunk_size, input.size() - offset);
+                reader.feed(bintoken::chunked_reader::view_type(input.data() + offset, size));
+                offset += size;
+            }
+            else
+            {
+                reader.finish();
+            }
+            continue;
+        }
+        if (progress != status::ready)
+            break;
+
+        if (joining)
+        {
+            result.back().literal.insert(result.back().literal.end(),
+                                         reader.literal().begin(),
+                                         reader.literal().end());
+        }
+        else
+        {
+            entry current = { reader.code(), reader.level(), {} };
+            if (reader.category() == bintoken::token::category::data)
+            {
+                current.literal.assign(reader.literal().begin(), reader.literal().end());
+            }
+            result.push_back(current);
+        }
+        joining = reader.partial();
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::end);
+    return result;
+}
+
+output_type make_message()
+{
+    output_type output;
+    bintoken::writer writer(output);
+    writer.dictionary(true);
+    writer.align(8);
+    writer.value<bintoken::token::begin_record>();
+    writer.value("alpha");
+    writer.value(true);
+    writer.value("bravo");
+    writer.value(std::int16_t(1000));
+    writer.value("alpha");
+    writer.value(3.14);
+    writer.value(std::string(300, 'x'));
+    writer.value<bintoken::token::begin_array>();
+    {
+        std::vector<std::int32_t> data(100);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = std::int32_t(i * 100000);
+        writer.array(data.data(), data.size());
+    }
+    {
+        const std::vector<double> data(12, 0.5);
+        const bintoken::writer::size_type extents[] = { 3, 4 };
+        writer.tensor(data.data(), extents, 2);
+    }
+    {
+        const bool data[] = { true, false, true, true, false, true, false, false, true };
+        writer.array(data, 9);
+    }
+    writer.precision(bintoken::precision::bfloat16);
+    {
+        const std::vector<float> data(40, 1.5f);
+        writer.array(data.data(), data.size());
+    }
+    writer.precision(bintoken::precision::full);
+    writer.varint(true);
+    writer.value(std::int64_t(-300));
+    {
+        std::vector<std::int64_t> data(50);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = std::int64_t(i * i * 31) - 500;
+        writer.array(data.data(), data.size());
+    }
+    writer.varint(false);
+    writer.packing(bintoken::packing::delta);
+    {
+        std::vector<std::int64_t> data(64);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = 1500000000 + std::int64_t(i * 3);
+        writer.array(data.data(), data.size());
+    }
+    writer.value<bintoken::token::end_array>();
+    writer.value<bintoken::token::null>();
+    writer.value<bintoken::token::end_record>();
+    writer.length_prefix(true);
+    writer.value<bintoken::token::begin_assoc_array>();
+    writer.value("charlie");
+    writer.value(42);
+    writer.value<bintoken::token::end_assoc_array>();
+    return output;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Chunks
+//-----------------------------------------------------------------------------
+
+namespace chunk_suite
+{
+
+void test_empty()
+{
+    bintoken::chunked_reader reader;
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::end);
+    reader.finish();
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::end);
+}
+
+void test_whole()
+{
+    const output_type input = { bintoken::token::code::int16, 0x00, 0x01, 0x2A };
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::int16);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 0x0100);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::int8);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 42);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    reader.finish();
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::end);
+}
+
+void test_straddle()
+{
+    const output_type first = { bintoken::token::code::int32, 0x01, 0x02 };
+    const output_type second = { 0x03, 0x04 };
+    bintoken::chunked_reader reader;
+    reader.feed(first);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    reader.feed(second);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::int32_t>(), 0x04030201);
+    TRIAL_PROTOCOL_TEST(!reader.partial());
+}
+
+void test_all_chunk_sizes()
+{
+    const auto input = make_message();
+    const auto expected = read_whole(input);
+    TRIAL_PROTOCOL_TEST(expected.size() > 15);
+    for (std::size_t chunk_size = 1; chunk_size <= input.size(); ++chunk_size)
+    {
+        TRIAL_PROTOCOL_TEST(read_chunked(input, chunk_size) == expected);
+    }
+}
+
+void test_small_capacity()
+{
+    const auto input = make_message();
+    const auto expected = read_whole(input);
+    for (std::size_t chunk_size = 1; chunk_size <= input.size(); chunk_size += 7)
+    {
+        TRIAL_PROTOCOL_TEST(read_chunked(input, chunk_size, 0) == expected);
+    }
+}
+
+void test_level()
+{
+    output_type input;
+    {
+        bintoken::writer writer(input);
+        writer.value<bintoken::token::begin_array>();
+        writer.value<bintoken::token::begin_record>();
+        writer.value<bintoken::token::end_record>();
+        writer.value<bintoken::token::end_array>();
+    }
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::begin_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::begin_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::end_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::end_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+}
+
+void run()
+{
+    test_empty();
+    test_whole();
+    test_straddle();
+    test_all_chunk_sizes();
+    test_small_capacity();
+    test_level();
+}
+
+} // namespace chunk_suite
+
+//-----------------------------------------------------------------------------
+// Pieces
+//-----------------------------------------------------------------------------
+
+namespace piece_suite
+{
+
+void test_string()
+{
+    output_type input;
+    {
+        bintoken::writer writer(input);
+        writer.value(std::string(1000, 'a'));
+    }
+    bintoken::chunked_reader reader(256);
+    reader.feed(bintoken::chunked_reader::view_type(input.data(), 600));
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::string16);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.partial(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), std::string(597, 'a'));
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    reader.feed(bintoken::chunked_reader::view_type(input.data() + 600, input.size() - 600));
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.partial(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), std::string(403, 'a'));
+}
+
+void test_array()
+{
+    std::vector<std::int32_t> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = std::int32_t(i) - 500;
+    output_type input;
+    {
+        bintoken::writer writer(input);
+        writer.array(data.data(), data.size());
+    }
+
+    // Chunks split the elements unevenly
+    std::vector<std::int32_t> result;
+    bintoken::chunked_reader reader(256);
+    std::size_t offset = 0;
+    for (;;)
+    {
+        const auto progress = reader.next();
+        if (progress == status::incomplete)
+        {
+            const std::size_t size = std::min<std::size_t>(101, input.size() - offset);
+            if (size == 0)
+            {
+                reader.finish();
+                continue;
+            }
+            reader.feed(bintoken::chunked_reader::view_type(input.data() + offset, size));
+            offset += size;
+            continue;
+        }
+        if (progress != status::ready)
+            break;
+        std::vector<std::int32_t> piece(reader.length());
+        reader.array(piece.data(), piece.size());
+        result.insert(result.end(), piece.begin(), piece.end());
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::end);
+    TRIAL_PROTOCOL_TEST(result == data);
+}
+
+void test_widen_varint()
+{
+    std::vector<std::int64_t> data(2000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = std::int64_t(i * i);
+    output_type input;
+    {
+        bintoken::writer writer(input);
+        writer.varint(true);
+        writer.array(data.data(), data.size());
+    }
+    TRIAL_PROTOCOL_TEST(input.front() == bintoken::token::code::array16_varint);
+
+    std::vector<std::int64_t> result;
+    bintoken::chunked_reader reader(256);
+    for (std::size_t offset = 0; offset < input.size(); offset += 33)
+    {
+        reader.feed(bintoken::chunked_reader::view_type(input.data() + offset,
+                                                        std::min<std::size_t>(33, input.size() - offset)));
+        while (reader.next() == status::ready)
+        {
+            std::vector<std::int64_t> piece(reader.length());
+            reader.array(piece.data(), piece.size());
+            result.insert(result.end(), piece.begin(), piece.end());
+        }
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::end);
+    }
+    reader.finish();
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::end);
+    TRIAL_PROTOCOL_TEST(result == data);
+}
+
+void fail_packed_overflow()
+{
+    std::vector<std::int64_t> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = std::int64_t(i * 1000003);
+    output_type input;
+    {
+        bintoken::writer writer(input);
+        writer.packing(bintoken::packing::frame_of_reference);
+        writer.array(data.data(), data.size());
+    }
+    TRIAL_PROTOCOL_TEST(input.front() == bintoken::token::code::array16_packed);
+    bintoken::chunked_reader reader(256);
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.error(), bintoken::make_error_code(bintoken::overflow));
+}
+
+void run()
+{
+    test_string();
+    test_array();
+    test_widen_varint();
+    fail_packed_overflow();
+}
+
+} // namespace piece_suite
+
+//-----------------------------------------------------------------------------
+// Errors
+//-----------------------------------------------------------------------------
+
+namespace error_suite
+{
+
+void fail_truncated()
+{
+    const output_type input = { bintoken::token::code::int32, 0x01, 0x02 };
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    reader.finish();
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_truncated);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.error(), bintoken::make_error_code(bintoken::truncated));
+    // Errors are sticky
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+}
+
+void fail_truncated_piece()
+{
+    output_type input;
+    {
+        bintoken::writer writer(input);
+        writer.value(std::string(1000, 'a'));
+    }
+    input.resize(500);
+    bintoken::chunked_reader reader(256);
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.partial(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::incomplete);
+    reader.finish();
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_truncated);
+}
+
+void fail_unknown_token()
+{
+    const output_type input = { 0x8F };
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_unknown_token);
+}
+
+void fail_invalid_length()
+{
+    const output_type input = { bintoken::token::code::array8_int32, 0x03, 0x00, 0x00, 0x00 };
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_invalid_length);
+}
+
+void fail_varint_array()
+{
+    // The last value is incomplete
+    output_type input = { bintoken::token::code::array16_varint, 0x2C, 0x01 };
+    input.insert(input.end(), 299, 0x02);
+    input.push_back(0x80);
+    bintoken::chunked_reader reader(256);
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_invalid_value);
+}
+
+void fail_reference()
+{
+    const output_type input = { bintoken::token::code::string_reference8, 0x00 };
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_invalid_value);
+}
+
+void fail_mismatched_end()
+{
+    const output_type input = { bintoken::token::code::begin_array, bintoken::token::code::end_record };
+    bintoken::chunked_reader reader;
+    reader.feed(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::ready);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), status::failed);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), bintoken::token::code::error_expected_end_record);
+}
+
+void run()
+{
+    fail_truncated();
+    fail_truncated_piece();
+    fail_unknown_token();
+    fail_invalid_length();
+    fail_varint_array();
+    fail_reference();
+    fail_mismatched_end();
+}
+
+} // namespace error_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    chunk_suite::run();
+    piece_suite::run();
+    error_suite::run();
+
+    return boost::report_errors();
+}
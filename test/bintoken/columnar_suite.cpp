@@ -0,0 +1,291 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/columnar.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+namespace format = trial::protocol::bintoken;
+namespace token = format::token;
+using value_type = std::uint8_t;
+using output_type = std::vector<value_type>;
+
+namespace
+{
+
+struct point
+{
+    std::int16_t x;
+    double y;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & x;
+        archive & y;
+    }
+};
+
+class sample
+{
+public:
+    sample() : id(0), valid(false) {}
+    sample(std::int32_t id, std::string name, bool valid)
+        : id(id), name(std::move(name)), valid(valid) {}
+
+    std::int32_t id;
+    std::string name;
+    bool valid;
+
+private:
+    friend class boost::serialization::access;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & id & name & valid;
+    }
+};
+
+struct table
+{
+    std::string title;
+    std::vector<point> points;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & title;
+        archive & format::columnar(points);
+    }
+};
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Save
+//-----------------------------------------------------------------------------
+
+namespace save_suite
+{
+
+void test_empty()
+{
+    output_type result;
+    format::oarchive ar(result);
+    std::vector<point> value;
+    ar << format::columnar(value);
+
+    output_type expected = { token::code::begin_record,
+                             0x00,
+                             token::code::array8_int16, 0x00,
+                             token::code::array8_float64, 0x00,
+                             token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected.begin(), expected.end(),
+                                 std::equal_to<value_type>());
+}
+
+void test_point()
+{
+    output_type result;
+    format::oarchive ar(result);
+    std::vector<point> value = { { 1, 0.0 }, { 2, 0.0 } };
+    ar << format::columnar(value);
+
+    output_type expected = { token::code::begin_record,
+                             0x02,
+                             token::code::array8_int16, 0x04, 0x01, 0x00, 0x02, 0x00,
+                             token::code::array8_float64, 0x10,
+                             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                             token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected.begin(), expected.end(),
+                                 std::equal_to<value_type>());
+}
+
+void test_smaller()
+{
+    // Columns are smaller than rows of records
+    std::vector<point> value;
+    for (int i = 0; i < 100; ++i)
+    {
+        value.push_back(point{ std::int16_t(i), i / 2.0 });
+    }
+    output_type columns;
+    {
+        format::oarchive ar(columns);
+        ar << format::columnar(value);
+    }
+    output_type rows;
+    {
+        format::oarchive ar(rows);
+        ar << value;
+    }
+    TRIAL_PROTOCOL_TEST(columns.size() < rows.size());
+}
+
+void run()
+{
+    test_empty();
+    test_point();
+    test_smaller();
+}
+
+} // namespace save_suite
+
+//-----------------------------------------------------------------------------
+// Load
+//-----------------------------------------------------------------------------
+
+namespace load_suite
+{
+
+void test_point()
+{
+    const output_type input = { token::code::begin_record,
+                                0x02,
+                                token::code::array8_int8, 0x02, 0x01, 0x02,
+                                token::code::array8_float64, 0x10,
+                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F,
+                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+                                token::code::end_record };
+    format::iarchive in(input);
+    std::vector<point> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> format::columnar(value));
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0].x, 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0].y, 1.0);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1].x, 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1].y, 2.0);
+}
+
+void fail_count()
+{
+    const output_type input = { token::code::begin_record,
+                                0x02,
+                                token::code::array8_int8, 0x01, 0x01,
+                                token::code::array8_float64, 0x00,
+                                token::code::end_record };
+    format::iarchive in(input);
+    std::vector<point> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> format::columnar(value),
+                                    format::error, "invalid value");
+}
+
+void fail_missing_column()
+{
+    const output_type input = { token::code::begin_record,
+                                0x00,
+                                token::code::array8_int16, 0x00,
+                                token::code::end_record };
+    format::iarchive in(input);
+    std::vector<point> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> format::columnar(value),
+                                    format::error, "incompatible type");
+}
+
+void fail_missing_end()
+{
+    const output_type input = { token::code::begin_record,
+                                0x00,
+                                token::code::array8_int16, 0x00,
+                                token::code::array8_float64, 0x00,
+                                token::code::array8_float64, 0x00,
+                                token::code::end_record };
+    format::iarchive in(input);
+    std::vector<point> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> format::columnar(value),
+                                    format::error, "expected end record bracket");
+}
+
+void run()
+{
+    test_point();
+    fail_count();
+    fail_missing_column();
+    fail_missing_end();
+}
+
+} // namespace load_suite
+
+//-----------------------------------------------------------------------------
+// Round trip
+//-----------------------------------------------------------------------------
+
+namespace round_suite
+{
+
+void test_sample()
+{
+    std::vector<sample> input = { { 1, "alpha", true },
+                                  { -2, "beta", false },
+                                  { 300000, "", true } };
+    output_type result;
+    {
+        format::oarchive ar(result);
+        ar << format::columnar(input);
+    }
+    std::vector<sample> output;
+    format::iarchive in(result);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> format::columnar(output));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), input.size());
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        TRIAL_PROTOCOL_TEST_EQUAL(output[i].id, input[i].id);
+        TRIAL_PROTOCOL_TEST_EQUAL(output[i].name, input[i].name);
+        TRIAL_PROTOCOL_TEST_EQUAL(output[i].valid, input[i].valid);
+    }
+}
+
+void test_member()
+{
+    table input;
+    input.title = "table";
+    input.points = { { 1, 0.5 }, { 2, 1.5 }, { 3, 2.5 } };
+    output_type result;
+    {
+        format::oarchive ar(result);
+        ar << input;
+    }
+    table output;
+    format::iarchive in(result);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> output);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.title, "table");
+    TRIAL_PROTOCOL_TEST_EQUAL(output.points.size(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.points[2].x, 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.points[2].y, 2.5);
+}
+
+void run()
+{
+    test_sample();
+    test_member();
+}
+
+} // namespace round_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    save_suite::run();
+    load_suite::run();
+    round_suite::run();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,311 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/string.hpp>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/bintoken/container.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+using output_type = std::vector<std::uint8_t>;
+
+namespace
+{
+
+// Record with a string name and an integer value
+output_type make_record(const std::string& name, std::int64_t value)
+{
+    output_type result;
+    bintoken::writer writer(result);
+    writer.value<bintoken::token::begin_record>();
+    writer.value(name);
+    writer.value(value);
+    writer.value<bintoken::token::end_record>();
+    return result;
+}
+
+std::int64_t record_value(bintoken::reader reader)
+{
+    reader.next(); // name
+    reader.next();
+    return reader.value<std::int64_t>();
+}
+
+std::string key_of(int index)
+{
+    std::string result = "key";
+    result += char('0' + index / 100);
+    result += char('0' + (index / 10) % 10);
+    result += char('0' + index % 10);
+    return result;
+}
+
+output_type make_container(int size, bool with_keys)
+{
+    output_type result;
+    bintoken::container_writer<output_type> container(result);
+    for (int i = 0; i < size; ++i)
+    {
+        if (with_keys)
+            container.append(make_record(key_of(i), i), key_of(i));
+        else
+            container.append(make_record(key_of(i), i));
+    }
+    TRIAL_PROTOCOL_TEST(container.close());
+    return result;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Index
+//-----------------------------------------------------------------------------
+
+namespace index_suite
+{
+
+void test_empty()
+{
+    output_type input = make_container(0, false);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.size(), 8 + 32);
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(container.good());
+    TRIAL_PROTOCOL_TEST_EQUAL(container.size(), 0);
+    TRIAL_PROTOCOL_TEST(!container.has_keys());
+    TRIAL_PROTOCOL_TEST(container.at(0).empty());
+}
+
+void test_records()
+{
+    output_type input = make_container(100, false);
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(container.good());
+    TRIAL_PROTOCOL_TEST_EQUAL(container.size(), 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        output_type expected = make_record(key_of(i), i);
+        auto record = container.at(i);
+        TRIAL_PROTOCOL_TEST(output_type(record.begin(), record.end()) == expected);
+    }
+    TRIAL_PROTOCOL_TEST(container.at(100).empty());
+}
+
+void test_record_reader()
+{
+    output_type input = make_container(10, false);
+    bintoken::container_reader container(input);
+    bintoken::reader reader = container.record(7);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::begin_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(record_value(reader), 7);
+}
+
+void test_range()
+{
+    output_type input = make_container(10, false);
+    bintoken::container_reader container(input);
+    // A range is scanned as a sequence of records
+    bintoken::reader reader(container.range(3, 6));
+    int records = 0;
+    do
+    {
+        if (reader.symbol() == bintoken::token::symbol::begin_record)
+            ++records;
+    } while (reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(records, 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::end);
+}
+
+void test_partition()
+{
+    output_type input = make_container(100, false);
+    bintoken::container_reader container(input);
+    const std::size_t parts = 7;
+    std::size_t previous = 0;
+    std::int64_t sum = 0;
+    for (std::size_t part = 0; part < parts; ++part)
+    {
+        const std::size_t first = container.partition(part, parts);
+        const std::size_t last = container.partition(part + 1, parts);
+        TRIAL_PROTOCOL_TEST_EQUAL(first, previous);
+        TRIAL_PROTOCOL_TEST(last - first >= 100 / parts - 1);
+        for (std::size_t i = first; i < last; ++i)
+        {
+            sum += record_value(container.record(i));
+        }
+        previous = last;
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(previous, 100);
+    TRIAL_PROTOCOL_TEST_EQUAL(sum, 99 * 100 / 2);
+}
+
+void test_string_output()
+{
+    std::string result;
+    {
+        bintoken::container_writer<std::string> container(result);
+        container.append(make_record("alpha", 1));
+        TRIAL_PROTOCOL_TEST_EQUAL(container.size(), 1);
+    }
+    // Footer is written on destruction
+    bintoken::container_reader container(result);
+    TRIAL_PROTOCOL_TEST(container.good());
+    TRIAL_PROTOCOL_TEST_EQUAL(container.size(), 1);
+}
+
+void run()
+{
+    test_empty();
+    test_records();
+    test_record_reader();
+    test_range();
+    test_partition();
+    test_string_output();
+}
+
+} // namespace index_suite
+
+//-----------------------------------------------------------------------------
+// Keys
+//-----------------------------------------------------------------------------
+
+namespace key_suite
+{
+
+void test_key()
+{
+    output_type input = make_container(20, true);
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(container.good());
+    TRIAL_PROTOCOL_TEST(container.has_keys());
+    TRIAL_PROTOCOL_TEST_EQUAL(container.key(0), "key000");
+    TRIAL_PROTOCOL_TEST_EQUAL(container.key(19), "key019");
+    TRIAL_PROTOCOL_TEST(container.key(20).empty());
+}
+
+void test_find()
+{
+    output_type input = make_container(500, true);
+    bintoken::container_reader container(input);
+    for (int i = 0; i < 500; i += 7)
+    {
+        const std::size_t where = container.find(key_of(i));
+        TRIAL_PROTOCOL_TEST_EQUAL(where, i);
+        TRIAL_PROTOCOL_TEST_EQUAL(record_value(container.record(where)), i);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(container.find("key0005"), container.size());
+    TRIAL_PROTOCOL_TEST_EQUAL(container.find("zzz"), container.size());
+}
+
+void test_lower_bound()
+{
+    output_type input = make_container(50, true);
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(container.lower_bound(""), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(container.lower_bound("key010"), 10);
+    TRIAL_PROTOCOL_TEST_EQUAL(container.lower_bound("key0105"), 11);
+    TRIAL_PROTOCOL_TEST_EQUAL(container.lower_bound("zzz"), 50);
+}
+
+void test_without_keys()
+{
+    output_type input = make_container(10, false);
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(container.find("key001"), container.size());
+    TRIAL_PROTOCOL_TEST(container.key(1).empty());
+}
+
+void run()
+{
+    test_key();
+    test_find();
+    test_lower_bound();
+    test_without_keys();
+}
+
+} // namespace key_suite
+
+//-----------------------------------------------------------------------------
+// Malformed footer
+//-----------------------------------------------------------------------------
+
+namespace error_suite
+{
+
+void fail_short()
+{
+    output_type input(31, 0);
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(!container.good());
+    TRIAL_PROTOCOL_TEST_EQUAL(container.size(), 0);
+}
+
+void fail_magic()
+{
+    output_type input = make_container(3, false);
+    input[input.size() - 32] = 'X';
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(!container.good());
+}
+
+void fail_count()
+{
+    output_type input = make_container(3, false);
+    input[input.size() - 24] = 0xFF;
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(!container.good());
+}
+
+void fail_offset()
+{
+    output_type input = make_container(3, false);
+    // Second record offset is moved beyond the third
+    const std::size_t index = input.size() - 32 - 3 * 8;
+    input[index + 7] = 0x01;
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(!container.good());
+}
+
+void fail_truncated()
+{
+    output_type input = make_container(3, true);
+    input.erase(input.begin());
+    bintoken::container_reader container(input);
+    TRIAL_PROTOCOL_TEST(!container.good());
+    TRIAL_PROTOCOL_TEST(!container.has_keys());
+}
+
+void run()
+{
+    fail_short();
+    fail_magic();
+    fail_count();
+    fail_offset();
+    fail_truncated();
+}
+
+} // namespace error_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    index_suite::run();
+    key_suite::run();
+    error_suite::run();
+
+    return boost::report_errors();
+}
@@ -9,6 +9,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <trial/protocol/buffer/array.hpp>
+#include <trial/protocol/buffer/vector.hpp>
 #include <trial/protocol/bintoken/serialization.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
 
@@ -431,6 +432,56 @@ void test_bool_two_uncounted()
     TRIAL_PROTOCOL_TEST_EQUAL(value[1], false);
 }
 
+void test_bool_packed()
+{
+    const value_type input[] = { token::code::array8_bool,
+                                 0x03,
+                                 0x07, 0x59, 0x01 };
+    format::iarchive in(input);
+    std::vector<bool> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    std::vector<bool> expected = { true, false, false, true, true, false, true, false, true };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(value.begin(), value.end(),
+                                 expected.begin(), expected.end(),
+                                 std::equal_to<bool>());
+}
+
+void test_bool_packed_empty()
+{
+    const value_type input[] = { token::code::array8_bool,
+                                 0x01,
+                                 0x00 };
+    format::iarchive in(input);
+    std::vector<bool> value = { true };
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 0);
+}
+
+void test_bool_int8()
+{
+    // Booleans were formerly saved as int8 arrays
+    const value_type input[] = { token::code::array8_int8,
+                                 0x02,
+                                 0x01, 0x00 };
+    format::iarchive in(input);
+    std::vector<bool> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], true);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], false);
+}
+
+void fail_bool_packed_unused()
+{
+    const value_type input[] = { token::code::array8_bool,
+                                 0x02,
+                                 0x08, 0x01 };
+    format::iarchive in(input);
+    std::vector<bool> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "unexpected token");
+}
+
 void fail_unexpected_float()
 {
     // FIXME: No exception because of implicit conversion from float to int
@@ -507,6 +558,10 @@ void run()
     test_bool_one();
     test_bool_two();
     test_bool_two_uncounted();
+    test_bool_packed();
+    test_bool_packed_empty();
+    test_bool_int8();
+    fail_bool_packed_unused();
     // fail_unexpected_float();  // FIXME
     fail_unexpected_begin();
     fail_mixed();
@@ -695,6 +750,56 @@ void test_float64()
     TRIAL_PROTOCOL_TEST_EQUAL(value[3], 3.0);
 }
 
+void test_int64_from_int8()
+{
+    const value_type input[] = { token::code::array8_int8, 4 * token::int8::size,
+                                 0x01, 0x7F, 0x80, 0xFF };
+    format::iarchive in(input);
+    std::vector<std::int64_t> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], 127);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[2], -128);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[3], -1);
+}
+
+void test_uint32_from_int16()
+{
+    const value_type input[] = { token::code::array8_int16, 2 * token::int16::size,
+                                 0xC8, 0x00,
+                                 0xFF, 0xFF };
+    format::iarchive in(input);
+    std::vector<std::uint32_t> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], 200U);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], std::numeric_limits<std::uint32_t>::max());
+}
+
+void test_int32_from_varint()
+{
+    const value_type input[] = { token::code::array8_varint, 0x05, 0x02, 0x01, 0x80, 0x89, 0x7A };
+    format::iarchive in(input);
+    std::vector<std::int32_t> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], -1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[2], 1000000);
+}
+
+void fail_int16_from_int32()
+{
+    const value_type input[] = { token::code::array8_int32, token::int32::size,
+                                 0x01, 0x00, 0x00, 0x00 };
+    format::iarchive in(input);
+    std::vector<std::int16_t> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error,
+                                    "incompatible type");
+}
+
 void run()
 {
     test_empty();
@@ -708,10 +813,170 @@ void run()
     test_uint64();
     test_float32();
     test_float64();
+    test_int64_from_int8();
+    test_uint32_from_int16();
+    test_int32_from_varint();
+    fail_int16_from_int32();
 }
 
 } // namespace compact_vector_suite
 
+//-----------------------------------------------------------------------------
+// Bulk sequences
+//-----------------------------------------------------------------------------
+
+struct bulk_point
+{
+    std::int16_t x;
+    std::int16_t y;
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(bulk_point)
+
+namespace bulk_suite
+{
+
+void test_long_long()
+{
+    const value_type input[] = { token::code::array8_int8, 0x02, 0x01, 0xFF };
+    format::iarchive in(input);
+    std::vector<long long> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], -1);
+}
+
+void test_bool()
+{
+    const value_type input[] = { token::code::array8_int8, 0x03, 0x01, 0x00, 0x01 };
+    format::iarchive in(input);
+    std::vector<bool> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], true);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], false);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[2], true);
+}
+
+void test_bool_array()
+{
+    const value_type input[] = { token::code::array8_int8, 0x02, 0x01, 0x01 };
+    format::iarchive in(input);
+    std::array<bool, 2> value = {{ false, false }};
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], true);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1], true);
+}
+
+void test_pair()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::array8_int16, 0x04, 0x01, 0x00, 0x02, 0x00,
+                                 token::code::array8_int8, 0x02, 0x01, 0x00,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    std::vector<std::pair<std::int16_t, bool>> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0].first, 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0].second, true);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1].first, 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1].second, false);
+}
+
+void test_pair_elements()
+{
+    const value_type input[] = { token::code::begin_array,
+                                 0x01,
+                                 token::code::begin_record,
+                                 0x01,
+                                 token::code::true_value,
+                                 token::code::end_record,
+                                 token::code::end_array };
+    format::iarchive in(input);
+    std::vector<std::pair<std::int16_t, bool>> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0].first, 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0].second, true);
+}
+
+void test_bitwise()
+{
+    std::vector<bulk_point> expected = { { 1, 2 }, { 3, -1 } };
+    std::vector<value_type> input = { token::code::array8_int8, 0x08 };
+    const value_type *raw = reinterpret_cast<const value_type *>(expected.data());
+    input.insert(input.end(), raw, raw + expected.size() * sizeof(bulk_point));
+    format::iarchive in(input);
+    std::vector<bulk_point> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1].x, 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[1].y, -1);
+}
+
+void test_record()
+{
+    // Compact arrays are followed by further members
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::array8_int8, 0x02, 0x01, 0x02,
+                                 token::code::array8_int8, 0x01, 0x03,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    std::pair<std::vector<std::int32_t>, std::vector<long long>> value;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.first.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.second.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.second[0], 3);
+}
+
+void fail_pair_mismatch()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::array8_int16, 0x04, 0x01, 0x00, 0x02, 0x00,
+                                 token::code::array8_int8, 0x01, 0x01,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    std::vector<std::pair<std::int16_t, bool>> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "invalid value");
+}
+
+void fail_bitwise_length()
+{
+    const value_type input[] = { token::code::array8_int8, 0x03, 0x01, 0x02, 0x03 };
+    format::iarchive in(input);
+    std::vector<bulk_point> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "invalid value");
+}
+
+void fail_bool_array_overflow()
+{
+    const value_type input[] = { token::code::array8_int8, 0x03, 0x01, 0x01, 0x01 };
+    format::iarchive in(input);
+    std::array<bool, 2> value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "overflow");
+}
+
+void run()
+{
+    test_long_long();
+    test_bool();
+    test_bool_array();
+    test_pair();
+    test_pair_elements();
+    test_bitwise();
+    test_record();
+    fail_pair_mismatch();
+    fail_bitwise_length();
+    fail_bool_array_overflow();
+}
+
+} // namespace bulk_suite
+
 //-----------------------------------------------------------------------------
 // std::set
 //-----------------------------------------------------------------------------
@@ -1141,6 +1406,7 @@ int main()
     pair_suite::run();
     vector_suite::run();
     compact_vector_suite::run();
+    bulk_suite::run();
     set_suite::run();
     map_suite::run();
     container_suite::run();
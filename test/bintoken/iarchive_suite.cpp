@@ -11,6 +11,7 @@
 #include <limits>
 #include <trial/protocol/buffer/array.hpp>
 #include <trial/protocol/bintoken/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/field.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
 
 using namespace trial::protocol;
@@ -612,6 +613,19 @@ void test_person()
     TRIAL_PROTOCOL_TEST_EQUAL(value.age, 127);
 }
 
+void test_person_trusted()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::string8, 0x03, 0x41, 0x42, 0x43,
+                                 token::code::int16, 0x7F, 0x00,
+                                 token::code::end_record };
+    format::iarchive in(input, format::trusted);
+    person value("", 99);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.name, "ABC");
+    TRIAL_PROTOCOL_TEST_EQUAL(value.age, 127);
+}
+
 void fail_missing_begin()
 {
     const value_type input[] = { token::code::string8, 0x03, 0x41, 0x42, 0x43,
@@ -680,6 +694,7 @@ void fail_invalid_first()
 void run()
 {
     test_person();
+    test_person_trusted();
     fail_missing_begin();
     fail_missing_end();
     fail_missing_second();
@@ -1012,6 +1027,127 @@ void run()
 
 } // namespace dynamic_suite
 
+//-----------------------------------------------------------------------------
+// Tagged fields
+//-----------------------------------------------------------------------------
+
+namespace field_suite
+{
+
+struct person
+{
+    person(const std::string& name, int age)
+        : name(name),
+          age(age)
+    {}
+
+    template<typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & format::field(1, name);
+        archive & format::field(2, age);
+    }
+
+    std::string name;
+    int age;
+};
+
+void test_person()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x02,
+                                 token::code::string8, 0x03, 0x41, 0x42, 0x43,
+                                 token::code::field, 0x04,
+                                 0x7F,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    person value("", 99);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.name, "ABC");
+    TRIAL_PROTOCOL_TEST_EQUAL(value.age, 127);
+}
+
+void test_unknown_fields()
+{
+    // Fields unknown to the reader are skipped
+    const value_type input[] = { token::code::begin_record32, 0x17, 0x00, 0x00, 0x00,
+                                 token::code::field, 0x00,
+                                 token::code::begin_array32, 0x03, 0x00, 0x00, 0x00,
+                                 0x01, 0x02, token::code::end_array,
+                                 token::code::field, 0x02,
+                                 token::code::string8, 0x03, 0x41, 0x42, 0x43,
+                                 token::code::field, 0x04,
+                                 0x7F,
+                                 token::code::field, 0x06,
+                                 token::code::null,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    person value("", 99);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.name, "ABC");
+    TRIAL_PROTOCOL_TEST_EQUAL(value.age, 127);
+}
+
+void test_missing_field()
+{
+    // Missing fields retain their value
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x04,
+                                 0x7F,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    person value("DEF", 99);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.name, "DEF");
+    TRIAL_PROTOCOL_TEST_EQUAL(value.age, 127);
+}
+
+void test_empty()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    person value("DEF", 99);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> value);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.name, "DEF");
+    TRIAL_PROTOCOL_TEST_EQUAL(value.age, 99);
+}
+
+void fail_invalid_field()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x04,
+                                 token::code::true_value,
+                                 token::code::end_record };
+    format::iarchive in(input);
+    person value("", 99);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "invalid value");
+}
+
+void fail_missing_end()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x06,
+                                 token::code::begin_array, 0x01 };
+    format::iarchive in(input);
+    person value("", 99);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "expected end array bracket");
+}
+
+void run()
+{
+    test_person();
+    test_unknown_fields();
+    test_missing_field();
+    test_empty();
+    fail_invalid_field();
+    fail_missing_end();
+}
+
+} // namespace field_suite
+
 //-----------------------------------------------------------------------------
 // main
 //-----------------------------------------------------------------------------
@@ -1028,6 +1164,7 @@ int main()
     split_struct_suite::run();
     container_suite::run();
     dynamic_suite::run();
+    field_suite::run();
 
     return boost::report_errors();
 }
@@ -8,6 +8,8 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <limits>
 #include <trial/protocol/buffer/vector.hpp>
 #include <trial/protocol/bintoken/serialization.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
@@ -30,10 +32,9 @@ void test_bool()
     std::array<bool, 4> value = {{ false, true, false, true }};
     ar << value;
 
-    const output_type expected[] = { token::code::begin_array,
-                                     0x04,
-                                     0x80, 0x81, 0x80, 0x81,
-                                     token::code::end_array };
+    const output_type expected[] = { token::code::array8_bool,
+                                     0x02,
+                                     0x04, 0x0A };
     TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
                                  expected, expected + sizeof(expected),
                                  std::equal_to<output_type>());
@@ -310,9 +311,9 @@ void test_bool_empty()
     std::vector<bool> value;
     ar << value;
 
-    output_type expected[] = { token::code::begin_array,
-                              0x00,
-                              token::code::end_array };
+    output_type expected[] = { token::code::array8_bool,
+                              0x01,
+                              0x00 };
     TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
                                  expected, expected + sizeof(expected),
                                  std::equal_to<output_type>());
@@ -326,10 +327,9 @@ void test_bool_one()
     value.push_back(true);
     ar << value;
 
-    output_type expected[] = { token::code::begin_array,
-                              0x01,
-                              token::code::true_value,
-                              token::code::end_array };
+    output_type expected[] = { token::code::array8_bool,
+                              0x02,
+                              0x07, 0x01 };
     TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
                                  expected, expected + sizeof(expected),
                                  std::equal_to<output_type>());
@@ -344,11 +344,24 @@ void test_bool_two()
     value.push_back(false);
     ar << value;
 
-    output_type expected[] = { token::code::begin_array,
+    output_type expected[] = { token::code::array8_bool,
                               0x02,
-                              token::code::true_value,
-                              token::code::false_value,
-                              token::code::end_array };
+                              0x06, 0x01 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_bool_nine()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    std::vector<bool> value = { true, false, false, true, true, false, true, false, true };
+    ar << value;
+
+    output_type expected[] = { token::code::array8_bool,
+                              0x03,
+                              0x07, 0x59, 0x01 };
     TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
                                  expected, expected + sizeof(expected),
                                  std::equal_to<output_type>());
@@ -374,6 +387,7 @@ void run()
     test_bool_empty();
     test_bool_one();
     test_bool_two();
+    test_bool_nine();
 
     test_int8_two();
 }
@@ -618,6 +632,73 @@ void test_float64_empty()
                                  std::equal_to<output_type>());
 }
 
+void test_float32_float16()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    ar.precision(format::precision::float16);
+    std::vector<token::float32::type> value = { 1.0f, -2.0f, 65504.0f,
+                                                std::numeric_limits<token::float32::type>::infinity() };
+    ar << value;
+
+    output_type expected[] = { token::code::array8_float16, 0x08,
+                               0x00, 0x3C, 0x00, 0xC0, 0xFF, 0x7B, 0x00, 0x7C };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+
+    format::iarchive in(result);
+    std::vector<token::float32::type> output;
+    in >> output;
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 value.begin(), value.end(),
+                                 std::equal_to<token::float32::type>());
+}
+
+void test_float64_bfloat16()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    ar.precision(format::precision::bfloat16);
+    std::vector<token::float64::type> value = { 1.0, -2.0, 0.5 };
+    ar << value;
+
+    output_type expected[] = { token::code::array8_bfloat16, 0x06,
+                               0x80, 0x3F, 0x00, 0xC0, 0x00, 0x3F };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+
+    format::iarchive in(result);
+    std::vector<token::float64::type> output;
+    in >> output;
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 value.begin(), value.end(),
+                                 std::equal_to<token::float64::type>());
+}
+
+void test_int64_packed()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    ar.packing(format::packing::delta);
+    std::vector<std::int64_t> value(100);
+    for (std::size_t i = 0; i < value.size(); ++i)
+    {
+        value[i] = 1500000000000 + 1000 * static_cast<std::int64_t>(i);
+    }
+    ar << value;
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 2 + 26);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_packed);
+
+    format::iarchive in(result);
+    std::vector<std::int64_t> output;
+    in >> output;
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 value.begin(), value.end(),
+                                 std::equal_to<std::int64_t>());
+}
+
 void run()
 {
     test_int8_empty();
@@ -637,13 +718,118 @@ void run()
 
     test_int64_empty();
     test_uint64_empty();
+    test_int64_packed();
 
     test_float32_empty();
     test_float64_empty();
+    test_float32_float16();
+    test_float64_bfloat16();
 }
 
 } // namespace compact_vector_suite
 
+//-----------------------------------------------------------------------------
+// Bulk sequences
+//-----------------------------------------------------------------------------
+
+struct bulk_point
+{
+    std::int16_t x;
+    std::int16_t y;
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(bulk_point)
+
+namespace bulk_suite
+{
+
+void test_long_long()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    std::vector<long long> value = { 1, -1 };
+    ar << value;
+
+    output_type expected[] = { token::code::array8_int64, 0x10,
+                               0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                               0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_char()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    std::vector<char> value = { 'A', 'B' };
+    ar << value;
+
+    output_type expected[] = { token::code::array8_int8, 0x02, 'A', 'B' };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_pair()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    std::vector<std::pair<std::int16_t, bool>> value = { { 1, true }, { 2, false } };
+    ar << value;
+
+    output_type expected[] = { token::code::begin_record,
+                               token::code::array8_int16, 0x04, 0x01, 0x00, 0x02, 0x00,
+                               token::code::array8_int8, 0x02, 0x01, 0x00,
+                               token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_pair_array()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    std::array<std::pair<std::int8_t, std::int8_t>, 2> value = {{ { 1, 2 }, { 3, 4 } }};
+    ar << value;
+
+    output_type expected[] = { token::code::begin_record,
+                               token::code::array8_int8, 0x02, 0x01, 0x03,
+                               token::code::array8_int8, 0x02, 0x02, 0x04,
+                               token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_bitwise()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    std::vector<bulk_point> value = { { 1, 2 }, { 3, -1 } };
+    ar << value;
+
+    // Raw bytes in host byte order
+    std::vector<output_type> expected = { token::code::array8_int8, 0x08 };
+    const output_type *raw = reinterpret_cast<const output_type *>(value.data());
+    expected.insert(expected.end(), raw, raw + value.size() * sizeof(bulk_point));
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected.begin(), expected.end(),
+                                 std::equal_to<output_type>());
+}
+
+void run()
+{
+    test_long_long();
+    test_char();
+    test_pair();
+    test_pair_array();
+    test_bitwise();
+}
+
+} // namespace bulk_suite
+
 //-----------------------------------------------------------------------------
 // std::set
 //-----------------------------------------------------------------------------
@@ -803,12 +989,37 @@ void test_int_string_two()
                                  std::equal_to<output_type>());
 }
 
+void test_string_int_dictionary()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    ar.dictionary(true);
+    std::vector<std::map<std::string, int>> value(3);
+    for (auto& entry : value)
+    {
+        entry["level"] = 1;
+        entry["message"] = 2;
+    }
+    ar << value;
+
+    // Keys are defined once and referenced thereafter
+    const output_type define[] = { token::code::string_define, 0x05, 'l', 'e', 'v', 'e', 'l' };
+    TRIAL_PROTOCOL_TEST(std::search(result.begin(), result.end(), define, define + sizeof(define)) != result.end());
+    TRIAL_PROTOCOL_TEST_EQUAL(std::count(result.begin(), result.end(), token::code::string_define), 2);
+
+    format::iarchive in(result);
+    std::vector<std::map<std::string, int>> output;
+    in >> output;
+    TRIAL_PROTOCOL_TEST(output == value);
+}
+
 void run()
 {
     test_string_bool_empty();
     test_string_bool_one();
     test_string_bool_two();
     test_int_string_two();
+    test_string_int_dictionary();
 }
 
 } // namespace map_suite
@@ -824,6 +1035,7 @@ int main()
     pair_suite::run();
     vector_suite::run();
     compact_vector_suite::run();
+    bulk_suite::run();
     set_suite::run();
     map_suite::run();
 
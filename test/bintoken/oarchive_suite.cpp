@@ -14,6 +14,7 @@
 #include <trial/protocol/buffer/vector.hpp>
 #include <trial/protocol/bintoken/serialization.hpp>
 #include <trial/protocol/bintoken/serialization/array.hpp>
+#include <trial/protocol/bintoken/serialization/field.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
 
 using namespace trial::protocol;
@@ -926,6 +927,76 @@ void run()
 
 } // namespace dynamic_suite
 
+//-----------------------------------------------------------------------------
+// Tagged fields
+//-----------------------------------------------------------------------------
+
+namespace field_suite
+{
+
+struct person
+{
+    person(const std::string& name, int age)
+        : name(name),
+          age(age)
+    {}
+
+    template<typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & format::field(1, name);
+        archive & format::field(2, age);
+    }
+
+    std::string name;
+    int age;
+};
+
+void test_person()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    person value("ABC", 127);
+    ar << value;
+
+    output_type expected[] = { token::code::begin_record,
+                              token::code::field, 0x02,
+                              token::code::string8, 0x03, 0x41, 0x42, 0x43,
+                              token::code::field, 0x04,
+                              0x7F,
+                              token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_person_prefix()
+{
+    std::vector<output_type> result;
+    format::oarchive ar(result);
+    ar.length_prefix(true);
+    person value("ABC", 127);
+    ar << value;
+
+    output_type expected[] = { token::code::begin_record32, 0x0B, 0x00, 0x00, 0x00,
+                              token::code::field, 0x02,
+                              token::code::string8, 0x03, 0x41, 0x42, 0x43,
+                              token::code::field, 0x04,
+                              0x7F,
+                              token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void run()
+{
+    test_person();
+    test_person_prefix();
+}
+
+} // namespace field_suite
+
 //-----------------------------------------------------------------------------
 // main
 //-----------------------------------------------------------------------------
@@ -941,6 +1012,7 @@ int main()
     struct_suite::run();
     split_struct_suite::run();
     dynamic_suite::run();
+    field_suite::run();
 
     return boost::report_errors();
 }
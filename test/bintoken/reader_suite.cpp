@@ -8,10 +8,14 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <limits>
+#include <vector>
 #include <trial/protocol/buffer/array.hpp>
 #include <trial/protocol/bintoken/reader.hpp>
+#include <trial/protocol/bintoken/detail/endian.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
 
 namespace format = trial::protocol::bintoken;
@@ -1179,6 +1183,85 @@ void fail_float64_overflow()
                                     format::error, "overflow");
 }
 
+void test_int32_large_unaligned()
+{
+    // Offset by one to exercise unaligned bulk decoding
+    const std::size_t count = 1000;
+    std::vector<value_type> input(1 + 1 + 2 + count * token::int32::size);
+    input[1] = token::code::array16_int32;
+    input[2] = static_cast<value_type>((count * token::int32::size) & 0xFF);
+    input[3] = static_cast<value_type>((count * token::int32::size) >> 8);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::uint32_t number = static_cast<std::uint32_t>(i * 0x01020304);
+        for (std::size_t k = 0; k < token::int32::size; ++k)
+        {
+            input[4 + i * token::int32::size + k] = static_cast<value_type>(number >> (8 * k));
+        }
+    }
+    format::reader reader(format::reader::view_type(input.data() + 1, input.size() - 1));
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::array16_int32);
+    TRIAL_PROTOCOL_TEST(reader.length() == count);
+    std::vector<std::int32_t> buffer(count);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array<std::int32_t>(buffer.data(), buffer.size()), buffer.size());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[i], static_cast<std::int32_t>(static_cast<std::uint32_t>(i * 0x01020304)));
+    }
+}
+
+void test_widen_int8()
+{
+    const value_type input[] = { token::code::array8_int8, 3 * token::int8::size, 0x01, 0x80, 0xFF };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 3);
+    {
+        std::int16_t buffer[3];
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.array(buffer, 3), 3);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[0], 1);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[1], -128);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[2], -1);
+    }
+    {
+        std::int64_t buffer[3];
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.array(buffer, 3), 3);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[0], 1);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[1], -128);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[2], -1);
+    }
+    {
+        std::uint32_t buffer[3];
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.array(buffer, 3), 3);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[0], 1U);
+        TRIAL_PROTOCOL_TEST_EQUAL(buffer[2], std::numeric_limits<std::uint32_t>::max());
+    }
+}
+
+void test_widen_int32()
+{
+    const value_type input[] = { token::code::array8_int32, token::int32::size, 0x00, 0x00, 0x00, 0x80 };
+    format::reader reader(input);
+    std::int64_t buffer[1];
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(buffer, 1), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(buffer[0], std::numeric_limits<std::int32_t>::min());
+}
+
+void fail_narrow()
+{
+    const value_type input[] = { token::code::array8_int32, token::int32::size, 0x01, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    {
+        std::int16_t buffer[1];
+        TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(buffer, 1),
+                                        format::error, "incompatible type");
+    }
+    {
+        float buffer[1];
+        TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(buffer, 1),
+                                        format::error, "incompatible type");
+    }
+}
+
 void run()
 {
     test_int8();
@@ -1193,6 +1276,10 @@ void run()
     fail_float32_overflow();
     test_float64();
     fail_float64_overflow();
+    test_int32_large_unaligned();
+    test_widen_int8();
+    test_widen_int32();
+    fail_narrow();
 }
 
 } // namespace compact_suite
@@ -1276,6 +1363,1186 @@ void run()
 
 } // namespace container_suite
 
+//-----------------------------------------------------------------------------
+// Skip
+//-----------------------------------------------------------------------------
+
+namespace skip_suite
+{
+
+void test_scalar()
+{
+    const value_type input[] = { 0x01, 0x02 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void test_record()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 0x01,
+                                 token::code::begin_array, 0x02, token::code::end_array,
+                                 token::code::end_record,
+                                 0x03 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::begin_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 3);
+}
+
+void test_record_last()
+{
+    const value_type input[] = { token::code::begin_record, token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void test_record32()
+{
+    const value_type input[] = { token::code::begin_record32, 0x06, 0x00, 0x00, 0x00,
+                                 0x01,
+                                 token::code::begin_array, 0x02, token::code::end_array,
+                                 0x7F,
+                                 token::code::end_record,
+                                 0x03 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::begin_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::begin_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.literal().size(), 6);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 3);
+}
+
+void test_record32_next()
+{
+    // Prefixed containers can also be traversed token by token
+    const value_type input[] = { token::code::begin_array32, 0x02, 0x00, 0x00, 0x00,
+                                 0x01,
+                                 token::code::end_array };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::begin_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+}
+
+void test_nested32()
+{
+    const value_type input[] = { token::code::begin_array32, 0x08, 0x00, 0x00, 0x00,
+                                 token::code::begin_record32, 0x02, 0x00, 0x00, 0x00,
+                                 0x01,
+                                 token::code::end_record,
+                                 token::code::end_array,
+                                 0x03 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::begin_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 3);
+}
+
+void fail_record_truncated()
+{
+    const value_type input[] = { token::code::begin_record, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::error);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.error(), format::expected_end_record);
+}
+
+void fail_record32_mismatch()
+{
+    const value_type input[] = { token::code::begin_record32, 0x02, 0x00, 0x00, 0x00,
+                                 0x01,
+                                 token::code::end_array };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.error(), format::expected_end_record);
+}
+
+void fail_record32_zero()
+{
+    const value_type input[] = { token::code::begin_record32, 0x00, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::error);
+}
+
+void run()
+{
+    test_scalar();
+    test_record();
+    test_record_last();
+    test_record32();
+    test_record32_next();
+    test_nested32();
+    fail_record_truncated();
+    fail_record32_mismatch();
+    fail_record32_zero();
+}
+
+} // namespace skip_suite
+
+//-----------------------------------------------------------------------------
+// Array view
+//-----------------------------------------------------------------------------
+
+namespace view_suite
+{
+
+template <typename T, std::size_t N>
+struct alignas(alignof(T)) aligned_input
+{
+    value_type data[N];
+};
+
+void test_int32_aliased()
+{
+    // Payload starts at offset 4
+    const aligned_input<std::int32_t, 12> input = {{
+        token::code::padding, token::code::padding,
+        token::code::array8_int32, 2 * token::int32::size,
+        0x01, 0x00, 0x00, 0x00,
+        0x02, 0x01, 0x00, 0x00 }};
+    format::reader reader(format::reader::view_type(input.data, sizeof(input.data)));
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::array8_int32);
+    auto view = reader.array_view<std::int32_t>();
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], 0x0102);
+    if (format::detail::endian::is_native)
+    {
+        TRIAL_PROTOCOL_TEST(view.aliased());
+        TRIAL_PROTOCOL_TEST(view.data() == reinterpret_cast<const std::int32_t *>(input.data + 4));
+    }
+    else
+    {
+        TRIAL_PROTOCOL_TEST(!view.aliased());
+    }
+}
+
+void test_int32_unaligned()
+{
+    // Payload starts at offset 3
+    const aligned_input<std::int32_t, 11> input = {{
+        token::code::padding,
+        token::code::array8_int32, 2 * token::int32::size,
+        0x01, 0x00, 0x00, 0x00,
+        0x02, 0x01, 0x00, 0x00 }};
+    format::reader reader(format::reader::view_type(input.data, sizeof(input.data)));
+    auto view = reader.array_view<std::int32_t>();
+    TRIAL_PROTOCOL_TEST(!view.aliased());
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], 0x0102);
+}
+
+void test_uint16()
+{
+    const aligned_input<std::uint16_t, 4> input = {{
+        token::code::array8_int16, token::int16::size,
+        0xFF, 0xFF }};
+    format::reader reader(format::reader::view_type(input.data, sizeof(input.data)));
+    auto view = reader.array_view<std::uint16_t>();
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 0xFFFF);
+}
+
+void test_float64_copy()
+{
+    // Payload at offset 2 is misaligned
+    const aligned_input<token::float64::type, 10> input = {{
+        token::code::array8_float64, token::float64::size,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F }};
+    format::reader reader(format::reader::view_type(input.data, sizeof(input.data)));
+    auto view = reader.array_view<token::float64::type>();
+    TRIAL_PROTOCOL_TEST(!view.aliased());
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1.0);
+}
+
+void test_scalar()
+{
+    const value_type input[] = { token::code::int32, 0x01, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    auto view = reader.array_view<std::int32_t>();
+    TRIAL_PROTOCOL_TEST(!view.aliased());
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1);
+}
+
+void test_empty()
+{
+    const value_type input[] = { token::code::array8_int64, 0x00 };
+    format::reader reader(input);
+    auto view = reader.array_view<std::int64_t>();
+    TRIAL_PROTOCOL_TEST(view.empty());
+    TRIAL_PROTOCOL_TEST(view.begin() == view.end());
+}
+
+void test_widen()
+{
+    const value_type input[] = { token::code::array8_int16, 2 * token::int16::size,
+                                 0x01, 0x00,
+                                 0xFF, 0xFF };
+    format::reader reader(input);
+    const auto view = reader.array_view<std::int64_t>();
+    TRIAL_PROTOCOL_TEST(!view.aliased());
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], -1);
+}
+
+void fail_incompatible()
+{
+    const value_type input[] = { token::code::array8_int16, token::int16::size, 0x01, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array_view<std::int8_t>(),
+                                    format::error, "incompatible type");
+}
+
+void run()
+{
+    test_int32_aliased();
+    test_int32_unaligned();
+    test_uint16();
+    test_float64_copy();
+    test_scalar();
+    test_empty();
+    test_widen();
+    fail_incompatible();
+}
+
+} // namespace view_suite
+
+//-----------------------------------------------------------------------------
+// Variable-length integers
+//-----------------------------------------------------------------------------
+
+namespace varint_suite
+{
+
+void test_small()
+{
+    const value_type input[] = { token::code::varint, 0x02 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::varint);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::integer);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<token::varint>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+}
+
+void test_negative()
+{
+    const value_type input[] = { token::code::varint, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<token::varint>(), -1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), -1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::uint8_t>(), 0xFF);
+}
+
+void test_multibyte()
+{
+    const value_type input[] = { token::code::varint, 0x80, 0x89, 0x7A };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::int32_t>(), 1000000);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::uint32_t>(), 1000000U);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.value<std::int16_t>(),
+                                    format::error, "overflow");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+}
+
+void test_int64_max()
+{
+    const value_type input[] = { token::code::varint,
+                                 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::int64_t>(), std::numeric_limits<std::int64_t>::max());
+}
+
+void test_int64_min()
+{
+    const value_type input[] = { token::code::varint,
+                                 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::int64_t>(), std::numeric_limits<std::int64_t>::min());
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.value<std::int32_t>(),
+                                    format::error, "overflow");
+}
+
+void fail_truncated()
+{
+    const value_type input[] = { token::code::varint, 0x80, 0x80 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void fail_too_long()
+{
+    const value_type input[] = { token::code::varint,
+                                 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void test_array()
+{
+    const value_type input[] = { token::code::array8_varint, 0x05, 0x02, 0x01, 0x80, 0x89, 0x7A };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 3);
+    {
+        std::int32_t output[3] = {};
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 3), 3);
+        TRIAL_PROTOCOL_TEST_EQUAL(output[0], 1);
+        TRIAL_PROTOCOL_TEST_EQUAL(output[1], -1);
+        TRIAL_PROTOCOL_TEST_EQUAL(output[2], 1000000);
+    }
+    {
+        std::int64_t output[3] = {};
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 3), 3);
+        TRIAL_PROTOCOL_TEST_EQUAL(output[2], 1000000);
+    }
+    {
+        std::int16_t output[3] = {};
+        TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(output, 3),
+                                        format::error, "overflow");
+    }
+    {
+        std::int32_t output[2] = {};
+        TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(output, 2),
+                                        format::error, "overflow");
+    }
+    {
+        float output[3] = {};
+        TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(output, 3),
+                                        format::error, "incompatible type");
+    }
+}
+
+void test_array_view()
+{
+    const value_type input[] = { token::code::array8_varint, 0x03, 0x02, 0x04, 0x06 };
+    format::reader reader(input);
+    const auto view = reader.array_view<std::uint16_t>();
+    TRIAL_PROTOCOL_TEST(!view.aliased());
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[2], 3);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array_view<double>(),
+                                    format::error, "incompatible type");
+}
+
+void fail_array_malformed()
+{
+    // Last value is missing its final byte
+    const value_type input[] = { token::code::array8_varint, 0x02, 0x02, 0x80 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void run()
+{
+    test_small();
+    test_negative();
+    test_multibyte();
+    test_int64_max();
+    test_int64_min();
+    fail_truncated();
+    fail_too_long();
+    test_array();
+    test_array_view();
+    fail_array_malformed();
+}
+
+} // namespace varint_suite
+
+//-----------------------------------------------------------------------------
+// Packed integers
+//-----------------------------------------------------------------------------
+
+namespace packed_suite
+{
+
+void test_frame_of_reference()
+{
+    // Reference 10 with 4-bit values 1, 2, 3
+    const value_type input[] = { token::code::array8_packed, 20,
+                                 0x00, 0x04,
+                                 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x21, 0x03 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 3);
+    std::int32_t output[3] = {};
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 3), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[0], 11);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[1], 12);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[2], 13);
+}
+
+void test_delta()
+{
+    // First 1000 with reference -1 and 2-bit values 0, 1, 2
+    const value_type input[] = { token::code::array8_packed, 27,
+                                 0x01, 0x02,
+                                 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                 0xE8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x24 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 4);
+    std::int64_t output[4] = {};
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 4), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[0], 1000);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[1], 999);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[2], 999);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[3], 1000);
+    {
+        std::int8_t narrow[4] = {};
+        TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(narrow, 4),
+                                        format::error, "overflow");
+    }
+}
+
+void test_array_view()
+{
+    // Constant sequence needs no packed bits
+    const value_type input[] = { token::code::array8_packed, 18,
+                                 0x00, 0x00,
+                                 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    const auto view = reader.array_view<std::uint16_t>();
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], 7);
+}
+
+void fail_length()
+{
+    // Packed values are one byte short
+    const value_type input[] = { token::code::array8_packed, 19,
+                                 0x00, 0x04,
+                                 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x21 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_mode()
+{
+    const value_type input[] = { token::code::array8_packed, 18,
+                                 0x02, 0x00,
+                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_width()
+{
+    const value_type input[] = { token::code::array8_packed, 18,
+                                 0x00, 0x41,
+                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void run()
+{
+    test_frame_of_reference();
+    test_delta();
+    test_array_view();
+    fail_length();
+    fail_mode();
+    fail_width();
+}
+
+} // namespace packed_suite
+
+//-----------------------------------------------------------------------------
+// Dictionary
+//-----------------------------------------------------------------------------
+
+namespace dictionary_suite
+{
+
+void test_reference()
+{
+    const value_type input[] = { token::code::string_define, 0x05, 'a', 'l', 'p', 'h', 'a',
+                                 token::code::string_reference8, 0x00,
+                                 token::code::string_reference8, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::string8);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::string);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "alpha");
+    const auto data = reader.literal().data();
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "alpha");
+    // Interned
+    TRIAL_PROTOCOL_TEST(reader.literal().data() == data);
+    TRIAL_PROTOCOL_TEST(!reader.next());
+}
+
+void test_reference16()
+{
+    const value_type input[] = { token::code::string_define, 0x01, 'a',
+                                 token::code::string_reference16, 0x00, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "a");
+}
+
+void test_container()
+{
+    const value_type input[] = { token::code::string_define, 0x03, 'k', 'e', 'y',
+                                 token::code::begin_assoc_array32, 0x04, 0x00, 0x00, 0x00,
+                                 token::code::string_reference8, 0x00,
+                                 token::code::true_value,
+                                 token::code::end_assoc_array,
+                                 token::code::string_reference8, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::begin_assoc_array);
+    TRIAL_PROTOCOL_TEST(reader.skip());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "key");
+}
+
+void fail_unknown_reference()
+{
+    const value_type input[] = { token::code::string_define, 0x01, 'a',
+                                 token::code::string_reference8, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_truncated_define()
+{
+    const value_type input[] = { token::code::string_define, 0x05, 'a' };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void run()
+{
+    test_reference();
+    test_reference16();
+    test_container();
+    fail_unknown_reference();
+    fail_truncated_define();
+}
+
+} // namespace dictionary_suite
+
+//-----------------------------------------------------------------------------
+// Tagged fields
+//-----------------------------------------------------------------------------
+
+namespace field_suite
+{
+
+void test_field()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x02,
+                                 0x2A,
+                                 token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::field);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::field);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.category(), token::category::structural);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<token::field>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 42);
+}
+
+void test_find_field()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x02,
+                                 token::code::begin_array, 0x01, 0x02, token::code::end_array,
+                                 token::code::field, 0x04,
+                                 token::code::string8, 0x01, 'A',
+                                 token::code::field, 0x06,
+                                 0x2A,
+                                 token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.find_field(3), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 42);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_record);
+}
+
+void test_find_field_prefixed()
+{
+    // Unknown container fields are skipped without being decoded
+    const value_type input[] = { token::code::begin_record32, 0x0E, 0x00, 0x00, 0x00,
+                                 token::code::field, 0x02,
+                                 token::code::begin_array32, 0x03, 0x00, 0x00, 0x00,
+                                 0x01, 0x02, token::code::end_array,
+                                 token::code::field, 0x04,
+                                 0x2A,
+                                 token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.find_field(2), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 42);
+}
+
+void test_find_field_missing()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x02,
+                                 0x01,
+                                 token::code::field, 0x04,
+                                 0x02,
+                                 token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.find_field(3), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    // Not at a field
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.find_field(1), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_record);
+}
+
+void test_find_field_larger()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x04,
+                                 0x2A,
+                                 token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    // Search stops at a larger tag
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.find_field(1), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::field);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.find_field(2), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 42);
+}
+
+void test_skip_field()
+{
+    const value_type input[] = { token::code::begin_record,
+                                 token::code::field, 0x02,
+                                 token::code::begin_record, 0x01, token::code::end_record,
+                                 token::code::end_record };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+}
+
+void fail_negative_tag()
+{
+    const value_type input[] = { token::code::field, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::error);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.error(), format::invalid_value);
+}
+
+void fail_truncated_tag()
+{
+    const value_type input[] = { token::code::field, 0x80 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void run()
+{
+    test_field();
+    test_find_field();
+    test_find_field_prefixed();
+    test_find_field_missing();
+    test_find_field_larger();
+    test_skip_field();
+    fail_negative_tag();
+    fail_truncated_tag();
+}
+
+} // namespace field_suite
+
+//-----------------------------------------------------------------------------
+// Trusted input
+//-----------------------------------------------------------------------------
+
+namespace trusted_suite
+{
+
+// Trusted and validating readers yield the same tokens for valid input
+template <std::size_t N>
+void compare(const value_type (&input)[N])
+{
+    format::reader expected(input);
+    format::reader reader(input, format::trusted);
+    do
+    {
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), expected.code());
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), expected.level());
+        TRIAL_PROTOCOL_TEST(reader.literal() == expected.literal());
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), expected.next());
+    } while (expected.category() != token::category::status);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), expected.code());
+}
+
+void test_scalars()
+{
+    const value_type input[] = { token::code::null,
+                                 token::code::true_value,
+                                 0x7F,
+                                 0xE0,
+                                 token::code::int8, 0x80,
+                                 token::code::int16, 0x00, 0x01,
+                                 token::code::int32, 0x00, 0x00, 0x01, 0x00,
+                                 token::code::int64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+                                 token::code::float32, 0x00, 0x00, 0x80, 0x3F,
+                                 token::code::float64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F,
+                                 token::code::varint, 0x80, 0x01 };
+    compare(input);
+
+    format::reader reader(input, format::trusted);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<bool>(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 0x7F);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), -32);
+}
+
+void test_strings_and_arrays()
+{
+    const value_type input[] = { token::code::string8, 0x03, 'A', 'B', 'C',
+                                 token::code::string16, 0x01, 0x00, 'D',
+                                 token::code::padding,
+                                 token::code::array8_int16, 0x04, 0x01, 0x00, 0x02, 0x00,
+                                 token::code::array32_float32, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F,
+                                 token::code::array8_varint, 0x02, 0x02, 0x04 };
+    compare(input);
+
+    format::reader reader(input, format::trusted);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "ABC");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 2);
+}
+
+void test_containers()
+{
+    const value_type input[] = { token::code::begin_array,
+                                 token::code::begin_record32, 0x06, 0x00, 0x00, 0x00,
+                                 token::code::field, 0x02,
+                                 0x01,
+                                 token::code::begin_assoc_array,
+                                 token::code::end_assoc_array,
+                                 token::code::end_record,
+                                 token::code::end_array };
+    compare(input);
+
+    format::reader reader(input, format::trusted);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.skip(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+}
+
+void test_unbalanced()
+{
+    // Nesting is not validated
+    const value_type input[] = { token::code::begin_array,
+                                 token::code::end_record };
+    format::reader reader(input, format::trusted);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_record);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void test_truncated()
+{
+    {
+        const value_type input[] = { token::code::int32, 0x00, 0x00 };
+        format::reader reader(input, format::trusted);
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+    }
+    {
+        const value_type input[] = { token::code::string16, 0x00 };
+        format::reader reader(input, format::trusted);
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+    }
+    {
+        const value_type input[] = { token::code::string8, 0x03, 'A', 'B' };
+        format::reader reader(input, format::trusted);
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+    }
+    {
+        const value_type input[] = { token::code::array64_int8,
+                                     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+        format::reader reader(input, format::trusted);
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+    }
+}
+
+void run()
+{
+    test_scalars();
+    test_strings_and_arrays();
+    test_containers();
+    test_unbalanced();
+    test_truncated();
+}
+
+} // namespace trusted_suite
+
+//-----------------------------------------------------------------------------
+// Tensor
+//-----------------------------------------------------------------------------
+
+namespace tensor_suite
+{
+
+void test_matrix()
+{
+    const value_type input[] = { token::code::tensor, 0x02,
+                                 0x02, 0x00, 0x00, 0x00,
+                                 0x03, 0x00, 0x00, 0x00,
+                                 token::code::array8_int16, 0x0C,
+                                 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+                                 0x04, 0x00, 0x05, 0x00, 0x06, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::array8_int16);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.rank(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.extent(0), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.extent(1), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 6);
+    auto view = reader.array_view<std::int16_t>();
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 6);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[5], 6);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.rank(), 0);
+}
+
+void test_zero_copy()
+{
+    const value_type input[] = { token::code::tensor, 0x01,
+                                 0x02, 0x00, 0x00, 0x00,
+                                 token::code::padding,
+                                 token::code::array8_int32, 0x08,
+                                 0x01, 0x00, 0x00, 0x00,
+                                 0x02, 0x00, 0x00, 0x00 };
+    alignas(std::int32_t) value_type aligned[sizeof(input) + 3] = {};
+    std::copy(input, input + sizeof(input), aligned + 3);
+    format::reader reader(format::reader::view_type(aligned + 3, sizeof(input)));
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::array8_int32);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.rank(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.extent(0), 2);
+    auto view = reader.array_view<std::int32_t>();
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 2);
+    if (format::detail::endian::is_native)
+    {
+        TRIAL_PROTOCOL_TEST(reinterpret_cast<const value_type *>(view.data()) == aligned + 12);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], 2);
+}
+
+void test_empty()
+{
+    const value_type input[] = { token::code::tensor, 0x02,
+                                 0x00, 0x00, 0x00, 0x00,
+                                 0x04, 0x00, 0x00, 0x00,
+                                 token::code::array8_float32, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::array8_float32);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.rank(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.extent(0), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.extent(1), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 0);
+}
+
+void test_array()
+{
+    // Arrays without shape have a single dimension
+    const value_type input[] = { token::code::array8_int8, 0x03, 0x01, 0x02, 0x03 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.rank(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.extent(0), 3);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.extent(1),
+                                    format::error,
+                                    "invalid value");
+}
+
+void fail_rank_zero()
+{
+    const value_type input[] = { token::code::tensor, 0x00,
+                                 token::code::array8_int8, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_size()
+{
+    const value_type input[] = { token::code::tensor, 0x02,
+                                 0x02, 0x00, 0x00, 0x00,
+                                 0x02, 0x00, 0x00, 0x00,
+                                 token::code::array8_int8, 0x03, 0x01, 0x02, 0x03 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_overflow()
+{
+    const value_type input[] = { token::code::tensor, 0x03,
+                                 0xFF, 0xFF, 0xFF, 0xFF,
+                                 0xFF, 0xFF, 0xFF, 0xFF,
+                                 0xFF, 0xFF, 0xFF, 0xFF,
+                                 token::code::array8_int8, 0x01, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_not_array()
+{
+    const value_type input[] = { token::code::tensor, 0x01,
+                                 0x01, 0x00, 0x00, 0x00,
+                                 token::code::int8, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_unexpected_token);
+}
+
+void fail_nested()
+{
+    const value_type input[] = { token::code::tensor, 0x01,
+                                 0x01, 0x00, 0x00, 0x00,
+                                 token::code::tensor, 0x01,
+                                 0x01, 0x00, 0x00, 0x00,
+                                 token::code::array8_int8, 0x01, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_unexpected_token);
+}
+
+void fail_truncated()
+{
+    const value_type input[] = { token::code::tensor, 0x02,
+                                 0x02, 0x00, 0x00, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void run()
+{
+    test_matrix();
+    test_zero_copy();
+    test_empty();
+    test_array();
+    fail_rank_zero();
+    fail_size();
+    fail_overflow();
+    fail_not_array();
+    fail_nested();
+    fail_truncated();
+}
+
+} // namespace tensor_suite
+
+//-----------------------------------------------------------------------------
+// Boolean arrays
+//-----------------------------------------------------------------------------
+
+namespace bool_array_suite
+{
+
+void test_partial()
+{
+    const value_type input[] = { token::code::array8_bool, 0x03,
+                                 0x05, 0x0B, 0x06 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 11);
+    bool output[11] = {};
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 11), 11);
+    const bool expected[] = { true, true, false, true, false, false, false, false,
+                              false, true, true };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output, output + 11,
+                                 expected, expected + 11,
+                                 std::equal_to<bool>());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+}
+
+void test_empty()
+{
+    const value_type input[] = { token::code::array16_bool, 0x01, 0x00,
+                                 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::array16_bool);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 0);
+}
+
+void test_trusted()
+{
+    const value_type input[] = { token::code::array8_bool, 0x02,
+                                 0x06, 0x01,
+                                 token::code::null };
+    format::reader reader(input, format::trusted);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 2);
+    bool output[2] = { false, true };
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 2), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[0], true);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[1], false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::null);
+}
+
+void fail_unused()
+{
+    const value_type input[] = { token::code::array8_bool, 0x02,
+                                 0x08, 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_unused_empty()
+{
+    const value_type input[] = { token::code::array8_bool, 0x01,
+                                 0x01 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_missing_header()
+{
+    const value_type input[] = { token::code::array8_bool, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_value);
+}
+
+void fail_incompatible()
+{
+    const value_type input[] = { token::code::array8_bool, 0x02,
+                                 0x06, 0x01 };
+    format::reader reader(input);
+    std::int8_t output[2] = {};
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(output, 2),
+                                    format::error, "incompatible type");
+}
+
+void run()
+{
+    test_partial();
+    test_empty();
+    test_trusted();
+    fail_unused();
+    fail_unused_empty();
+    fail_missing_header();
+    fail_incompatible();
+}
+
+} // namespace bool_array_suite
+
+//-----------------------------------------------------------------------------
+// 16-bit real arrays
+//-----------------------------------------------------------------------------
+
+namespace half_array_suite
+{
+
+void test_float16()
+{
+    const value_type input[] = { token::code::array8_float16, 0x08,
+                                 0x00, 0x3C, 0x01, 0x00, 0x00, 0xFC, 0x00, 0x7E };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), token::symbol::array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 4);
+    float output[4] = {};
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 4), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[0], 1.0f);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[1], std::ldexp(1.0f, -24));
+    TRIAL_PROTOCOL_TEST_EQUAL(output[2], -std::numeric_limits<float>::infinity());
+    TRIAL_PROTOCOL_TEST(std::isnan(output[3]));
+}
+
+void test_bfloat16()
+{
+    const value_type input[] = { token::code::array16_bfloat16, 0x04, 0x00,
+                                 0x80, 0x3F, 0x00, 0xC0 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 2);
+    double output[2] = {};
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output, 2), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[0], 1.0);
+    TRIAL_PROTOCOL_TEST_EQUAL(output[1], -2.0);
+}
+
+void test_array_view()
+{
+    const value_type input[] = { token::code::array8_float16, 0x04,
+                                 0x00, 0x38, 0x00, 0x3E };
+    format::reader reader(input);
+    const auto view = reader.array_view<float>();
+    TRIAL_PROTOCOL_TEST_EQUAL(view.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[0], 0.5f);
+    TRIAL_PROTOCOL_TEST_EQUAL(view[1], 1.5f);
+}
+
+void fail_odd_length()
+{
+    const value_type input[] = { token::code::array8_float16, 0x03,
+                                 0x00, 0x3C, 0x00 };
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::error_invalid_length);
+}
+
+void fail_integer()
+{
+    const value_type input[] = { token::code::array8_float16, 0x02,
+                                 0x00, 0x3C };
+    format::reader reader(input);
+    std::int32_t output[1] = {};
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array(output, 1),
+                                    format::error, "incompatible type");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.array_view<std::int16_t>(),
+                                    format::error, "incompatible type");
+}
+
+void run()
+{
+    test_float16();
+    test_bfloat16();
+    test_array_view();
+    fail_odd_length();
+    fail_integer();
+}
+
+} // namespace half_array_suite
+
 //-----------------------------------------------------------------------------
 // main
 //-----------------------------------------------------------------------------
@@ -1287,6 +2554,16 @@ int main()
     string_suite::run();
     compact_suite::run();
     container_suite::run();
+    skip_suite::run();
+    view_suite::run();
+    varint_suite::run();
+    packed_suite::run();
+    dictionary_suite::run();
+    field_suite::run();
+    trusted_suite::run();
+    tensor_suite::run();
+    bool_array_suite::run();
+    half_array_suite::run();
 
     return boost::report_errors();
 }
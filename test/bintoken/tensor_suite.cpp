@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/serialization.hpp>
+#include <trial/protocol/bintoken/serialization/tensor.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+namespace format = trial::protocol::bintoken;
+namespace token = format::token;
+using value_type = std::uint8_t;
+using output_type = std::vector<value_type>;
+
+namespace
+{
+
+struct image
+{
+    std::string name;
+    std::vector<float> pixels;
+    std::vector<std::size_t> shape;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & name;
+        archive & format::tensor(pixels, shape);
+    }
+};
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Save
+//-----------------------------------------------------------------------------
+
+namespace save_suite
+{
+
+void test_matrix()
+{
+    output_type result;
+    format::oarchive ar(result);
+    const std::vector<std::int16_t> value = { 1, 2, 3, 4, 5, 6 };
+    const std::vector<std::size_t> shape = { 3, 2 };
+    ar << format::tensor(value, shape);
+
+    output_type expected = { token::code::tensor, 0x02,
+                             0x03, 0x00, 0x00, 0x00,
+                             0x02, 0x00, 0x00, 0x00,
+                             token::code::array8_int16, 0x0C,
+                             0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+                             0x04, 0x00, 0x05, 0x00, 0x06, 0x00 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected.begin(), expected.end(),
+                                 std::equal_to<value_type>());
+}
+
+void test_unsigned()
+{
+    output_type result;
+    format::oarchive ar(result);
+    const std::vector<std::uint8_t> value = { 0x01, 0xFF };
+    const std::vector<std::size_t> shape = { 1, 2 };
+    ar << format::tensor(value, shape);
+
+    output_type expected = { token::code::tensor, 0x02,
+                             0x01, 0x00, 0x00, 0x00,
+                             0x02, 0x00, 0x00, 0x00,
+                             token::code::array8_int8, 0x02, 0x01, 0xFF };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected.begin(), expected.end(),
+                                 std::equal_to<value_type>());
+}
+
+void fail_size()
+{
+    output_type result;
+    format::oarchive ar(result);
+    const std::vector<std::int16_t> value = { 1, 2, 3 };
+    const std::vector<std::size_t> shape = { 2, 2 };
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(ar << format::tensor(value, shape),
+                                    format::error, "invalid value");
+}
+
+void fail_rank()
+{
+    output_type result;
+    format::oarchive ar(result);
+    const std::vector<std::int16_t> value;
+    const std::vector<std::size_t> shape;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(ar << format::tensor(value, shape),
+                                    format::error, "invalid value");
+}
+
+void run()
+{
+    test_matrix();
+    test_unsigned();
+    fail_size();
+    fail_rank();
+}
+
+} // namespace save_suite
+
+//-----------------------------------------------------------------------------
+// Load
+//-----------------------------------------------------------------------------
+
+namespace load_suite
+{
+
+void test_matrix()
+{
+    const output_type input = { token::code::tensor, 0x02,
+                                0x03, 0x00, 0x00, 0x00,
+                                0x02, 0x00, 0x00, 0x00,
+                                token::code::array8_int16, 0x0C,
+                                0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+                                0x04, 0x00, 0x05, 0x00, 0x06, 0x00 };
+    format::iarchive in(input);
+    std::vector<int> value;
+    std::vector<std::size_t> shape;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> format::tensor(value, shape));
+    TRIAL_PROTOCOL_TEST_EQUAL(shape.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(shape[0], 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(shape[1], 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 6);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(value[5], 6);
+}
+
+void test_array()
+{
+    const output_type input = { token::code::array8_int8, 0x03, 0x01, 0x02, 0x03 };
+    format::iarchive in(input);
+    std::vector<std::int8_t> value;
+    std::vector<std::size_t> shape;
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> format::tensor(value, shape));
+    TRIAL_PROTOCOL_TEST_EQUAL(shape.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(shape[0], 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(value.size(), 3);
+}
+
+void fail_not_array()
+{
+    const output_type input = { token::code::begin_array, 0x01, token::code::end_array };
+    format::iarchive in(input);
+    std::vector<std::int8_t> value;
+    std::vector<std::size_t> shape;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> format::tensor(value, shape),
+                                    format::error, "incompatible type");
+}
+
+void fail_size()
+{
+    const output_type input = { token::code::begin_record,
+                                token::code::string8, 0x01, 'A',
+                                token::code::tensor, 0x01,
+                                0x02, 0x00, 0x00, 0x00,
+                                token::code::array8_int8, 0x03, 0x01, 0x02, 0x03,
+                                token::code::end_record };
+    format::iarchive in(input);
+    image value;
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(in >> value,
+                                    format::error, "invalid value");
+}
+
+void run()
+{
+    test_matrix();
+    test_array();
+    fail_not_array();
+    fail_size();
+}
+
+} // namespace load_suite
+
+//-----------------------------------------------------------------------------
+// Round trip
+//-----------------------------------------------------------------------------
+
+namespace round_suite
+{
+
+void test_image()
+{
+    image input;
+    input.name = "image";
+    input.shape = { 2, 3, 4 };
+    for (std::size_t i = 0; i < 2 * 3 * 4; ++i)
+    {
+        input.pixels.push_back(i * 0.5f);
+    }
+    output_type result;
+    {
+        format::oarchive ar(result);
+        ar << input;
+    }
+    image output;
+    format::iarchive in(result);
+    TRIAL_PROTOCOL_TEST_NO_THROW(in >> output);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.name, "image");
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.shape.begin(), output.shape.end(),
+                                 input.shape.begin(), input.shape.end(),
+                                 std::equal_to<std::size_t>());
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.pixels.begin(), output.pixels.end(),
+                                 input.pixels.begin(), input.pixels.end(),
+                                 std::equal_to<float>());
+}
+
+void run()
+{
+    test_image();
+}
+
+} // namespace round_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    save_suite::run();
+    load_suite::run();
+    round_suite::run();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,360 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/string.hpp>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/bintoken/transcode.hpp>
+#include <trial/protocol/bintoken/error.hpp>
+#include <trial/protocol/json/error.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+using output_type = std::vector<std::uint8_t>;
+
+namespace
+{
+
+output_type to_bintoken(const std::string& input,
+                        std::size_t lookahead = bintoken::default_lookahead)
+{
+    output_type result;
+    json::reader reader(input);
+    bintoken::writer writer(result);
+    bintoken::transcode(reader, writer, lookahead);
+    return result;
+}
+
+std::string to_json(const output_type& input)
+{
+    std::string result;
+    bintoken::reader reader(input);
+    json::writer writer(result);
+    bintoken::transcode(reader, writer);
+    return result;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// JSON to bintoken
+//-----------------------------------------------------------------------------
+
+namespace json_suite
+{
+
+void test_null()
+{
+    output_type expected = { bintoken::token::code::null };
+    TRIAL_PROTOCOL_TEST(to_bintoken("null") == expected);
+}
+
+void test_boolean()
+{
+    output_type expected = { bintoken::token::code::true_value };
+    TRIAL_PROTOCOL_TEST(to_bintoken("true") == expected);
+}
+
+void test_integer()
+{
+    output_type expected = { bintoken::token::code::int16, 0xE8, 0x03 };
+    TRIAL_PROTOCOL_TEST(to_bintoken("1000") == expected);
+}
+
+void test_string()
+{
+    output_type expected = { bintoken::token::code::string8, 0x03, 'A', 'B', 'C' };
+    TRIAL_PROTOCOL_TEST(to_bintoken("\"ABC\"") == expected);
+}
+
+void test_empty_array()
+{
+    output_type expected = { bintoken::token::code::begin_array,
+                             bintoken::token::code::end_array };
+    TRIAL_PROTOCOL_TEST(to_bintoken("[]") == expected);
+}
+
+void test_integer_array()
+{
+    output_type result = to_bintoken("[1,2,3]");
+    bintoken::reader reader(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::array);
+    std::vector<std::int64_t> values(3);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(values.data(), values.size()), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(values[0], 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(values[2], 3);
+    TRIAL_PROTOCOL_TEST(!reader.next());
+}
+
+void test_real_array()
+{
+    output_type result = to_bintoken("[1,2.5,3]");
+    bintoken::reader reader(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::array);
+    TRIAL_PROTOCOL_TEST(bintoken::detail::basic_array_code<bintoken::token::code::array8_float64>::same(reader.code()));
+    std::vector<double> values(3);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(values.data(), values.size()), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(values[0], 1.0);
+    TRIAL_PROTOCOL_TEST_EQUAL(values[1], 2.5);
+    TRIAL_PROTOCOL_TEST_EQUAL(values[2], 3.0);
+}
+
+void test_inexact_real_array()
+{
+    // 2^53 + 1 cannot be represented exactly as a double
+    output_type result = to_bintoken("[9007199254740993,0.5]");
+    bintoken::reader reader(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::begin_array);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::int64_t>(), 9007199254740993LL);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<double>(), 0.5);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::end_array);
+}
+
+void test_mixed_array()
+{
+    output_type expected = { bintoken::token::code::begin_array,
+                             0x01,
+                             0x02,
+                             bintoken::token::code::true_value,
+                             0x03,
+                             bintoken::token::code::end_array };
+    TRIAL_PROTOCOL_TEST(to_bintoken("[1,2,true,3]") == expected);
+}
+
+void test_nested_array()
+{
+    output_type result = to_bintoken("[[1,2],[3,4]]");
+    bintoken::reader reader(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::begin_array);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::array);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::array);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.symbol(), bintoken::token::symbol::end_array);
+    TRIAL_PROTOCOL_TEST(!reader.next());
+}
+
+void test_lookahead()
+{
+    output_type expected = { bintoken::token::code::begin_array,
+                             0x01,
+                             0x02,
+                             0x03,
+                             bintoken::token::code::end_array };
+    TRIAL_PROTOCOL_TEST(to_bintoken("[1,2,3]", 2) == expected);
+}
+
+void test_object()
+{
+    output_type expected = { bintoken::token::code::begin_assoc_array,
+                             bintoken::token::code::string8, 0x01, 'A',
+                             0x01,
+                             bintoken::token::code::string8, 0x01, 'B',
+                             bintoken::token::code::begin_assoc_array,
+                             bintoken::token::code::end_assoc_array,
+                             bintoken::token::code::end_assoc_array };
+    TRIAL_PROTOCOL_TEST(to_bintoken("{\"A\":1,\"B\":{}}") == expected);
+}
+
+void test_sibling()
+{
+    // Only the current value is transcoded
+    std::string input = "[1,true] [2]";
+    output_type result;
+    json::reader reader(input);
+    bintoken::writer writer(result);
+    bintoken::transcode(reader, writer);
+    output_type expected = { bintoken::token::code::begin_array,
+                             0x01,
+                             bintoken::token::code::true_value,
+                             bintoken::token::code::end_array };
+    TRIAL_PROTOCOL_TEST(result == expected);
+}
+
+void fail_malformed()
+{
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(to_bintoken("[1,2"),
+                                    json::error,
+                                    "expected end array bracket");
+}
+
+void run()
+{
+    test_null();
+    test_boolean();
+    test_integer();
+    test_string();
+    test_empty_array();
+    test_integer_array();
+    test_real_array();
+    test_inexact_real_array();
+    test_mixed_array();
+    test_nested_array();
+    test_lookahead();
+    test_object();
+    test_sibling();
+    fail_malformed();
+}
+
+} // namespace json_suite
+
+//-----------------------------------------------------------------------------
+// Bintoken to JSON
+//-----------------------------------------------------------------------------
+
+namespace bintoken_suite
+{
+
+void test_scalar()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json({ bintoken::token::code::null }), "null");
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json({ bintoken::token::code::false_value }), "false");
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json({ bintoken::token::code::int16, 0xE8, 0x03 }), "1000");
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json({ bintoken::token::code::string8, 0x01, 'A' }), "\"A\"");
+}
+
+void test_record()
+{
+    output_type input = { bintoken::token::code::begin_record,
+                          0x01,
+                          bintoken::token::code::null,
+                          bintoken::token::code::end_record };
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(input), "[1,null]");
+}
+
+void test_int8_array()
+{
+    output_type input = { bintoken::token::code::array8_int8, 0x03, 0x01, 0xFF, 0x80 };
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(input), "[1,-1,-128]");
+}
+
+void test_float64_array()
+{
+    output_type result;
+    bintoken::writer writer(result);
+    std::vector<double> values = { 0.5, 1.5 };
+    writer.array(values.data(), values.size());
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(result), "[0.500000000000000,1.50000000000000]");
+}
+
+void test_varint_array()
+{
+    output_type result;
+    bintoken::writer writer(result);
+    writer.varint(true);
+    std::vector<std::int64_t> values = { 1, -300, 100000 };
+    writer.array(values.data(), values.size());
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(result), "[1,-300,100000]");
+}
+
+void test_bool_array()
+{
+    output_type input = { bintoken::token::code::array8_bool, 0x02, 0x05, 0x05 };
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(input), "[true,false,true]");
+}
+
+void test_float16_array()
+{
+    output_type input = { bintoken::token::code::array8_float16, 0x04, 0x00, 0x38, 0x00, 0xBE };
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(input), "[0.500000000000000,-1.50000000000000]");
+}
+
+void test_assoc_array()
+{
+    output_type input = { bintoken::token::code::begin_assoc_array,
+                          bintoken::token::code::string8, 0x01, 'A',
+                          bintoken::token::code::array8_int8, 0x02, 0x01, 0x02,
+                          bintoken::token::code::end_assoc_array };
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(input), "{\"A\":[1,2]}");
+}
+
+void fail_key()
+{
+    output_type input = { bintoken::token::code::begin_assoc_array,
+                          0x01,
+                          0x02,
+                          bintoken::token::code::end_assoc_array };
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(to_json(input),
+                                    bintoken::error,
+                                    "incompatible type");
+}
+
+void fail_unpaired()
+{
+    output_type input = { bintoken::token::code::begin_assoc_array,
+                          bintoken::token::code::string8, 0x01, 'A',
+                          bintoken::token::code::end_assoc_array };
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(to_json(input),
+                                    bintoken::error,
+                                    "invalid value");
+}
+
+void run()
+{
+    test_scalar();
+    test_record();
+    test_int8_array();
+    test_float64_array();
+    test_varint_array();
+    test_bool_array();
+    test_float16_array();
+    test_assoc_array();
+    fail_key();
+    fail_unpaired();
+}
+
+} // namespace bintoken_suite
+
+//-----------------------------------------------------------------------------
+// Round trip
+//-----------------------------------------------------------------------------
+
+namespace round_suite
+{
+
+void test_document()
+{
+    const std::string input = "{\"name\":\"alpha\",\"values\":[1,2,3],\"weights\":[0.500000000000000,0.250000000000000],\"tags\":[\"x\",null,true],\"nested\":{\"deep\":[[],[7]]}}";
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(to_bintoken(input)), input);
+}
+
+void test_lookahead()
+{
+    const std::string input = "[1,2,3,4,5]";
+    TRIAL_PROTOCOL_TEST_EQUAL(to_json(to_bintoken(input, 3)), input);
+}
+
+void run()
+{
+    test_document();
+    test_lookahead();
+}
+
+} // namespace round_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    json_suite::run();
+    bintoken_suite::run();
+    round_suite::run();
+
+    return boost::report_errors();
+}
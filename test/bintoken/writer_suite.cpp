@@ -8,11 +8,16 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <memory>
+#include <string>
 #include <trial/protocol/buffer/array.hpp>
 #include <trial/protocol/buffer/string.hpp>
 #include <trial/protocol/buffer/vector.hpp>
 #include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
 #include <trial/protocol/bintoken/error.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
 
@@ -469,6 +474,92 @@ void run()
 
 } // namespace compact_suite
 
+//-----------------------------------------------------------------------------
+// Alignment
+//-----------------------------------------------------------------------------
+
+namespace align_suite
+{
+
+void test_float64()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.align(token::float64::size);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    std::array<token::float64::type, 1> data = {{ 1.0 }};
+    // 1 + 5 padding + 2 header + 8 payload
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 15);
+
+    output_type expected[] = { token::code::true_value,
+                               token::code::padding, token::code::padding, token::code::padding,
+                               token::code::padding, token::code::padding,
+                               token::code::array8_float64, token::float64::size,
+                               0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_int32_aligned()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.align(token::int32::size);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(1), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(2), 1);
+    std::array<token::int32::type, 1> data = {{ 3 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 6);
+
+    output_type expected[] = { 0x01, 0x02,
+                               token::code::array8_int32, token::int32::size,
+                               0x03, 0x00, 0x00, 0x00 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_int16_array16()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.align(16);
+    std::vector<token::int16::type> data(128, 0x0102);
+    // 13 padding + 3 header + 256 payload
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 272);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 272);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[12], token::code::padding);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[13], token::code::array16_int16);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[16], 0x02);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[17], 0x01);
+}
+
+void test_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.align(token::float64::size);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    std::array<token::float64::type, 0> data = {};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2);
+
+    output_type expected[] = { token::code::true_value,
+                               token::code::array8_float64, 0x00 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void run()
+{
+    test_float64();
+    test_int32_aligned();
+    test_int16_array16();
+    test_empty();
+}
+
+} // namespace align_suite
+
 //-----------------------------------------------------------------------------
 // Record
 //-----------------------------------------------------------------------------
@@ -637,6 +728,1029 @@ void run()
 
 } // namespace assoc_array_suite
 
+//-----------------------------------------------------------------------------
+// Length prefix
+//-----------------------------------------------------------------------------
+
+namespace prefix_suite
+{
+
+void test_record()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(false), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+
+    output_type expected[] = { token::code::begin_record32, 0x02, 0x00, 0x00, 0x00,
+                               token::code::false_value,
+                               token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_assoc_array_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_assoc_array>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_assoc_array>(), 1);
+
+    output_type expected[] = { token::code::begin_assoc_array32, 0x01, 0x00, 0x00, 0x00,
+                               token::code::end_assoc_array };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_nested()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(1), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+
+    output_type expected[] = { token::code::begin_array32, 0x08, 0x00, 0x00, 0x00,
+                               token::code::begin_record32, 0x02, 0x00, 0x00, 0x00,
+                               0x01,
+                               token::code::end_record,
+                               token::code::end_array };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_mixed()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 5);
+    writer.length_prefix(false);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+
+    output_type expected[] = { token::code::begin_array,
+                               token::code::begin_record32, 0x03, 0x00, 0x00, 0x00,
+                               token::code::begin_array,
+                               token::code::end_array,
+                               token::code::end_record,
+                               token::code::end_array };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_sequence()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(2), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+
+    output_type expected[] = { token::code::begin_record32, 0x01, 0x00, 0x00, 0x00,
+                               token::code::end_record,
+                               0x02,
+                               token::code::begin_record32, 0x01, 0x00, 0x00, 0x00,
+                               token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void run()
+{
+    test_record();
+    test_assoc_array_empty();
+    test_nested();
+    test_mixed();
+    test_sequence();
+}
+
+} // namespace prefix_suite
+
+//-----------------------------------------------------------------------------
+// Reset
+//-----------------------------------------------------------------------------
+
+namespace reset_suite
+{
+
+void test_vector()
+{
+    std::vector<output_type> first;
+    std::vector<output_type> second;
+    format::writer writer(first);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    writer.reset(second);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(false), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(first.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(first[0], token::code::true_value);
+    TRIAL_PROTOCOL_TEST_EQUAL(second.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(second[0], token::code::false_value);
+}
+
+void test_different_buffer()
+{
+    std::vector<output_type> first;
+    std::array<output_type, 4> second;
+    format::writer writer(first);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    writer.reset(second);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(false), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(first.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(second[0], token::code::false_value);
+}
+
+void test_nested()
+{
+    std::vector<output_type> first;
+    std::vector<output_type> second;
+    format::writer writer(first);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    writer.reset(second);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.value<token::end_array>(),
+                                    format::error,
+                                    "unexpected token");
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(second.size(), 2);
+}
+
+void test_deep()
+{
+    // Nesting beyond the inline stack capacity
+    std::vector<output_type> result;
+    format::writer writer(result);
+    for (int i = 0; i < 40; ++i)
+    {
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    }
+    for (int i = 0; i < 40; ++i)
+    {
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 80);
+}
+
+void test_align()
+{
+    std::vector<output_type> first;
+    std::vector<output_type> second;
+    format::writer writer(first);
+    writer.align(token::int32::size);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    writer.reset(second);
+    std::array<token::int32::type, 1> data = {{ 1 }};
+    // Alignment is relative to the new output
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 8);
+    TRIAL_PROTOCOL_TEST_EQUAL(second[0], token::code::padding);
+    TRIAL_PROTOCOL_TEST_EQUAL(second[2], token::code::array8_int32);
+}
+
+void run()
+{
+    test_vector();
+    test_different_buffer();
+    test_nested();
+    test_deep();
+    test_align();
+}
+
+} // namespace reset_suite
+
+//-----------------------------------------------------------------------------
+// Variable-length integers
+//-----------------------------------------------------------------------------
+
+namespace varint_suite
+{
+
+void test_small()
+{
+    // Small integers are unaffected
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(1), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(std::int64_t(-100)), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[1], token::code::int8);
+}
+
+void test_int16()
+{
+    // Ties are encoded with the fixed size
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(std::int16_t(1000)), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::int16);
+}
+
+void test_int32()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(1000000), 4);
+
+    output_type expected[] = { token::code::varint, 0x80, 0x89, 0x7A };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_int64()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(std::int64_t(1) << 40), 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(std::numeric_limits<std::int64_t>::max()), 9);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::varint);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[7], token::code::int64);
+}
+
+void test_disabled()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    writer.varint(false);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(1000000), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::int32);
+}
+
+void test_array_int32()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    std::array<std::int32_t, 3> data = {{ 1, -1, 1000000 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 7);
+
+    output_type expected[] = { token::code::array8_varint, 0x05, 0x02, 0x01, 0x80, 0x89, 0x7A };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_array_int64_large()
+{
+    // Values larger than the fixed size are kept as fixed size
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    std::array<std::int64_t, 2> data = {{ std::numeric_limits<std::int64_t>::max(),
+                                          std::numeric_limits<std::int64_t>::min() }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2 + 16);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int64);
+}
+
+void test_array_uint16()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    std::vector<std::uint16_t> data(1000, 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 3 + 1000);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array16_varint);
+
+    format::reader reader(result);
+    std::vector<std::uint16_t> output(reader.length());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output.data(), output.size()), 1000);
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 data.begin(), data.end(),
+                                 std::equal_to<std::uint16_t>());
+}
+
+void test_array_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.varint(true);
+    std::array<std::int32_t, 0> data;
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int32);
+}
+
+void run()
+{
+    test_small();
+    test_int16();
+    test_int32();
+    test_int64();
+    test_disabled();
+    test_array_int32();
+    test_array_int64_large();
+    test_array_uint16();
+    test_array_empty();
+}
+
+} // namespace varint_suite
+
+//-----------------------------------------------------------------------------
+// Narrowing
+//-----------------------------------------------------------------------------
+
+namespace narrow_suite
+{
+
+void test_int64_to_int8()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    std::array<std::int64_t, 3> data = {{ 1, -1, 127 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2 + 3);
+
+    output_type expected[] = { token::code::array8_int8, 0x03, 0x01, 0xFF, 0x7F };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_int64_to_int16()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    std::array<std::int64_t, 2> data = {{ 1, -129 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2 + 4);
+
+    output_type expected[] = { token::code::array8_int16, 0x04, 0x01, 0x00, 0x7F, 0xFF };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_int64_to_int32()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    std::array<std::int64_t, 1> data = {{ std::numeric_limits<std::int32_t>::min() }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2 + 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int32);
+}
+
+void test_int64_unchanged()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    std::array<std::int64_t, 2> data = {{ 0, std::int64_t(1) << 32 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2 + 16);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int64);
+}
+
+void test_int16_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    std::array<std::int16_t, 0> data;
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int16);
+}
+
+void test_uint32_large()
+{
+    // Many elements with round-trip
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    std::vector<std::uint32_t> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<std::uint32_t>(i);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 3 + 2000);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array16_int16);
+
+    format::reader reader(result);
+    std::vector<std::uint32_t> output(reader.length());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output.data(), output.size()), 1000);
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 data.begin(), data.end(),
+                                 std::equal_to<std::uint32_t>());
+}
+
+void test_align()
+{
+    // Alignment applies to the narrowed element type
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    writer.align(token::int16::size);
+    std::array<std::int64_t, 1> data = {{ 1000 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int16);
+}
+
+void test_varint()
+{
+    // Variable-length integers are chosen if smaller than the narrowed array
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.narrow(true);
+    writer.varint(true);
+    std::array<std::int64_t, 3> data = {{ 1, 2, 100000 }};
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.data(), data.size()), 2 + 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_varint);
+}
+
+void run()
+{
+    test_int64_to_int8();
+    test_int64_to_int16();
+    test_int64_to_int32();
+    test_int64_unchanged();
+    test_int16_empty();
+    test_uint32_large();
+    test_align();
+    test_varint();
+}
+
+} // namespace narrow_suite
+
+//-----------------------------------------------------------------------------
+// Packing
+//-----------------------------------------------------------------------------
+
+namespace packing_suite
+{
+
+template <typename T>
+std::vector<T> round_trip(const std::vector<T>& data,
+                          format::packing::value policy,
+                          std::vector<output_type>& result)
+{
+    format::writer writer(result);
+    writer.packing(policy);
+    writer.array(data.data(), data.size());
+
+    format::reader reader(result);
+    std::vector<T> output(reader.length());
+    reader.array(output.data(), output.size());
+    return output;
+}
+
+void test_frame_of_reference()
+{
+    std::vector<std::int64_t> data(64);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = 1000 + (i * 7) % 64;
+    }
+    std::vector<output_type> result;
+    auto output = round_trip(data, format::packing::frame_of_reference, result);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_packed);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[2], 0x00); // Frame of reference
+    TRIAL_PROTOCOL_TEST_EQUAL(result[3], 6); // Width
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 2 + 18 + 48);
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 data.begin(), data.end(),
+                                 std::equal_to<std::int64_t>());
+}
+
+void test_delta()
+{
+    // Timestamps with irregular steps
+    std::vector<std::int64_t> data(1000);
+    std::int64_t now = 1500000000000;
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        now += 990 + (i * 13) % 20;
+        data[i] = now;
+    }
+    std::vector<output_type> result;
+    auto output = round_trip(data, format::packing::delta, result);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array16_packed);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[3], 0x01); // Delta
+    TRIAL_PROTOCOL_TEST_EQUAL(result[4], 5); // Width
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 3 + 26 + (999 * 5 + 7) / 8);
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 data.begin(), data.end(),
+                                 std::equal_to<std::int64_t>());
+}
+
+void test_automatic()
+{
+    std::vector<std::int32_t> data(100);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = -50000 + 3 * static_cast<std::int32_t>(i);
+    }
+    std::vector<output_type> result;
+    auto output = round_trip(data, format::packing::automatic, result);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_packed);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[2], 0x01); // Delta
+    TRIAL_PROTOCOL_TEST_EQUAL(result[3], 0); // Width
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                 data.begin(), data.end(),
+                                 std::equal_to<std::int32_t>());
+}
+
+void test_wide()
+{
+    // Every width with unsigned wrap-around
+    for (unsigned int width = 1; width <= 64; ++width)
+    {
+        std::vector<std::uint64_t> data(131);
+        const std::uint64_t mask = (width == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = (std::uint64_t(0x9E3779B97F4A7C15) * (i + 1)) & mask;
+        }
+        data[0] = 0;
+        data[1] = mask;
+        std::vector<output_type> result;
+        format::writer writer(result);
+        writer.packing(format::packing::frame_of_reference);
+        writer.array(data.data(), data.size());
+
+        format::reader reader(result);
+        std::vector<std::uint64_t> output(reader.length());
+        reader.array(output.data(), output.size());
+        TRIAL_PROTOCOL_TEST_ALL_WITH(output.begin(), output.end(),
+                                     data.begin(), data.end(),
+                                     std::equal_to<std::uint64_t>());
+    }
+}
+
+void test_unchanged()
+{
+    // Packing is not used if it is larger
+    std::vector<std::int16_t> data = { 1, 2, 3 };
+    std::vector<output_type> result;
+    auto output = round_trip(data, format::packing::automatic, result);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_int16);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.size(), 2 + 6);
+}
+
+void run()
+{
+    test_frame_of_reference();
+    test_delta();
+    test_automatic();
+    test_wide();
+    test_unchanged();
+}
+
+} // namespace packing_suite
+
+//-----------------------------------------------------------------------------
+// Dictionary
+//-----------------------------------------------------------------------------
+
+namespace dictionary_suite
+{
+
+void test_repeated()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.dictionary(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha"), 2 + 5 + 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("bravo"), 2 + 5 + 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha"), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(std::string("bravo")), 2);
+
+    output_type expected[] = { token::code::string_define, 0x05, 'a', 'l', 'p', 'h', 'a',
+                               token::code::string_reference8, 0x00,
+                               token::code::string_define, 0x05, 'b', 'r', 'a', 'v', 'o',
+                               token::code::string_reference8, 0x01,
+                               token::code::string_reference8, 0x00,
+                               token::code::string_reference8, 0x01 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.dictionary(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(""), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::string8);
+}
+
+void test_long()
+{
+    // Strings with a wide length are not interned
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.dictionary(true);
+    const std::string data(300, 'x');
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(data), 3 + 300);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::string16);
+}
+
+void test_reference16()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.dictionary(true);
+    for (int i = 0; i < 300; ++i)
+    {
+        writer.value(std::to_string(i));
+    }
+    const auto size = result.size();
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(std::to_string(299)), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[size], token::code::string_reference16);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[size + 1], 0x2B);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[size + 2], 0x01);
+}
+
+void test_reset()
+{
+    std::vector<output_type> first;
+    std::vector<output_type> second;
+    format::writer writer(first);
+    writer.dictionary(true);
+    writer.value("alpha");
+    writer.reset(second);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha"), 2 + 5 + 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(second[0], token::code::string_define);
+}
+
+void test_length_prefix()
+{
+    // Definitions are placed before the length-prefixed container
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.dictionary(true);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_assoc_array>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("key"), 2 + 3 + 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_assoc_array>(), 1);
+
+    output_type expected[] = { token::code::string_define, 0x03, 'k', 'e', 'y',
+                               token::code::begin_assoc_array32, 0x04, 0x00, 0x00, 0x00,
+                               token::code::string_reference8, 0x00,
+                               token::code::true_value,
+                               token::code::end_assoc_array };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void run()
+{
+    test_repeated();
+    test_empty();
+    test_long();
+    test_reference16();
+    test_reset();
+    test_length_prefix();
+}
+
+} // namespace dictionary_suite
+
+//-----------------------------------------------------------------------------
+// Tagged fields
+//-----------------------------------------------------------------------------
+
+namespace field_suite
+{
+
+void test_field()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.field(1), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.field(200), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(2), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+
+    output_type expected[] = { token::code::begin_record,
+                               token::code::field, 0x02,
+                               token::code::true_value,
+                               token::code::field, 0x90, 0x03,
+                               0x02,
+                               token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_field_prefix()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.length_prefix(true);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_record>(), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.field(3), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(1), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_record>(), 1);
+
+    output_type expected[] = { token::code::begin_record32, 0x04, 0x00, 0x00, 0x00,
+                               token::code::field, 0x06,
+                               0x01,
+                               token::code::end_record };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void fail_outside_record()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.field(1),
+                                    format::error,
+                                    "unexpected token");
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.field(1),
+                                    format::error,
+                                    "unexpected token");
+}
+
+void run()
+{
+    test_field();
+    test_field_prefix();
+    fail_outside_record();
+}
+
+} // namespace field_suite
+
+//-----------------------------------------------------------------------------
+// Tensor
+//-----------------------------------------------------------------------------
+
+namespace tensor_suite
+{
+
+void test_matrix()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    const std::int16_t data[] = { 1, 2, 3, 4, 5, 6 };
+    const format::writer::size_type extents[] = { 2, 3 };
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.tensor(data, extents, 2), 24);
+
+    output_type expected[] = { token::code::tensor, 0x02,
+                               0x02, 0x00, 0x00, 0x00,
+                               0x03, 0x00, 0x00, 0x00,
+                               token::code::array8_int16, 0x0C,
+                               0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+                               0x04, 0x00, 0x05, 0x00, 0x06, 0x00 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    const float *data = nullptr;
+    const format::writer::size_type extents[] = { 0 };
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.tensor(data, extents, 1), 8);
+
+    output_type expected[] = { token::code::tensor, 0x01,
+                               0x00, 0x00, 0x00, 0x00,
+                               token::code::array8_float32, 0x00 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void fail_rank()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    const std::int8_t data[] = { 1 };
+    const format::writer::size_type extents[] = { 1 };
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.tensor(data, extents, 0),
+                                    format::error,
+                                    "invalid value");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.tensor(data, extents, 256),
+                                    format::error,
+                                    "invalid value");
+    TRIAL_PROTOCOL_TEST(result.empty());
+}
+
+void run()
+{
+    test_matrix();
+    test_empty();
+    fail_rank();
+}
+
+} // namespace tensor_suite
+
+//-----------------------------------------------------------------------------
+// Boolean arrays
+//-----------------------------------------------------------------------------
+
+namespace bool_array_suite
+{
+
+void test_empty()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    const bool *data = nullptr;
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data, 0), 3);
+
+    output_type expected[] = { token::code::array8_bool, 0x01, 0x00 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_partial()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    const bool data[] = { true, true, false, true, false, false, false, false,
+                          false, true, true };
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data, 11), 5);
+
+    output_type expected[] = { token::code::array8_bool, 0x03,
+                               0x05, 0x0B, 0x06 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void test_large()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    std::unique_ptr<bool[]> data(new bool[2048]);
+    for (std::size_t i = 0; i < 2048; ++i)
+    {
+        data[i] = (i % 3 == 0);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data.get(), 2048), 3 + 1 + 256);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array16_bool);
+
+    format::reader reader(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), 2048);
+    std::unique_ptr<bool[]> output(new bool[2048]);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(output.get(), 2048), 2048);
+    TRIAL_PROTOCOL_TEST_ALL_WITH(output.get(), output.get() + 2048,
+                                 data.get(), data.get() + 2048,
+                                 std::equal_to<bool>());
+}
+
+void run()
+{
+    test_empty();
+    test_partial();
+    test_large();
+}
+
+} // namespace bool_array_suite
+
+//-----------------------------------------------------------------------------
+// Precision
+//-----------------------------------------------------------------------------
+
+namespace precision_suite
+{
+
+std::uint16_t encode(format::precision::value policy, float value)
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.precision(policy);
+    writer.array(&value, 1);
+    return std::uint16_t(result[2] | (result[3] << 8));
+}
+
+void test_full()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    const float data[] = { 1.0f };
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data, 1), 2 + token::float32::size);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], token::code::array8_float32);
+}
+
+void test_float16()
+{
+    const auto policy = format::precision::float16;
+    const float infinity = std::numeric_limits<float>::infinity();
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 0.0f), 0x0000);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, -0.0f), 0x8000);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 1.0f), 0x3C00);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, -2.0f), 0xC000);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 65504.0f), 0x7BFF);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 65520.0f), 0x7C00);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, infinity), 0x7C00);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, -infinity), 0xFC00);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, std::numeric_limits<float>::quiet_NaN()), 0x7E00);
+    // Subnormals
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, std::ldexp(1.0f, -24)), 0x0001);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, std::ldexp(1.0f, -15)), 0x0200);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, std::ldexp(1.0f, -26)), 0x0000);
+    // Round to nearest even
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 1.0f + std::ldexp(1.0f, -11)), 0x3C00);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 1.0f + 3 * std::ldexp(1.0f, -11)), 0x3C02);
+}
+
+void test_bfloat16()
+{
+    const auto policy = format::precision::bfloat16;
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 1.0f), 0x3F80);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, -2.0f), 0xC000);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, std::numeric_limits<float>::infinity()), 0x7F80);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, std::numeric_limits<float>::max()), 0x7F80);
+    // Round to nearest even
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 1.0f + std::ldexp(1.0f, -8)), 0x3F80);
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, 1.0f + 3 * std::ldexp(1.0f, -8)), 0x3F82);
+    // NaN with a payload only in the truncated bits
+    std::uint32_t bits = 0x7F800001;
+    float nan;
+    std::memcpy(&nan, &bits, sizeof(nan));
+    TRIAL_PROTOCOL_TEST_EQUAL(encode(policy, nan) & 0x7FC0, 0x7FC0);
+}
+
+void test_float16_all()
+{
+    // Every float16 value except NaN survives decoding and encoding
+    std::vector<output_type> input = { token::code::array32_float16,
+                                       0x00, 0x00, 0x00, 0x00 };
+    std::uint32_t count = 0;
+    for (std::uint32_t value = 0; value < 0x10000; ++value)
+    {
+        if ((value & 0x7C00) == 0x7C00 && (value & 0x03FF) != 0)
+            continue;
+        input.push_back(output_type(value & 0xFF));
+        input.push_back(output_type(value >> 8));
+        ++count;
+    }
+    const std::uint32_t size = 2 * count;
+    input[1] = output_type(size);
+    input[2] = output_type(size >> 8);
+    input[3] = output_type(size >> 16);
+
+    format::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.length(), count);
+    std::vector<float> data(count);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.array(data.data(), data.size()), count);
+
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.precision(format::precision::float16);
+    writer.array(data.data(), data.size());
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 input.begin(), input.end(),
+                                 std::equal_to<output_type>());
+}
+
+void test_double()
+{
+    std::vector<output_type> result;
+    format::writer writer(result);
+    writer.precision(format::precision::float16);
+    const double data[] = { 0.5, 1.5, -3.0 };
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.array(data, 3), 2 + 6);
+
+    output_type expected[] = { token::code::array8_float16, 0x06,
+                               0x00, 0x38, 0x00, 0x3E, 0x00, 0xC2 };
+    TRIAL_PROTOCOL_TEST_ALL_WITH(result.begin(), result.end(),
+                                 expected, expected + sizeof(expected),
+                                 std::equal_to<output_type>());
+}
+
+void run()
+{
+    test_full();
+    test_float16();
+    test_bfloat16();
+    test_float16_all();
+    test_double();
+}
+
+} // namespace precision_suite
+
 //-----------------------------------------------------------------------------
 // main
 //-----------------------------------------------------------------------------
@@ -647,9 +1761,20 @@ int main()
     number_suite::run();
     string_suite::run();
     compact_suite::run();
+    align_suite::run();
     record_suite::run();
     array_suite::run();
     assoc_array_suite::run();
+    prefix_suite::run();
+    reset_suite::run();
+    varint_suite::run();
+    narrow_suite::run();
+    packing_suite::run();
+    dictionary_suite::run();
+    field_suite::run();
+    tensor_suite::run();
+    bool_array_suite::run();
+    precision_suite::run();
 
     return boost::report_errors();
 }
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <trial/protocol/buffer/async_descriptor.hpp>
+#include <trial/protocol/json/writer.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+//-----------------------------------------------------------------------------
+// Helper
+//-----------------------------------------------------------------------------
+
+class temporary_file
+{
+public:
+    temporary_file()
+        : file(std::tmpfile())
+    {
+    }
+
+    ~temporary_file()
+    {
+        std::fclose(file);
+    }
+
+    int fd() const
+    {
+        return ::fileno(file);
+    }
+
+    std::string str() const
+    {
+        std::string result;
+        char buffer[256];
+        ::lseek(fd(), 0, SEEK_SET);
+        ssize_t size;
+        while ((size = ::read(fd(), buffer, sizeof(buffer))) > 0)
+        {
+            result.append(buffer, size);
+        }
+        return result;
+    }
+
+private:
+    std::FILE *file;
+};
+
+//-----------------------------------------------------------------------------
+// Asynchronous file descriptor
+//-----------------------------------------------------------------------------
+
+namespace async_suite
+{
+
+void test_empty()
+{
+    temporary_file file;
+    {
+        buffer::async_descriptor sink(file.fd());
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.good(), true);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "");
+}
+
+void test_single()
+{
+    temporary_file file;
+    buffer::async_descriptor sink(file.fd());
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(1), true);
+    TRIAL_PROTOCOL_TEST_NO_THROW(sink.write('A'));
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "A");
+    const auto statistics = sink.statistics();
+    TRIAL_PROTOCOL_TEST_EQUAL(statistics.written, 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(statistics.dropped, 0);
+    TRIAL_PROTOCOL_TEST(statistics.batches >= 1);
+    TRIAL_PROTOCOL_TEST(statistics.max_latency <= statistics.total_latency);
+}
+
+void test_close()
+{
+    temporary_file file;
+    buffer::async_descriptor sink(file.fd());
+    sink.write(std::string("alpha"));
+    sink.close();
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "alpha");
+    sink.write(std::string("bravo"));
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "alpha");
+}
+
+void test_block()
+{
+    temporary_file file;
+    std::string expected;
+    {
+        buffer::async_descriptor sink(file.fd(), 64, buffer::backpressure::block);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::string input = "alpha" + std::to_string(i);
+            sink.write(input);
+            expected += input;
+        }
+        const std::string input(200, 'x');
+        sink.write(input);
+        expected += input;
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.statistics().written, expected.size());
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), expected);
+}
+
+void test_drop()
+{
+    temporary_file file;
+    buffer::async_descriptor sink(file.fd(), 64, buffer::backpressure::drop);
+    sink.write(std::string(100, 'x'));
+    sink.write(std::string("alpha"));
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "alpha");
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.statistics().dropped, 100);
+}
+
+void test_grow()
+{
+    temporary_file file;
+    std::string expected;
+    {
+        buffer::async_descriptor sink(file.fd(), 64, buffer::backpressure::grow);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::string input = "alpha" + std::to_string(i);
+            sink.write(input);
+            expected += input;
+            if (i % 100 == 0)
+            {
+                const std::string large(100, 'x');
+                sink.write(large);
+                expected += large;
+            }
+        }
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.statistics().dropped, 0);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), expected);
+}
+
+void test_bad_descriptor()
+{
+    buffer::async_descriptor sink(-1);
+    sink.write('A');
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(1), false);
+    TRIAL_PROTOCOL_TEST(sink.error() == std::errc::bad_file_descriptor);
+}
+
+void test()
+{
+    test_empty();
+    test_single();
+    test_close();
+    test_block();
+    test_drop();
+    test_grow();
+    test_bad_descriptor();
+}
+
+} // namespace async_suite
+
+//-----------------------------------------------------------------------------
+// json::writer
+//-----------------------------------------------------------------------------
+
+namespace writer_suite
+{
+
+void test_array()
+{
+    temporary_file file;
+    {
+        buffer::async_descriptor sink(file.fd());
+        json::writer writer(sink);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::begin_array>(), 1);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha bravo"), 13);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::end_array>(), 1);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "[true,\"alpha bravo\"]");
+}
+
+void test()
+{
+    test_array();
+}
+
+} // namespace writer_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    async_suite::test();
+    writer_suite::test();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <trial/protocol/buffer/buffered_ostream.hpp>
+#include <trial/protocol/json/writer.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+//-----------------------------------------------------------------------------
+// std::ostringstream
+//-----------------------------------------------------------------------------
+
+namespace ostringstream_suite
+{
+
+void test_empty()
+{
+    std::ostringstream output;
+    {
+        buffer::buffered_ostream sink(output);
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.good(), true);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "");
+}
+
+void test_single()
+{
+    std::ostringstream output;
+    buffer::buffered_ostream sink(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(1), true);
+    TRIAL_PROTOCOL_TEST_NO_THROW(sink.write('A'));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "");
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "A");
+}
+
+void test_view()
+{
+    std::ostringstream output;
+    {
+        buffer::buffered_ostream sink(output);
+        std::string input = "alpha";
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(input.size()), true);
+        TRIAL_PROTOCOL_TEST_NO_THROW(sink.write(input));
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "alpha");
+}
+
+void test_full_block()
+{
+    std::ostringstream output;
+    buffer::buffered_ostream sink(output, 4);
+    sink.write('A');
+    sink.write('B');
+    sink.write('C');
+    sink.write('D');
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "");
+    sink.write('E');
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "ABCD");
+    sink.flush();
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "ABCDE");
+}
+
+void test_large_view()
+{
+    std::ostringstream output;
+    buffer::buffered_ostream sink(output, 4);
+    sink.write('A');
+    std::string input = "alpha";
+    sink.write(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "Aalpha");
+    sink.write(std::string("bc"));
+    sink.write(std::string("de"));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "Aalpha");
+    sink.write(std::string("f"));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "Aalphabcde");
+    sink.flush();
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "Aalphabcdef");
+}
+
+void test_bad_stream()
+{
+    std::ostringstream output;
+    output.setstate(std::ios_base::badbit);
+    buffer::buffered_ostream sink(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(1), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.good(), false);
+}
+
+void test()
+{
+    test_empty();
+    test_single();
+    test_view();
+    test_full_block();
+    test_large_view();
+    test_bad_stream();
+}
+
+} // namespace ostringstream_suite
+
+//-----------------------------------------------------------------------------
+// json::writer
+//-----------------------------------------------------------------------------
+
+namespace writer_suite
+{
+
+void test_array()
+{
+    std::ostringstream output;
+    {
+        buffer::buffered_ostream sink(output, 8);
+        json::writer writer(sink);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::begin_array>(), 1);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha bravo"), 13);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::end_array>(), 1);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "[true,\"alpha bravo\"]");
+}
+
+void test()
+{
+    test_array();
+}
+
+} // namespace writer_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    ostringstream_suite::test();
+    writer_suite::test();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,378 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <trial/protocol/buffer/vector.hpp>
+#include <trial/protocol/buffer/compressor.hpp>
+#include <trial/protocol/buffer/decompressor.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/bintoken/reader.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+namespace
+{
+
+std::vector<std::uint8_t> roundtrip(const std::vector<std::uint8_t>& input)
+{
+    namespace lz = buffer::detail::lz;
+    std::vector<std::uint8_t> compressed(lz::bound(input.size()));
+    compressed.resize(lz::compress(input.data(), input.size(), compressed.data()));
+    std::vector<std::uint8_t> result(input.size());
+    if (!lz::decompress(compressed.data(), compressed.size(), result.data(), result.size()))
+        result.clear();
+    return result;
+}
+
+std::vector<std::uint8_t> make_text(std::size_t size)
+{
+    const std::string words[] = { "alpha ", "bravo ", "charlie ", "delta ", "echo " };
+    std::vector<std::uint8_t> result;
+    for (std::size_t i = 0; result.size() < size; ++i)
+    {
+        const std::string& word = words[(i * 7 + i / 3) % 5];
+        result.insert(result.end(), word.begin(), word.end());
+    }
+    result.resize(size);
+    return result;
+}
+
+std::vector<std::uint8_t> make_noise(std::size_t size)
+{
+    std::vector<std::uint8_t> result(size);
+    std::uint32_t state = 0x12345678;
+    for (auto& value : result)
+    {
+        state = state * 1103515245 + 12345;
+        value = static_cast<std::uint8_t>(state >> 24);
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Codec
+//-----------------------------------------------------------------------------
+
+namespace codec_suite
+{
+
+void test_empty()
+{
+    std::vector<std::uint8_t> input;
+    TRIAL_PROTOCOL_TEST(roundtrip(input) == input);
+}
+
+void test_short()
+{
+    std::vector<std::uint8_t> input = { 'A', 'B', 'C', 'A', 'B', 'C', 'A', 'B', 'C' };
+    TRIAL_PROTOCOL_TEST(roundtrip(input) == input);
+}
+
+void test_run()
+{
+    // Overlapping match with offset 1
+    std::vector<std::uint8_t> input(1000, 'A');
+    std::vector<std::uint8_t> compressed(buffer::detail::lz::bound(input.size()));
+    const std::size_t size = buffer::detail::lz::compress(input.data(), input.size(), compressed.data());
+    TRIAL_PROTOCOL_TEST(size < 20);
+    TRIAL_PROTOCOL_TEST(roundtrip(input) == input);
+}
+
+void test_text()
+{
+    auto input = make_text(100000);
+    std::vector<std::uint8_t> compressed(buffer::detail::lz::bound(input.size()));
+    const std::size_t size = buffer::detail::lz::compress(input.data(), input.size(), compressed.data());
+    TRIAL_PROTOCOL_TEST(size < input.size() / 4);
+    TRIAL_PROTOCOL_TEST(roundtrip(input) == input);
+}
+
+void test_noise()
+{
+    auto input = make_noise(10000);
+    std::vector<std::uint8_t> compressed(buffer::detail::lz::bound(input.size()));
+    const std::size_t size = buffer::detail::lz::compress(input.data(), input.size(), compressed.data());
+    TRIAL_PROTOCOL_TEST(size <= buffer::detail::lz::bound(input.size()));
+    TRIAL_PROTOCOL_TEST(roundtrip(input) == input);
+}
+
+void test_all_lengths()
+{
+    auto input = make_text(300);
+    for (std::size_t size = 0; size < input.size(); ++size)
+    {
+        std::vector<std::uint8_t> part(input.begin(), input.begin() + size);
+        TRIAL_PROTOCOL_TEST(roundtrip(part) == part);
+    }
+}
+
+void fail_truncated()
+{
+    auto input = make_text(1000);
+    std::vector<std::uint8_t> compressed(buffer::detail::lz::bound(input.size()));
+    compressed.resize(buffer::detail::lz::compress(input.data(), input.size(), compressed.data()));
+    std::vector<std::uint8_t> output(input.size());
+    for (std::size_t size = 0; size < compressed.size(); ++size)
+    {
+        TRIAL_PROTOCOL_TEST(!buffer::detail::lz::decompress(compressed.data(), size, output.data(), output.size()));
+    }
+}
+
+void fail_offset()
+{
+    // Literal 'A' followed by a match 2 bytes back
+    const std::uint8_t input[] = { 0x10, 'A', 0x02, 0x00, 0x00 };
+    std::uint8_t output[8];
+    TRIAL_PROTOCOL_TEST(!buffer::detail::lz::decompress(input, sizeof(input), output, 5));
+}
+
+void fail_overrun()
+{
+    const std::uint8_t input[] = { 0x10, 'A', 0x01, 0x00, 0x00 };
+    std::uint8_t output[8];
+    TRIAL_PROTOCOL_TEST(buffer::detail::lz::decompress(input, sizeof(input), output, 5));
+    TRIAL_PROTOCOL_TEST(!buffer::detail::lz::decompress(input, sizeof(input), output, 4));
+}
+
+void run()
+{
+    test_empty();
+    test_short();
+    test_run();
+    test_text();
+    test_noise();
+    test_all_lengths();
+    fail_truncated();
+    fail_offset();
+    fail_overrun();
+}
+
+} // namespace codec_suite
+
+//-----------------------------------------------------------------------------
+// Frame
+//-----------------------------------------------------------------------------
+
+namespace frame_suite
+{
+
+void test_empty()
+{
+    std::vector<char> output;
+    {
+        buffer::compressor<std::vector<char>> sink(output);
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.good(), true);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), 4);
+
+    buffer::decompressor input(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.good(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.size(), 0);
+    std::vector<char> result;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(result), true);
+    TRIAL_PROTOCOL_TEST(result.empty());
+}
+
+void test_view()
+{
+    std::vector<char> output;
+    {
+        buffer::compressor<std::vector<char>> sink(output);
+        sink.write(std::string("alpha"));
+        sink.write(' ');
+        sink.write(std::string("bravo"));
+    }
+    buffer::decompressor input(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.good(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.raw_size(), 11);
+    std::vector<char> result;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(result), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(std::string(result.begin(), result.end()), "alpha bravo");
+}
+
+void test_blocks()
+{
+    auto text = make_text(10000);
+    std::vector<std::uint8_t> output;
+    {
+        buffer::compressor<std::vector<std::uint8_t>> sink(output, 1024);
+        sink.write(buffer::compressor<std::vector<std::uint8_t>>::view_type(text.data(), text.size()));
+    }
+    TRIAL_PROTOCOL_TEST(output.size() < text.size() / 2);
+
+    buffer::basic_decompressor<std::uint8_t> input(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.good(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.size(), 10);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.offset(3), 3072);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.find(0), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.find(3071), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.find(3072), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.find(9999), 9);
+
+    std::vector<std::uint8_t> result;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(result), true);
+    TRIAL_PROTOCOL_TEST(result == text);
+
+    // Seek to a block boundary
+    result.clear();
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(result, 3, 5), true);
+    TRIAL_PROTOCOL_TEST(result == std::vector<std::uint8_t>(text.begin() + 3072, text.begin() + 5120));
+}
+
+void test_stored()
+{
+    auto noise = make_noise(5000);
+    std::vector<std::uint8_t> output;
+    {
+        buffer::compressor<std::vector<std::uint8_t>> sink(output);
+        sink.write(buffer::compressor<std::vector<std::uint8_t>>::view_type(noise.data(), noise.size()));
+    }
+    // Magic and block header
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), 4 + 8 + noise.size());
+
+    buffer::basic_decompressor<std::uint8_t> input(output);
+    std::vector<std::uint8_t> result;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(result), true);
+    TRIAL_PROTOCOL_TEST(result == noise);
+}
+
+void fail_magic()
+{
+    std::vector<char> output = { 'T', 'P', 'L', 'X' };
+    buffer::decompressor input(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.good(), false);
+    std::vector<char> result;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(result), false);
+}
+
+void fail_truncated()
+{
+    std::vector<char> output;
+    {
+        buffer::compressor<std::vector<char>> sink(output);
+        sink.write(std::string("alpha bravo alpha bravo"));
+    }
+    for (std::size_t size = 5; size < output.size(); ++size)
+    {
+        buffer::decompressor input(std::vector<char>(output.begin(), output.begin() + size));
+        TRIAL_PROTOCOL_TEST_EQUAL(input.good(), false);
+    }
+}
+
+void run()
+{
+    test_empty();
+    test_view();
+    test_blocks();
+    test_stored();
+    fail_magic();
+    fail_truncated();
+}
+
+} // namespace frame_suite
+
+//-----------------------------------------------------------------------------
+// bintoken
+//-----------------------------------------------------------------------------
+
+namespace bintoken_suite
+{
+
+void test_records()
+{
+    std::vector<std::uint8_t> output;
+    std::vector<std::size_t> boundaries;
+    {
+        buffer::compressor<std::vector<std::uint8_t>> sink(output, 256);
+        bintoken::writer writer(sink);
+        for (int i = 0; i < 100; ++i)
+        {
+            writer.value<bintoken::token::begin_array>();
+            writer.value(i);
+            writer.value("alpha bravo charlie");
+            writer.value<bintoken::token::end_array>();
+            if (i % 10 == 9)
+            {
+                // End the block at a record boundary
+                sink.flush();
+            }
+        }
+    }
+
+    buffer::basic_decompressor<std::uint8_t> input(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.good(), true);
+    TRIAL_PROTOCOL_TEST(input.size() >= 10);
+
+    std::vector<std::uint8_t> data;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(data), true);
+    bintoken::reader reader(data);
+    int count = 0;
+    while (reader.symbol() == bintoken::token::symbol::begin_array)
+    {
+        TRIAL_PROTOCOL_TEST(reader.next());
+        TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), count);
+        ++count;
+        reader.next();
+        reader.next();
+        reader.next();
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(count, 100);
+}
+
+void test_seek()
+{
+    std::vector<std::uint8_t> output;
+    {
+        buffer::compressor<std::vector<std::uint8_t>> sink(output);
+        bintoken::writer writer(sink);
+        for (int i = 0; i < 4; ++i)
+        {
+            writer.value(i * 1000);
+            sink.flush();
+        }
+    }
+
+    buffer::basic_decompressor<std::uint8_t> input(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(input.size(), 4);
+    std::vector<std::uint8_t> data;
+    TRIAL_PROTOCOL_TEST_EQUAL(input.read(data, 2), true);
+    bintoken::reader reader(data);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 2000);
+    TRIAL_PROTOCOL_TEST(reader.next());
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 3000);
+    TRIAL_PROTOCOL_TEST(!reader.next());
+}
+
+void run()
+{
+    test_records();
+    test_seek();
+}
+
+} // namespace bintoken_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    codec_suite::run();
+    frame_suite::run();
+    bintoken_suite::run();
+
+    return boost::report_errors();
+}
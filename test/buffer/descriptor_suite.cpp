@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <trial/protocol/buffer/descriptor.hpp>
+#include <trial/protocol/json/writer.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+//-----------------------------------------------------------------------------
+// Helper
+//-----------------------------------------------------------------------------
+
+class temporary_file
+{
+public:
+    temporary_file()
+        : file(std::tmpfile())
+    {
+    }
+
+    ~temporary_file()
+    {
+        std::fclose(file);
+    }
+
+    int fd() const
+    {
+        return ::fileno(file);
+    }
+
+    std::string str() const
+    {
+        std::string result;
+        char buffer[256];
+        ::lseek(fd(), 0, SEEK_SET);
+        ssize_t size;
+        while ((size = ::read(fd(), buffer, sizeof(buffer))) > 0)
+        {
+            result.append(buffer, size);
+        }
+        return result;
+    }
+
+private:
+    std::FILE *file;
+};
+
+//-----------------------------------------------------------------------------
+// File descriptor
+//-----------------------------------------------------------------------------
+
+namespace descriptor_suite
+{
+
+void test_empty()
+{
+    temporary_file file;
+    {
+        buffer::descriptor sink(file.fd());
+        TRIAL_PROTOCOL_TEST_EQUAL(sink.good(), true);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "");
+}
+
+void test_single()
+{
+    temporary_file file;
+    buffer::descriptor sink(file.fd());
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(1), true);
+    TRIAL_PROTOCOL_TEST_NO_THROW(sink.write('A'));
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "");
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "A");
+}
+
+void test_full_block()
+{
+    temporary_file file;
+    buffer::descriptor sink(file.fd(), 4);
+    sink.write('A');
+    sink.write('B');
+    sink.write('C');
+    sink.write('D');
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "");
+    sink.write('E');
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "ABCD");
+    sink.flush();
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "ABCDE");
+}
+
+void test_large_view()
+{
+    temporary_file file;
+    buffer::descriptor sink(file.fd(), 4);
+    sink.write('A');
+    sink.write(std::string("alpha"));
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "Aalpha");
+    sink.write(std::string("bc"));
+    sink.write(std::string("de"));
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "Aalpha");
+    sink.write(std::string("f"));
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "Aalphabcde");
+    sink.flush();
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "Aalphabcdef");
+}
+
+void test_bad_descriptor()
+{
+    buffer::descriptor sink(-1);
+    sink.write('A');
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.flush(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(sink.grow(1), false);
+    TRIAL_PROTOCOL_TEST(sink.error() == std::errc::bad_file_descriptor);
+}
+
+void test()
+{
+    test_empty();
+    test_single();
+    test_full_block();
+    test_large_view();
+    test_bad_descriptor();
+}
+
+} // namespace descriptor_suite
+
+//-----------------------------------------------------------------------------
+// json::writer
+//-----------------------------------------------------------------------------
+
+namespace writer_suite
+{
+
+void test_array()
+{
+    temporary_file file;
+    {
+        buffer::descriptor sink(file.fd(), 8);
+        json::writer writer(sink);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::begin_array>(), 1);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha bravo"), 13);
+        TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::end_array>(), 1);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(file.str(), "[true,\"alpha bravo\"]");
+}
+
+void test()
+{
+    test_array();
+}
+
+} // namespace writer_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    descriptor_suite::test();
+    writer_suite::test();
+
+    return boost::report_errors();
+}
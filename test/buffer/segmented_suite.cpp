@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <string>
+#include <trial/protocol/buffer/segmented.hpp>
+#include <trial/protocol/json/writer.hpp>
+#include <trial/protocol/bintoken/writer.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+//-----------------------------------------------------------------------------
+// Segmented
+//-----------------------------------------------------------------------------
+
+namespace segmented_suite
+{
+
+void test_empty()
+{
+    buffer::segmented output;
+    TRIAL_PROTOCOL_TEST_EQUAL(output.empty(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment_count(), 0);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "");
+}
+
+void test_single()
+{
+    buffer::segmented output;
+    TRIAL_PROTOCOL_TEST_EQUAL(output.grow(1), true);
+    TRIAL_PROTOCOL_TEST_NO_THROW(output.write('A'));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment_count(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "A");
+}
+
+void test_segments()
+{
+    buffer::segmented output(4);
+    output.write('A');
+    output.write(std::string("alpha"));
+    output.write(std::string("bravo"));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), 11);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment_count(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment(0), "Aalp");
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment(1), "habr");
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment(2), "avo");
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "Aalphabravo");
+}
+
+void test_iovec()
+{
+    buffer::segmented output(4);
+    output.write(std::string("alphabravo"));
+    std::vector<struct ::iovec> vec = output.iovec();
+    TRIAL_PROTOCOL_TEST_EQUAL(vec.size(), 3);
+    TRIAL_PROTOCOL_TEST_EQUAL(vec[0].iov_len, 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(vec[1].iov_len, 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(vec[2].iov_len, 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(std::string(static_cast<char *>(vec[1].iov_base), vec[1].iov_len), "abra");
+
+    struct ::iovec partial[2];
+    TRIAL_PROTOCOL_TEST_EQUAL(output.iovec(partial, 2, 2), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(std::string(static_cast<char *>(partial[0].iov_base), partial[0].iov_len), "vo");
+}
+
+void test_reset()
+{
+    buffer::segmented output(4);
+    output.write(std::string("alphabravo"));
+    output.reset();
+    TRIAL_PROTOCOL_TEST_EQUAL(output.empty(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment_count(), 0);
+    output.write(std::string("charlie"));
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "charlie");
+}
+
+void test_shared_pool()
+{
+    buffer::segment_pool pool(4);
+    {
+        buffer::segmented output(pool);
+        output.write(std::string("alphabravo"));
+        TRIAL_PROTOCOL_TEST_EQUAL(pool.available(), 0);
+        output.reset();
+        TRIAL_PROTOCOL_TEST_EQUAL(pool.available(), 3);
+        output.write(std::string("alpha"));
+        TRIAL_PROTOCOL_TEST_EQUAL(pool.available(), 1);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(pool.available(), 3);
+}
+
+void test()
+{
+    test_empty();
+    test_single();
+    test_segments();
+    test_iovec();
+    test_reset();
+    test_shared_pool();
+}
+
+} // namespace segmented_suite
+
+//-----------------------------------------------------------------------------
+// json::writer
+//-----------------------------------------------------------------------------
+
+namespace json_suite
+{
+
+void test_array()
+{
+    buffer::segmented output(4);
+    json::writer writer(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha bravo"), 13);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<json::token::end_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.str(), "[true,\"alpha bravo\"]");
+}
+
+void test()
+{
+    test_array();
+}
+
+} // namespace json_suite
+
+//-----------------------------------------------------------------------------
+// bintoken::writer
+//-----------------------------------------------------------------------------
+
+namespace bintoken_suite
+{
+
+void test_array()
+{
+    buffer::basic_segmented<std::uint8_t> output(2);
+    bintoken::writer writer(output);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<bintoken::token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("alpha"), 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<bintoken::token::end_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.size(), 10);
+    TRIAL_PROTOCOL_TEST_EQUAL(output.segment_count(), 5);
+    const auto result = output.str();
+    TRIAL_PROTOCOL_TEST_EQUAL(result[0], bintoken::token::code::begin_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[1], bintoken::token::code::true_value);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[2], bintoken::token::code::string8);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[3], 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(result[4], 'a');
+    TRIAL_PROTOCOL_TEST_EQUAL(result[9], bintoken::token::code::end_array);
+}
+
+void test()
+{
+    test_array();
+}
+
+} // namespace bintoken_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    segmented_suite::test();
+    json_suite::test();
+    bintoken_suite::test();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+#include <trial/protocol/core/detail/small_stack.hpp>
+
+using namespace trial::protocol::core::detail;
+
+//-----------------------------------------------------------------------------
+// Stack
+//-----------------------------------------------------------------------------
+
+namespace stack_suite
+{
+
+void test_empty()
+{
+    small_stack<int, 2> data;
+    TRIAL_PROTOCOL_TEST(data.empty());
+    TRIAL_PROTOCOL_TEST_EQUAL(data.size(), 0);
+}
+
+void test_inline()
+{
+    small_stack<int, 2> data;
+    data.push(1);
+    TRIAL_PROTOCOL_TEST_EQUAL(data.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(data.top(), 1);
+    data.push(2);
+    TRIAL_PROTOCOL_TEST_EQUAL(data.size(), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(data.top(), 2);
+    data.pop();
+    TRIAL_PROTOCOL_TEST_EQUAL(data.top(), 1);
+    data.pop();
+    TRIAL_PROTOCOL_TEST(data.empty());
+}
+
+void test_overflow()
+{
+    small_stack<int, 2> data;
+    for (int i = 0; i < 5; ++i)
+    {
+        data.push(i);
+        TRIAL_PROTOCOL_TEST_EQUAL(data.top(), i);
+    }
+    TRIAL_PROTOCOL_TEST_EQUAL(data.size(), 5);
+    for (int i = 4; i >= 0; --i)
+    {
+        TRIAL_PROTOCOL_TEST_EQUAL(data.top(), i);
+        data.pop();
+    }
+    TRIAL_PROTOCOL_TEST(data.empty());
+}
+
+void test_top_assign()
+{
+    small_stack<int, 1> data;
+    data.push(1);
+    data.top() = 10;
+    data.push(2);
+    data.top() = 20;
+    TRIAL_PROTOCOL_TEST_EQUAL(data.top(), 20);
+    data.pop();
+    TRIAL_PROTOCOL_TEST_EQUAL(data.top(), 10);
+}
+
+void test_clear()
+{
+    small_stack<int, 2> data;
+    data.push(1);
+    data.push(2);
+    data.push(3);
+    data.clear();
+    TRIAL_PROTOCOL_TEST(data.empty());
+    data.push(4);
+    TRIAL_PROTOCOL_TEST_EQUAL(data.size(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(data.top(), 4);
+}
+
+void run()
+{
+    test_empty();
+    test_inline();
+    test_overflow();
+    test_top_assign();
+    test_clear();
+}
+
+} // namespace stack_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    stack_suite::run();
+
+    return boost::report_errors();
+}
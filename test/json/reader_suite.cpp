@@ -893,6 +893,104 @@ void run()
 
 } // namespace object_suite
 
+//-----------------------------------------------------------------------------
+// Subtree
+//-----------------------------------------------------------------------------
+
+namespace subtree_suite
+{
+
+void test_scalar()
+{
+    const char input[] = "[ true , \"alpha\" ]";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.subtree_literal(), "true");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::string);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.subtree_literal(), "\"alpha\"");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_array);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), false);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+}
+
+void test_array()
+{
+    const char input[] = "[ 1, [2, [3]], 4 ]";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.subtree_literal(), "[2, [3]]");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::integer);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<int>(), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end_array);
+}
+
+void test_object()
+{
+    const char input[] = "{ \"payload\" : { \"alpha\" : [ {} ] }, \"bravo\" : null }";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "payload");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.subtree_literal(), "{ \"alpha\" : [ {} ] }");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::string);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "bravo");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 1);
+}
+
+void test_outer()
+{
+    const char input[] = " [ 1, {} ] ";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.subtree_literal(), "[ 1, {} ]");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.code(), token::code::end);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.level(), 0);
+}
+
+void fail_end()
+{
+    const char input[] = "[]";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.subtree_literal(),
+                                    json::error,
+                                    "unexpected token");
+}
+
+void fail_missing_end()
+{
+    const char input[] = "[ [ 1 ]";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.subtree_literal(),
+                                    json::error,
+                                    "expected end array bracket");
+}
+
+void fail_mismatched_end()
+{
+    const char input[] = "{ \"alpha\" : 1 ]";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(reader.subtree_literal(),
+                                    json::error,
+                                    "expected end object bracket");
+}
+
+void run()
+{
+    test_scalar();
+    test_array();
+    test_object();
+    test_outer();
+    fail_end();
+    fail_missing_end();
+    fail_mismatched_end();
+}
+
+} // namespace subtree_suite
+
 //-----------------------------------------------------------------------------
 // main
 //-----------------------------------------------------------------------------
@@ -903,6 +1001,7 @@ int main()
     ubasic_suite::run();
     array_suite::run();
     object_suite::run();
+    subtree_suite::run();
 
     return boost::report_errors();
 }
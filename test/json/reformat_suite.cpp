@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2017 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <trial/protocol/buffer/string.hpp>
+#include <trial/protocol/json/reformat.hpp>
+#include <trial/protocol/core/detail/lightweight_test.hpp>
+
+using namespace trial::protocol;
+
+//-----------------------------------------------------------------------------
+// Minify
+//-----------------------------------------------------------------------------
+
+namespace minify_suite
+{
+
+std::string minify(const std::string& input)
+{
+    std::string result;
+    json::reformat(input, result, json::style::minify());
+    return result;
+}
+
+void test_empty()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(minify(""), "");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("  \n"), "");
+}
+
+void test_scalar()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("null"), "null");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify(" true "), "true");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("\t-1.5e3\n"), "-1.5e3");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify(" \"alpha bravo\" "), "\"alpha bravo\"");
+}
+
+void test_string_escape()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("\"a\\\"b\\\\\""), "\"a\\\"b\\\\\"");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("[ \"alpha bravo charlie delta \\\" echo ] , {\" ]"),
+                              "[\"alpha bravo charlie delta \\\" echo ] , {\"]");
+}
+
+void test_array()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("[ ]"), "[]");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("[ 1 , 2 ,3 ]"), "[1,2,3]");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("[ [ ] , [ [ true ] ] ]"), "[[],[[true]]]");
+}
+
+void test_object()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("{ }"), "{}");
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("{ \"alpha\" : 1 , \"bravo\" : [ null ] }"),
+                              "{\"alpha\":1,\"bravo\":[null]}");
+}
+
+void test_long_whitespace()
+{
+    const std::string spaces(100, ' ');
+    TRIAL_PROTOCOL_TEST_EQUAL(minify("[" + spaces + "1,\n\t\r" + spaces + "2" + spaces + "]"), "[1,2]");
+}
+
+void test_counter()
+{
+    std::string result;
+    TRIAL_PROTOCOL_TEST_EQUAL(json::reformat("[ 1 , 2 ]", result), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(result, "[1,2]");
+}
+
+void fail_unbalanced()
+{
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("]"),
+                                    json::error,
+                                    "unbalanced end array bracket");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("{}}"),
+                                    json::error,
+                                    "unbalanced end object bracket");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("[1"),
+                                    json::error,
+                                    "expected end array bracket");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("[1}"),
+                                    json::error,
+                                    "expected end array bracket");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("{\"alpha\":1"),
+                                    json::error,
+                                    "expected end object bracket");
+}
+
+void fail_separator()
+{
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("[1 2]"),
+                                    json::error,
+                                    "unexpected token");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("[1,]"),
+                                    json::error,
+                                    "unexpected token");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("{\"alpha\" 1}"),
+                                    json::error,
+                                    "unexpected token");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("1 2"),
+                                    json::error,
+                                    "unexpected token");
+}
+
+void fail_key()
+{
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("{1:2}"),
+                                    json::error,
+                                    "invalid key");
+}
+
+void fail_value()
+{
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("[x]"),
+                                    json::error,
+                                    "invalid value");
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(minify("\"alpha"),
+                                    json::error,
+                                    "invalid value");
+}
+
+void run()
+{
+    test_empty();
+    test_scalar();
+    test_string_escape();
+    test_array();
+    test_object();
+    test_long_whitespace();
+    test_counter();
+    fail_unbalanced();
+    fail_separator();
+    fail_key();
+    fail_value();
+}
+
+} // namespace minify_suite
+
+//-----------------------------------------------------------------------------
+// Indent
+//-----------------------------------------------------------------------------
+
+namespace indent_suite
+{
+
+std::string indent(const std::string& input)
+{
+    std::string result;
+    json::reformat(input, result, json::style::indent(2));
+    return result;
+}
+
+void test_scalar()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(indent(" 42 "), "42");
+}
+
+void test_array()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(indent("[]"), "[]");
+    TRIAL_PROTOCOL_TEST_EQUAL(indent("[1,2]"), "[\n  1,\n  2\n]");
+    TRIAL_PROTOCOL_TEST_EQUAL(indent("[[1],[]]"), "[\n  [\n    1\n  ],\n  []\n]");
+}
+
+void test_object()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(indent("{}"), "{}");
+    TRIAL_PROTOCOL_TEST_EQUAL(indent("{\"alpha\":1,\"bravo\":{\"charlie\":true}}"),
+                              "{\n  \"alpha\": 1,\n  \"bravo\": {\n    \"charlie\": true\n  }\n}");
+}
+
+void test_reindent()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(indent("[\n    1,\n    [\n        2\n    ]\n]"),
+                              "[\n  1,\n  [\n    2\n  ]\n]");
+}
+
+void run()
+{
+    test_scalar();
+    test_array();
+    test_object();
+    test_reindent();
+}
+
+} // namespace indent_suite
+
+//-----------------------------------------------------------------------------
+// Compact arrays
+//-----------------------------------------------------------------------------
+
+namespace compact_suite
+{
+
+std::string compact(const std::string& input)
+{
+    std::string result;
+    json::reformat(input, result, json::style::compact_arrays(2));
+    return result;
+}
+
+void test_array()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(compact("[]"), "[]");
+    TRIAL_PROTOCOL_TEST_EQUAL(compact("[ 1 ,\n 2 ]"), "[1, 2]");
+    TRIAL_PROTOCOL_TEST_EQUAL(compact("[\"]\", \"[\"]"), "[\"]\", \"[\"]");
+    TRIAL_PROTOCOL_TEST_EQUAL(compact("[[1,2],[]]"), "[\n  [1, 2],\n  []\n]");
+}
+
+void test_object()
+{
+    TRIAL_PROTOCOL_TEST_EQUAL(compact("{\"alpha\":[1,2,3],\"bravo\":[{}]}"),
+                              "{\n  \"alpha\": [1, 2, 3],\n  \"bravo\": [\n    {}\n  ]\n}");
+}
+
+void run()
+{
+    test_array();
+    test_object();
+}
+
+} // namespace compact_suite
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main()
+{
+    minify_suite::run();
+    indent_suite::run();
+    compact_suite::run();
+
+    return boost::report_errors();
+}
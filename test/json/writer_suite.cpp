@@ -10,6 +10,7 @@
 
 #include <sstream>
 #include <trial/protocol/buffer/ostream.hpp>
+#include <trial/protocol/json/reader.hpp>
 #include <trial/protocol/json/writer.hpp>
 #include <trial/protocol/core/detail/lightweight_test.hpp>
 
@@ -377,6 +378,177 @@ void run()
 
 } // namespace object_suite
 
+//-----------------------------------------------------------------------------
+// Pre-encoded keys
+//-----------------------------------------------------------------------------
+
+namespace key_suite
+{
+
+void test_literal()
+{
+    json::key key("alpha");
+    TRIAL_PROTOCOL_TEST_EQUAL(key.literal(), "\"alpha\":");
+}
+
+void test_literal_escaped()
+{
+    json::key key("al\"pha");
+    TRIAL_PROTOCOL_TEST_EQUAL(key.literal(), "\"al\\\"pha\":");
+}
+
+void test_one()
+{
+    static const json::key key1("key1");
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.key(key1), 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(false), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "{\"key1\":false}");
+}
+
+void test_two()
+{
+    static const json::key key1("key1");
+    static const json::key key2("key2");
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.key(key1), 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(false), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.key(key2), 8);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "{\"key1\":false,\"key2\":true}");
+}
+
+void test_mixed()
+{
+    static const json::key key2("key2");
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("key1"), 6);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(false), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.key(key2), 8);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("key3"), 6);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "{\"key1\":false,\"key2\":[],\"key3\":true}");
+}
+
+void fail_outside_object()
+{
+    static const json::key key1("key1");
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.key(key1),
+                                    json::error,
+                                    "invalid key");
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.key(key1),
+                                    json::error,
+                                    "invalid key");
+}
+
+void fail_value_position()
+{
+    static const json::key key1("key1");
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.key(key1), 7);
+    TRIAL_PROTOCOL_TEST_THROW_EQUAL(writer.key(key1),
+                                    json::error,
+                                    "invalid key");
+}
+
+void run()
+{
+    test_literal();
+    test_literal_escaped();
+    test_one();
+    test_two();
+    test_mixed();
+    fail_outside_object();
+    fail_value_position();
+}
+
+} // namespace key_suite
+
+//-----------------------------------------------------------------------------
+// Subtree
+//-----------------------------------------------------------------------------
+
+namespace subtree_suite
+{
+
+void test_outer()
+{
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.subtree_literal("[1,2]"), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "[1,2]");
+}
+
+void test_array()
+{
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.subtree_literal("{\"alpha\":1}"), 11);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.subtree_literal("[]"), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "[{\"alpha\":1},[],true]");
+}
+
+void test_object()
+{
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("payload"), 9);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.subtree_literal("[1,2]"), 5);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value("bravo"), 7);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(true), 4);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_object>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "{\"payload\":[1,2],\"bravo\":true}");
+}
+
+void test_passthrough()
+{
+    const char input[] = "{ \"id\" : 1, \"payload\" : { \"alpha\" : [ 1, 2 ] } }";
+    json::reader reader(input);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.value<std::string>(), "payload");
+    TRIAL_PROTOCOL_TEST_EQUAL(reader.next(), true);
+
+    std::ostringstream result;
+    json::writer writer(result);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::begin_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value(42), 2);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.subtree_literal(reader.subtree_literal()), 22);
+    TRIAL_PROTOCOL_TEST_EQUAL(writer.value<token::end_array>(), 1);
+    TRIAL_PROTOCOL_TEST_EQUAL(result.str(), "[42,{ \"alpha\" : [ 1, 2 ] }]");
+}
+
+void run()
+{
+    test_outer();
+    test_array();
+    test_object();
+    test_passthrough();
+}
+
+} // namespace subtree_suite
+
 //-----------------------------------------------------------------------------
 // main
 //-----------------------------------------------------------------------------
@@ -390,6 +562,8 @@ int main()
     string_suite::run();
     array_suite::run();
     object_suite::run();
+    key_suite::run();
+    subtree_suite::run();
 
     return boost::report_errors();
 }